@@ -0,0 +1,202 @@
+#include "task_wrapper.h"
+#include <grpcpp/grpcpp.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+using namespace orchestrator;
+
+// Measures RPCs per second against tasks per second: one StartTask and one
+// NotifyTaskEnd per task versus StartTasks batches and NotifyTaskEnds
+// coalescing, with an in-process wrapper running an empty task.
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Orchestrator side: counts end notification RPCs and the ends they carry
+class EndCounter final : public OrchestratorService::Service {
+public:
+    grpc::Status NotifyTaskEnd(grpc::ServerContext*, const TaskEndNotification*,
+                               TaskEndResponse* response) override {
+        add(1);
+        response->set_acknowledged(true);
+        return grpc::Status::OK;
+    }
+    
+    grpc::Status NotifyTaskEnds(grpc::ServerContext*, const TaskEndBatch* request,
+                                TaskEndResponse* response) override {
+        add(request->notifications_size());
+        response->set_acknowledged(true);
+        return grpc::Status::OK;
+    }
+    
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ends_ = 0;
+        rpcs_ = 0;
+    }
+    
+    void wait_for(uint64_t ends) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this, ends]() { return ends_ >= ends; });
+    }
+    
+    uint64_t rpcs() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rpcs_;
+    }
+
+private:
+    void add(int ends) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ends_ += ends;
+        rpcs_++;
+        cv_.notify_all();
+    }
+    
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint64_t ends_ = 0;
+    uint64_t rpcs_ = 0;
+};
+
+struct BenchResult {
+    double tasks_per_sec;
+    double rpcs_per_sec;
+    double rpcs_per_task;
+};
+
+static BenchResult run_config(size_t tasks, size_t batch, int64_t window_us, int port,
+                              const std::string& orchestrator_address, EndCounter& counter) {
+    std::string address = "localhost:" + std::to_string(port);
+    
+    // The wrapper logs every execution; keep the output out of the measurement
+    std::streambuf* saved_cout = std::cout.rdbuf(nullptr);
+    
+    TaskWrapper wrapper("bench", address, orchestrator_address,
+                        [](const TaskParameterView&) { return TASK_RESULT_SUCCESS; });
+    wrapper.set_zero_allocation_mode(true);
+    if (window_us > 0) {
+        wrapper.set_notify_coalescing_window(window_us);
+    }
+    wrapper.start();
+    
+    auto stub = TaskService::NewStub(grpc::CreateChannel(address, grpc::InsecureChannelCredentials()));
+    StartTaskRequest start;
+    start.set_task_id("bench");
+    StartTasksRequest batch_request;
+    StartTasksResponse batch_response;
+    StartTaskResponse response;
+    
+    counter.reset();
+    uint64_t start_rpcs = 0;
+    size_t sent = 0;
+    int64_t begin = now_ns();
+    while (sent < tasks) {
+        size_t count = std::min(batch, tasks - sent);
+        bool accepted;
+        grpc::ClientContext context;
+        if (batch == 1) {
+            grpc::Status status = stub->StartTask(&context, start, &response);
+            accepted = status.ok() && response.success();
+        } else {
+            batch_request.clear_starts();
+            for (size_t i = 0; i < count; i++) {
+                *batch_request.add_starts() = start;
+            }
+            grpc::Status status = stub->StartTasks(&context, batch_request, &batch_response);
+            accepted = status.ok() && batch_response.responses_size() > 0 &&
+                       batch_response.responses(0).success();
+        }
+        start_rpcs++;
+        
+        // Rejected while the previous batch finished its end notification: retry
+        if (!accepted) {
+            continue;
+        }
+        sent += count;
+        counter.wait_for(sent);
+    }
+    int64_t elapsed_ns = now_ns() - begin;
+    
+    wrapper.stop();
+    std::cout.rdbuf(saved_cout);
+    std::cout.clear();
+    
+    double seconds = static_cast<double>(elapsed_ns) / 1e9;
+    uint64_t rpcs = start_rpcs + counter.rpcs();
+    return {tasks / seconds, rpcs / seconds, static_cast<double>(rpcs) / tasks};
+}
+
+int main(int argc, char** argv) {
+    size_t tasks = 2000;
+    size_t batch = 16;
+    int64_t window_us = 500;
+    int port = 50170;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--tasks" && i + 1 < argc) {
+            tasks = std::stoul(argv[++i]);
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch = std::max<size_t>(std::stoul(argv[++i]), 2);
+        } else if (arg == "--window-us" && i + 1 < argc) {
+            window_us = std::stoll(argv[++i]);
+        } else if (arg == "--port" && i + 1 < argc) {
+            port = std::stoi(argv[++i]);
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0]
+                      << " [--tasks N] [--batch N] [--window-us US] [--port P]" << std::endl;
+            return 0;
+        }
+    }
+    
+    // In-process orchestrator endpoint receiving the end notifications
+    std::string orchestrator_address = "localhost:" + std::to_string(port);
+    EndCounter counter;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(orchestrator_address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&counter);
+    std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+    if (!server) {
+        std::cerr << "Failed to listen on " << orchestrator_address << std::endl;
+        return 1;
+    }
+    
+    std::cout << "=== Batched RPC benchmark ===" << std::endl;
+    std::cout << "Tasks: " << tasks << ", batch: " << batch
+              << ", coalescing window: " << window_us << " us" << std::endl;
+    
+    struct Config {
+        const char* name;
+        size_t batch;
+        int64_t window_us;
+    };
+    const Config configs[] = {
+        {"StartTask + NotifyTaskEnd", 1, 0},
+        {"StartTasks + NotifyTaskEnd", batch, 0},
+        {"StartTasks + NotifyTaskEnds", batch, window_us},
+    };
+    
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(30) << "Mode" << std::right << std::setw(12) << "tasks/s"
+              << std::setw(12) << "RPCs/s" << std::setw(12) << "RPCs/task" << std::endl;
+    int wrapper_port = port + 1;
+    for (const Config& config : configs) {
+        BenchResult result = run_config(tasks, config.batch, config.window_us, wrapper_port++,
+                                        orchestrator_address, counter);
+        std::cout << std::left << std::setw(30) << config.name << std::right
+                  << std::setw(12) << result.tasks_per_sec
+                  << std::setw(12) << result.rpcs_per_sec
+                  << std::setw(12) << std::setprecision(2) << result.rpcs_per_task
+                  << std::setprecision(1) << std::endl;
+    }
+    
+    server->Shutdown();
+    return 0;
+}
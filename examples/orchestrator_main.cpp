@@ -1,8 +1,13 @@
 #include "orchestrator.h"
 #include "schedule.h"
+#include "schedule_simulator.h"
 #include "rt_utils.h"
+#include "alloc_counter.h"
 #include <iostream>
+#include <iomanip>
 #include <signal.h>
+#include <pthread.h>
+#include <thread>
 #include <cstring>
 
 using namespace orchestrator;
@@ -10,38 +15,236 @@ using namespace orchestrator;
 // Global orchestrator pointer for signal handling
 Orchestrator* g_orchestrator = nullptr;
 
-void signal_handler(int signal) {
+// Signals are handled on a dedicated thread: stop() joins threads and wakes
+// condition variables, which is not safe inside an asynchronous handler
+void signal_thread(sigset_t signals) {
+    int signal = 0;
+    sigwait(&signals, &signal);
+    
     std::cout << "\n[Main] Received signal " << signal << ", shutting down..." << std::endl;
     if (g_orchestrator) {
+        // main() returns once wait_for_completion() is woken up
         g_orchestrator->stop();
+    } else {
+        exit(0);
     }
-    exit(0);
 }
 
 void print_usage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [OPTIONS]" << std::endl;
     std::cout << "\nOptions:" << std::endl;
-    std::cout << "  --address <addr>        Listen address (default: 0.0.0.0:50050)" << std::endl;
-    std::cout << "  --schedule <file>       Schedule file path (YAML)" << std::endl;
+    std::cout << "  --address <addr>        Listen address, host:port or unix:<path> (default: 0.0.0.0:50050)" << std::endl;
+    std::cout << "  --uds <path>            Also listen on a Unix domain socket" << std::endl;
+    std::cout << "  --schedule <file>       Schedule file path (YAML, or JSON for *.json)" << std::endl;
     std::cout << "  --policy <policy>       RT scheduling policy: none, fifo, rr (default: none)" << std::endl;
     std::cout << "  --priority <n>          RT priority: 1-99 (default: 50)" << std::endl;
-    std::cout << "  --cpu-affinity <n>      Bind to CPU core (default: -1, no affinity)" << std::endl;
+    std::cout << "  --cpu-affinity <cpus>   Bind to a CPU core or a CPU list, e.g. 2-5,8 (default: none)" << std::endl;
+    std::cout << "  --numa <policy>         Memory on the NUMA nodes of the bound CPUs:" << std::endl;
+    std::cout << "                          none, preferred, bind (default: none)" << std::endl;
     std::cout << "  --lock-memory           Lock memory pages (prevents page faults)" << std::endl;
+    std::cout << "  --rt-heap <MB>          Tune malloc and pre-touch this much heap at startup" << std::endl;
+    std::cout << "  --huge-pages <mode>     Backing of the reserved memory: none, thp, explicit" << std::endl;
+    std::cout << "  --grpc-pollers <n>      gRPC server polling threads (default: gRPC's)" << std::endl;
+    std::cout << "  --grpc-max-threads <n>  Cap on gRPC server threads (default: none)" << std::endl;
+    std::cout << "  --grpc-policy <policy>  RT policy of the gRPC handler threads (default: none)" << std::endl;
+    std::cout << "  --grpc-priority <n>     RT priority of the gRPC handler threads (default: 49)" << std::endl;
+    std::cout << "  --housekeeping-cpus <m> CPU mask for gRPC's internal threads, e.g. 0x1" << std::endl;
+    std::cout << "  --history <n>           Recent executions kept in memory (default: 4096)" << std::endl;
+    std::cout << "  --trace <file>          Write every execution to a binary trace file" << std::endl;
+    std::cout << "  --timeline <file>       Write a Chrome Trace / Perfetto JSON timeline of the run" << std::endl;
+    std::cout << "  --dispatch-order <o>    Order of released tasks: fifo, priority, edf (default: priority)" << std::endl;
+    std::cout << "  --max-inflight <n>      Maximum concurrent StartTask RPCs (default: 8)" << std::endl;
+    std::cout << "  --no-critical-path      Do not break dispatch ties by longest path to a sink" << std::endl;
+    std::cout << "  --duration-stats <file> Learn execution times across runs in this file" << std::endl;
+    std::cout << "  --budget-margin <f>     Warn about executions over f * learned WCET (default: 1.2)" << std::endl;
+    std::cout << "  --result-cache <dir>    Reuse results of cacheable tasks whose parameters and" << std::endl;
+    std::cout << "                          dependency outputs are unchanged" << std::endl;
+    std::cout << "  --start-batch <n>       Start up to n queued tasks of one wrapper per RPC" << std::endl;
+    std::cout << "                          (default: 1 = no batching)" << std::endl;
+    std::cout << "  --prearm-ms <ms>        Arm TIMED tasks on their wrapper this long before" << std::endl;
+    std::cout << "                          their release (default: 0 = start on time)" << std::endl;
+    std::cout << "  --heartbeat-ms <ms>     Heartbeat interval for wrapper failure detection" << std::endl;
+    std::cout << "                          (default: 0 = disabled)" << std::endl;
+    std::cout << "  --heartbeat-misses <n>  Missed beats before a wrapper is declared down (default: 3)" << std::endl;
+    std::cout << "  --ready-timeout-ms <ms> Wait this long for the wrappers before t=0 (default: 5000)" << std::endl;
+    std::cout << "  --simulate              Dry run: simulate the schedule on a virtual clock" << std::endl;
+    std::cout << "                          (no wrappers; uses estimated_duration_us, or the" << std::endl;
+    std::cout << "                          learned times of --duration-stats)" << std::endl;
+    std::cout << "  --sim-durations <m>     Simulated durations: fixed, uniform, normal, learned" << std::endl;
+    std::cout << "                          (default: fixed)" << std::endl;
+    std::cout << "  --sim-spread <f>        Relative spread of uniform/normal durations (default: 0.1)" << std::endl;
+    std::cout << "  --sim-seed <n>          Seed of the simulated durations (default: 1)" << std::endl;
+    std::cout << "  --sim-start-us <us>     Simulated StartTask round trip (default: 0)" << std::endl;
+    std::cout << "  --sim-end-us <us>       Simulated end notification latency (default: 0)" << std::endl;
     std::cout << "  --help                  Show this help message" << std::endl;
 }
 
+TaskSchedule load_schedule(const std::string& schedule_file) {
+    if (!schedule_file.empty()) {
+        // Load from file
+        std::cout << "[Main] Loading schedule from: " << schedule_file << std::endl;
+        return ScheduleParser::parse_file(schedule_file);
+    }
+    // Use test schedule
+    std::cout << "[Main] Using test schedule" << std::endl;
+    return ScheduleParser::create_test_schedule();
+}
+
+// Print every execution and the success/failure counts
+void print_execution_summary(const std::vector<TaskExecution>& history, uint64_t execution_count) {
+    std::cout << "\n=== Execution Summary ===" << std::endl;
+    
+    int success_count = 0;
+    int failure_count = 0;
+    
+    for (const auto& exec : history) {
+        std::cout << "Task: " << exec.task_id << std::endl;
+        std::cout << "  Scheduled: " << exec.scheduled_time_us << " us" << std::endl;
+        std::cout << "  Started: " << exec.actual_start_time_us << " us" << std::endl;
+        std::cout << "  Ended: " << exec.end_time_us << " us" << std::endl;
+        std::cout << "  Duration: " << (exec.end_time_us - exec.actual_start_time_us) << " us" << std::endl;
+        std::cout << "  Result: " << exec.result << std::endl;
+        
+        if (exec.result == TASK_RESULT_SUCCESS) {
+            success_count++;
+        } else {
+            failure_count++;
+            if (!exec.error_message.empty()) {
+                std::cout << "  Error: " << exec.error_message << std::endl;
+            }
+        }
+        std::cout << std::endl;
+    }
+    
+    std::cout << "Total tasks: " << history.size() << std::endl;
+    if (execution_count > history.size()) {
+        std::cout << "  (last " << history.size() << " of "
+                  << execution_count << " executions)" << std::endl;
+    }
+    std::cout << "Successful: " << success_count << std::endl;
+    std::cout << "Failed: " << failure_count << std::endl;
+}
+
+// Print the dependency chain that ended last
+static constexpr size_t MAX_LISTED_STEPS = 20;
+
+void print_critical_path(const std::vector<CriticalPathStep>& steps) {
+    if (steps.empty()) {
+        return;
+    }
+    std::cout << "\n=== Critical Path (" << (steps.back().end_us - steps.front().start_us) / 1000.0
+              << " ms, " << steps.size() << " tasks) ===" << std::endl;
+    for (size_t i = 0; i < steps.size(); i++) {
+        // Long chains: the first steps and the last one
+        if (i == MAX_LISTED_STEPS && steps.size() > MAX_LISTED_STEPS + 1) {
+            std::cout << "  ... " << steps.size() - MAX_LISTED_STEPS - 1 << " more" << std::endl;
+            i = steps.size() - 1;
+        }
+        const CriticalPathStep& step = steps[i];
+        std::cout << "  " << step.task_id << ": " << step.start_us << " → " << step.end_us << " us ("
+                  << (step.end_us - step.start_us) / 1000.0 << " ms";
+        if (step.wait_us > 0) {
+            std::cout << ", started " << step.wait_us / 1000.0 << " ms after its dependency";
+        }
+        std::cout << ")" << std::endl;
+    }
+}
+
+// Learned execution times against the declared estimates
+void print_duration_report(const std::vector<TaskDurationReport>& report) {
+    if (report.empty()) {
+        return;
+    }
+    std::cout << "\n=== Execution Times (ms: EWMA, p50/p99 of the last "
+              << TaskDurationStats::RECENT_SAMPLES << ", WCET) ===" << std::endl;
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::cout << std::fixed << std::setprecision(3);
+    for (const TaskDurationReport& task : report) {
+        const TaskDurationStats& stats = task.stats;
+        std::cout << "  " << task.task_id << ": n=" << stats.executions
+                  << " ewma=" << stats.ewma_us / 1000.0
+                  << " p50=" << stats.percentile(50) / 1000.0
+                  << " p99=" << stats.percentile(99) / 1000.0
+                  << " wcet=" << stats.wcet_us / 1000.0
+                  << " declared=" << task.declared_us / 1000.0 << (task.declared ? "" : " (default)");
+        if (task.overruns > 0) {
+            std::cout << " overruns=" << task.overruns;
+        }
+        if (task.misestimated) {
+            std::cout << "  <- estimate off by more than " << std::defaultfloat
+                      << TaskDurationReport::MISESTIMATE_FACTOR << std::fixed << "x";
+        }
+        std::cout << std::endl;
+    }
+    std::cout.flags(flags);
+}
+
+// Dry run of the schedule with the orchestrator's dispatch settings
+int run_simulation(ScheduleSimulator& simulator, const std::string& timeline_file) {
+    bool finished = simulator.run();
+    print_execution_summary(simulator.get_execution_history(), simulator.get_execution_count());
+    print_critical_path(simulator.get_critical_path());
+    
+    const SimulationReport& report = simulator.report();
+    std::cout << "\n=== Simulation Report ===" << std::endl;
+    std::cout << "Makespan: " << report.makespan_us << " us" << std::endl;
+    std::cout << "Start lateness: mean " << report.lateness_mean_us << " us, p50 " << report.lateness_p50_us
+              << " us, p99 " << report.lateness_p99_us << " us, max " << report.lateness_max_us << " us" << std::endl;
+    std::cout << "Deadline misses: " << report.deadline_misses << " of " << report.completed << std::endl;
+    for (size_t i = 0; i < report.missed_tasks.size() && i < 10; i++) {
+        std::cout << "  " << report.missed_tasks[i] << std::endl;
+    }
+    if (report.missed_tasks.size() > 10) {
+        std::cout << "  ... and " << report.missed_tasks.size() - 10 << " more" << std::endl;
+    }
+    if (!report.stalled_tasks.empty()) {
+        std::cout << "Stalled SEQUENTIAL tasks: " << report.stalled_tasks.size()
+                  << " (first: " << report.stalled_tasks.front() << ")" << std::endl;
+    }
+    
+    if (!timeline_file.empty()) {
+        simulator.export_timeline(timeline_file);
+    }
+    return finished ? 0 : 1;
+}
+
 int main(int argc, char** argv) {
     std::cout << "=== gRPC Orchestrator ===" << std::endl;
     std::cout << "Starting orchestrator service..." << std::endl;
     
-    // Setup signal handlers
-    signal(SIGINT, signal_handler);
-    signal(SIGTERM, signal_handler);
+    // Setup signal handling (blocked before any other thread is created)
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::thread(signal_thread, signals).detach();
     
     // Parse command line arguments
     std::string listen_address = "0.0.0.0:50050";
     std::string schedule_file;
     RTConfig rt_config;
+    size_t history_capacity = ExecutionHistory::DEFAULT_CAPACITY;
+    std::string trace_file;
+    std::string timeline_file;
+    DispatchOrder dispatch_order = DISPATCH_ORDER_PRIORITY;
+    size_t max_inflight = 8;
+    bool critical_path = true;
+    std::string duration_stats_file;
+    double budget_margin = 1.2;
+    std::string result_cache_dir;
+    double prearm_ms = 0;
+    size_t start_batch = 1;
+    std::string uds_path;
+    double heartbeat_ms = 0;
+    int heartbeat_misses = LivenessMonitor::DEFAULT_MISSED_BEATS;
+    double ready_timeout_ms = 5000;
+    bool simulate = false;
+    DurationModel sim_durations = DURATION_MODEL_FIXED;
+    double sim_spread = 0.1;
+    uint64_t sim_seed = 1;
+    int64_t sim_start_us = 0;
+    int64_t sim_end_us = 0;
     
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -51,6 +254,8 @@ int main(int argc, char** argv) {
             return 0;
         } else if (arg == "--address" && i + 1 < argc) {
             listen_address = argv[++i];
+        } else if (arg == "--uds" && i + 1 < argc) {
+            uds_path = argv[++i];
         } else if (arg == "--schedule" && i + 1 < argc) {
             schedule_file = argv[++i];
         } else if (arg == "--policy" && i + 1 < argc) {
@@ -58,10 +263,72 @@ int main(int argc, char** argv) {
         } else if (arg == "--priority" && i + 1 < argc) {
             rt_config.priority = std::stoi(argv[++i]);
         } else if (arg == "--cpu-affinity" && i + 1 < argc) {
-            rt_config.cpu_affinity = std::stoi(argv[++i]);
+            std::string cpus = argv[++i];
+            if (RTUtils::is_cpu_list(cpus)) {
+                rt_config.cpu_list = cpus;
+            } else {
+                rt_config.cpu_affinity = std::stoi(cpus);
+            }
+        } else if (arg == "--numa" && i + 1 < argc) {
+            rt_config.numa_policy = RTUtils::string_to_numa_policy(argv[++i]);
         } else if (arg == "--lock-memory") {
             rt_config.lock_memory = true;
             rt_config.prefault_stack = true;
+        } else if (arg == "--rt-heap" && i + 1 < argc) {
+            rt_config.tune_malloc = true;
+            rt_config.heap_reserve_bytes = std::stoull(argv[++i]) * 1024 * 1024;
+        } else if (arg == "--huge-pages" && i + 1 < argc) {
+            rt_config.huge_pages = RTUtils::string_to_huge_pages(argv[++i]);
+        } else if (arg == "--grpc-pollers" && i + 1 < argc) {
+            rt_config.grpc_pollers = std::stoi(argv[++i]);
+        } else if (arg == "--grpc-max-threads" && i + 1 < argc) {
+            rt_config.grpc_max_threads = std::stoi(argv[++i]);
+        } else if (arg == "--grpc-policy" && i + 1 < argc) {
+            rt_config.grpc_policy = RTUtils::string_to_policy(argv[++i]);
+        } else if (arg == "--grpc-priority" && i + 1 < argc) {
+            rt_config.grpc_priority = std::stoi(argv[++i]);
+        } else if (arg == "--housekeeping-cpus" && i + 1 < argc) {
+            rt_config.housekeeping_cpu_mask = RTUtils::string_to_cpu_mask(argv[++i]);
+        } else if (arg == "--history" && i + 1 < argc) {
+            history_capacity = std::stoul(argv[++i]);
+        } else if (arg == "--trace" && i + 1 < argc) {
+            trace_file = argv[++i];
+        } else if (arg == "--timeline" && i + 1 < argc) {
+            timeline_file = argv[++i];
+        } else if (arg == "--dispatch-order" && i + 1 < argc) {
+            dispatch_order = ReleaseQueue::string_to_order(argv[++i]);
+        } else if (arg == "--max-inflight" && i + 1 < argc) {
+            max_inflight = std::stoul(argv[++i]);
+        } else if (arg == "--no-critical-path") {
+            critical_path = false;
+        } else if (arg == "--duration-stats" && i + 1 < argc) {
+            duration_stats_file = argv[++i];
+        } else if (arg == "--budget-margin" && i + 1 < argc) {
+            budget_margin = std::stod(argv[++i]);
+        } else if (arg == "--result-cache" && i + 1 < argc) {
+            result_cache_dir = argv[++i];
+        } else if (arg == "--start-batch" && i + 1 < argc) {
+            start_batch = std::stoul(argv[++i]);
+        } else if (arg == "--prearm-ms" && i + 1 < argc) {
+            prearm_ms = std::stod(argv[++i]);
+        } else if (arg == "--heartbeat-ms" && i + 1 < argc) {
+            heartbeat_ms = std::stod(argv[++i]);
+        } else if (arg == "--heartbeat-misses" && i + 1 < argc) {
+            heartbeat_misses = std::stoi(argv[++i]);
+        } else if (arg == "--ready-timeout-ms" && i + 1 < argc) {
+            ready_timeout_ms = std::stod(argv[++i]);
+        } else if (arg == "--simulate") {
+            simulate = true;
+        } else if (arg == "--sim-durations" && i + 1 < argc) {
+            sim_durations = ScheduleSimulator::string_to_duration_model(argv[++i]);
+        } else if (arg == "--sim-spread" && i + 1 < argc) {
+            sim_spread = std::stod(argv[++i]);
+        } else if (arg == "--sim-seed" && i + 1 < argc) {
+            sim_seed = std::stoull(argv[++i]);
+        } else if (arg == "--sim-start-us" && i + 1 < argc) {
+            sim_start_us = std::stoll(argv[++i]);
+        } else if (arg == "--sim-end-us" && i + 1 < argc) {
+            sim_end_us = std::stoll(argv[++i]);
         } else if (i == 1 && arg[0] != '-') {
             // Backward compatibility: first positional arg is address
             listen_address = arg;
@@ -71,11 +338,59 @@ int main(int argc, char** argv) {
         }
     }
     
+    // Dry run: no server, no wrappers, no real-time configuration
+    if (simulate) {
+        ScheduleSimulator simulator;
+        simulator.set_history_capacity(history_capacity);
+        simulator.set_dispatch_order(dispatch_order);
+        simulator.set_max_inflight_dispatches(max_inflight);
+        simulator.set_critical_path_priority(critical_path);
+        simulator.set_duration_model(sim_durations, sim_spread);
+        simulator.set_seed(sim_seed);
+        simulator.set_rpc_latency(sim_start_us, sim_end_us);
+        if (!trace_file.empty()) {
+            simulator.set_trace_file(trace_file);
+        }
+        // Read only: a dry run does not teach the store anything
+        DurationStore durations;
+        if (!duration_stats_file.empty() && durations.load(duration_stats_file)) {
+            simulator.set_duration_store(&durations);
+        }
+        simulator.load_schedule(load_schedule(schedule_file));
+        return run_simulation(simulator, timeline_file);
+    }
+    
+    // malloc settings only reach arenas created afterwards: apply them before
+    // gRPC starts its threads
+    RTUtils::apply_memory_profile(rt_config);
+    
     Orchestrator orchestrator(listen_address);
     g_orchestrator = &orchestrator;
     
+    orchestrator.set_history_capacity(history_capacity);
+    orchestrator.set_dispatch_order(dispatch_order);
+    orchestrator.set_max_inflight_dispatches(max_inflight);
+    orchestrator.set_critical_path_priority(critical_path);
+    orchestrator.set_start_batching(start_batch);
+    orchestrator.set_prearm_lead(static_cast<int64_t>(prearm_ms * 1000));
+    if (!uds_path.empty()) {
+        orchestrator.set_uds_path(uds_path);
+    }
+    orchestrator.set_heartbeat(static_cast<int64_t>(heartbeat_ms * 1000), heartbeat_misses);
+    orchestrator.set_ready_timeout(static_cast<int64_t>(ready_timeout_ms * 1000));
+    if (!trace_file.empty()) {
+        orchestrator.set_trace_file(trace_file);
+    }
+    if (!duration_stats_file.empty()) {
+        orchestrator.set_duration_store(duration_stats_file, budget_margin);
+    }
+    if (!result_cache_dir.empty() && !orchestrator.set_result_cache(result_cache_dir)) {
+        return 1;
+    }
+    
     // Set real-time configuration
-    if (rt_config.policy != RT_POLICY_NONE) {
+    if (rt_config.policy != RT_POLICY_NONE || rt_config.configures_grpc() ||
+        rt_config.numa_policy != NUMA_POLICY_NONE || rt_config.configures_memory()) {
         std::cout << "[Main] Configuring real-time scheduling" << std::endl;
         orchestrator.set_rt_config(rt_config);
     } else {
@@ -83,22 +398,13 @@ int main(int argc, char** argv) {
     }
     
     // Load schedule
-    TaskSchedule schedule;
-    
-    if (!schedule_file.empty()) {
-        // Load from file
-        std::cout << "[Main] Loading schedule from: " << schedule_file << std::endl;
-        schedule = ScheduleParser::parse_yaml(schedule_file);
-    } else {
-        // Use test schedule
-        std::cout << "[Main] Using test schedule" << std::endl;
-        schedule = ScheduleParser::create_test_schedule();
-    }
-    
-    orchestrator.load_schedule(schedule);
+    orchestrator.load_schedule(load_schedule(schedule_file));
     
     // Start orchestrator
-    orchestrator.start();
+    if (!orchestrator.start()) {
+        std::cerr << "[Main] Failed to start orchestrator" << std::endl;
+        return 1;
+    }
     
     std::cout << "[Main] Orchestrator started, waiting for tasks to complete..." << std::endl;
     std::cout << "[Main] Press Ctrl+C to stop" << std::endl;
@@ -107,34 +413,39 @@ int main(int argc, char** argv) {
     orchestrator.wait_for_completion();
     
     // Print execution summary
-    std::cout << "\n=== Execution Summary ===" << std::endl;
-    auto history = orchestrator.get_execution_history();
+    print_execution_summary(orchestrator.get_execution_history(), orchestrator.get_execution_count());
+    print_critical_path(orchestrator.get_critical_path());
+    print_duration_report(orchestrator.get_duration_report());
     
-    int success_count = 0;
-    int failure_count = 0;
-    
-    for (const auto& exec : history) {
-        std::cout << "Task: " << exec.task_id << std::endl;
-        std::cout << "  Scheduled: " << exec.scheduled_time_us << " us" << std::endl;
-        std::cout << "  Started: " << exec.actual_start_time_us << " us" << std::endl;
-        std::cout << "  Ended: " << exec.end_time_us << " us" << std::endl;
-        std::cout << "  Duration: " << (exec.end_time_us - exec.actual_start_time_us) << " us" << std::endl;
-        std::cout << "  Result: " << exec.result << std::endl;
-        
-        if (exec.result == TASK_RESULT_SUCCESS) {
-            success_count++;
-        } else {
-            failure_count++;
-            if (!exec.error_message.empty()) {
-                std::cout << "  Error: " << exec.error_message << std::endl;
+    // perf counters per task id (wrappers started with --perf)
+    auto perf_stats = orchestrator.get_perf_stats();
+    if (!perf_stats.empty()) {
+        std::cout << "\n=== Perf Counters (mean [min..max] per execution) ===" << std::endl;
+        std::ios_base::fmtflags flags = std::cout.flags();
+        for (const auto& task : perf_stats) {
+            std::cout << "Task: " << task.task_id << " (" << task.executions << " executions)" << std::endl;
+            for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+                const PerfCounterStats& counter = task.counters[i];
+                if (counter.samples == 0) {
+                    continue;
+                }
+                std::cout << "  " << std::left << std::setw(22) << PerfCounters::metric_name(static_cast<PerfCounter>(i)) + 5
+                          << std::right << std::fixed << std::setprecision(1) << counter.mean()
+                          << " [" << counter.min << ".." << counter.max << "]" << std::endl;
             }
         }
+        std::cout.flags(flags);
         std::cout << std::endl;
     }
     
-    std::cout << "Total tasks: " << history.size() << std::endl;
-    std::cout << "Successful: " << success_count << std::endl;
-    std::cout << "Failed: " << failure_count << std::endl;
+    if (AllocCounter::enabled()) {
+        std::cout << "Dispatch-path allocations: " << orchestrator.get_dispatch_allocations()
+                  << " (" << orchestrator.get_dispatch_count() << " dispatches)" << std::endl;
+    }
+    
+    if (!timeline_file.empty()) {
+        orchestrator.export_timeline(timeline_file);
+    }
     
     // Stop orchestrator
     orchestrator.stop();
@@ -0,0 +1,490 @@
+#include "rt_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+
+using namespace orchestrator;
+
+// cyclictest-style wakeup latency benchmark.
+// N measurement threads sleep until absolute deadlines (clock_nanosleep,
+// CLOCK_MONOTONIC, TIMER_ABSTIME) every interval and record how late they
+// woke up, in 1 us histogram buckets per core the wakeup ran on. Threads are
+// configured with RTUtils::apply_rt_config from the same flags as task_main,
+// so a host or container can be qualified with the settings a schedule will
+// use. Results go to stdout, optionally to JSON and a gnuplot data file.
+
+// Set by SIGINT / SIGTERM: threads stop at their next wakeup and results are still reported
+static std::atomic<bool> g_stop(false);
+
+static void signal_handler(int) {
+    g_stop = true;
+}
+
+static int64_t timespec_ns(const struct timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+static struct timespec ns_timespec(int64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = ns / 1000000000LL;
+    ts.tv_nsec = ns % 1000000000LL;
+    return ts;
+}
+
+// Wakeup latencies of one core (1 us buckets, exact min / max / sum)
+struct Histogram {
+    std::vector<uint64_t> buckets;
+    uint64_t samples = 0;
+    uint64_t overflows = 0;   // Latencies beyond the last bucket
+    int64_t min_ns = 0;
+    int64_t max_ns = 0;
+    int64_t sum_ns = 0;
+    
+    explicit Histogram(size_t bucket_count) : buckets(bucket_count, 0) {}
+    
+    void add(int64_t latency_ns) {
+        size_t bucket = static_cast<size_t>(latency_ns / 1000);
+        if (bucket < buckets.size()) {
+            buckets[bucket]++;
+        } else {
+            overflows++;
+        }
+        min_ns = samples == 0 || latency_ns < min_ns ? latency_ns : min_ns;
+        max_ns = samples == 0 || latency_ns > max_ns ? latency_ns : max_ns;
+        sum_ns += latency_ns;
+        samples++;
+    }
+    
+    void merge(const Histogram& other) {
+        if (other.samples == 0) {
+            return;
+        }
+        for (size_t i = 0; i < buckets.size(); i++) {
+            buckets[i] += other.buckets[i];
+        }
+        min_ns = samples == 0 || other.min_ns < min_ns ? other.min_ns : min_ns;
+        max_ns = samples == 0 || other.max_ns > max_ns ? other.max_ns : max_ns;
+        overflows += other.overflows;
+        sum_ns += other.sum_ns;
+        samples += other.samples;
+    }
+    
+    double avg_us() const { return samples > 0 ? sum_ns / 1000.0 / samples : 0.0; }
+    
+    // Upper bound of the bucket holding the p-th percentile (max when in the overflow)
+    double percentile_us(double p) const {
+        uint64_t rank = static_cast<uint64_t>(p * samples);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); i++) {
+            seen += buckets[i];
+            if (seen > rank) {
+                return std::min<double>(i + 1, max_ns / 1000.0);
+            }
+        }
+        return max_ns / 1000.0;
+    }
+};
+
+struct MeasurementThread {
+    int id = 0;
+    int cpu = -1;                 // Pinned CPU (-1 = any)
+    int64_t interval_ns = 0;
+    std::vector<std::unique_ptr<Histogram>> cores;  // Indexed by core, created on first wakeup
+    uint64_t missed_periods = 0;  // Deadlines skipped because a wakeup overran them
+    bool configured = true;
+    std::thread thread;
+};
+
+static void measure(MeasurementThread& m, const RTConfig& config, size_t bucket_count,
+                    uint64_t loops, int64_t end_ns) {
+    // Own copy of the configuration, pinned to this thread's CPU
+    RTConfig thread_config = config;
+    thread_config.lock_memory = false;   // Done once by main()
+    if (m.cpu >= 0) {
+        thread_config.cpu_list = std::to_string(m.cpu);
+        thread_config.cpu_affinity = -1;
+    }
+    m.configured = RTUtils::apply_rt_config(thread_config);
+    
+    // The home core's histogram is allocated before the first wakeup
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && static_cast<size_t>(cpu) < m.cores.size()) {
+        m.cores[cpu] = std::make_unique<Histogram>(bucket_count);
+    }
+    
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t next_ns = timespec_ns(now) + m.interval_ns;
+    
+    for (uint64_t loop = 0; (loops == 0 || loop < loops) && !g_stop.load(std::memory_order_relaxed); loop++) {
+        struct timespec deadline = ns_timespec(next_ns);
+        int ret;
+        while ((ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr)) == EINTR) {
+        }
+        if (ret != 0) {
+            std::cerr << "[Bench] clock_nanosleep failed: " << strerror(ret) << std::endl;
+            break;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t wakeup_ns = timespec_ns(now);
+        
+        cpu = sched_getcpu();
+        if (cpu >= 0 && static_cast<size_t>(cpu) < m.cores.size()) {
+            if (!m.cores[cpu]) {
+                m.cores[cpu] = std::make_unique<Histogram>(bucket_count);
+            }
+            m.cores[cpu]->add(wakeup_ns - next_ns);
+        }
+        
+        // Next absolute deadline; periods already over are skipped, not queued
+        next_ns += m.interval_ns;
+        while (next_ns <= wakeup_ns) {
+            next_ns += m.interval_ns;
+            m.missed_periods++;
+        }
+        if (end_ns > 0 && wakeup_ns >= end_ns) {
+            break;
+        }
+    }
+}
+
+static void print_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [OPTIONS]" << std::endl;
+    std::cout << "\nMeasurement Options:" << std::endl;
+    std::cout << "  --threads <n>           Measurement threads (default: one per CPU of" << std::endl;
+    std::cout << "                          --cpu-affinity, else 1)" << std::endl;
+    std::cout << "  --interval-us <us>      Wakeup period of the first thread (default: 1000)" << std::endl;
+    std::cout << "  --distance-us <us>      Period increment of each further thread (default: 500)" << std::endl;
+    std::cout << "  --duration-s <s>        Measurement time (default: 10)" << std::endl;
+    std::cout << "  --loops <n>             Wakeups per thread instead of a duration" << std::endl;
+    std::cout << "  --histogram-us <us>     Histogram range in 1 us buckets (default: 1000)" << std::endl;
+    std::cout << "  --json <file>           Write the results as JSON" << std::endl;
+    std::cout << "  --histogram-file <file> Write per-core histograms as gnuplot data" << std::endl;
+    std::cout << "\nReal-Time Options (as task_main):" << std::endl;
+    std::cout << "  --policy <policy>       RT scheduling policy: none, fifo, rr (default: none)" << std::endl;
+    std::cout << "  --priority <n>          RT priority: 1-99 (default: 50)" << std::endl;
+    std::cout << "  --cpu-affinity <cpus>   CPU core or CPU list, e.g. 2-5,8; thread i is pinned" << std::endl;
+    std::cout << "                          to the i-th CPU of the list (default: unpinned)" << std::endl;
+    std::cout << "  --numa <policy>         Memory on the NUMA nodes of the bound CPUs:" << std::endl;
+    std::cout << "                          none, preferred, bind (default: none)" << std::endl;
+    std::cout << "  --lock-memory           Lock memory pages (prevents page faults)" << std::endl;
+    std::cout << "  --rt-heap <MB>          Tune malloc and pre-touch this much heap at startup" << std::endl;
+    std::cout << "  --huge-pages <mode>     Backing of the reserved memory: none, thp, explicit" << std::endl;
+    std::cout << "  --help                  Show this help message" << std::endl;
+}
+
+static bool write_json(const std::string& path, const RTConfig& config, int64_t interval_ns,
+                       int64_t distance_ns, double elapsed_s, const std::vector<MeasurementThread>& threads,
+                       const std::vector<std::pair<int, Histogram>>& cores) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[Bench] Cannot write " << path << std::endl;
+        return false;
+    }
+    
+    auto stats = [&out](const Histogram& h) {
+        out << "\"samples\": " << h.samples << ", \"min_us\": " << h.min_ns / 1000.0
+            << ", \"avg_us\": " << h.avg_us() << ", \"p99_us\": " << h.percentile_us(0.99)
+            << ", \"max_us\": " << h.max_ns / 1000.0 << ", \"overflows\": " << h.overflows;
+    };
+    
+    char hostname[256] = "";
+    gethostname(hostname, sizeof(hostname) - 1);
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"host\": \"" << hostname << "\",\n";
+    out << "  \"config\": {\"policy\": \"" << RTUtils::policy_to_string(config.policy)
+        << "\", \"priority\": " << config.priority
+        << ", \"cpus\": \"" << config.cpus() << "\""
+        << ", \"numa\": \"" << RTUtils::numa_policy_to_string(config.numa_policy) << "\""
+        << ", \"lock_memory\": " << (config.lock_memory ? "true" : "false")
+        << ", \"interval_us\": " << interval_ns / 1000.0
+        << ", \"distance_us\": " << distance_ns / 1000.0
+        << ", \"duration_s\": " << elapsed_s << "},\n";
+    
+    out << "  \"threads\": [\n";
+    for (size_t i = 0; i < threads.size(); i++) {
+        const MeasurementThread& m = threads[i];
+        Histogram total(0);
+        for (const auto& core : m.cores) {
+            if (core) {
+                total.min_ns = total.samples == 0 || core->min_ns < total.min_ns ? core->min_ns : total.min_ns;
+                total.max_ns = total.samples == 0 || core->max_ns > total.max_ns ? core->max_ns : total.max_ns;
+                total.sum_ns += core->sum_ns;
+                total.samples += core->samples;
+            }
+        }
+        out << "    {\"thread\": " << m.id << ", \"cpu\": " << m.cpu
+            << ", \"interval_us\": " << m.interval_ns / 1000.0
+            << ", \"configured\": " << (m.configured ? "true" : "false")
+            << ", \"missed_periods\": " << m.missed_periods
+            << ", \"samples\": " << total.samples << ", \"min_us\": " << total.min_ns / 1000.0
+            << ", \"avg_us\": " << total.avg_us() << ", \"max_us\": " << total.max_ns / 1000.0 << "}"
+            << (i + 1 < threads.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    
+    out << "  \"cores\": [\n";
+    for (size_t i = 0; i < cores.size(); i++) {
+        const Histogram& h = cores[i].second;
+        out << "    {\"cpu\": " << cores[i].first << ", ";
+        stats(h);
+        
+        // Sparse histogram: [latency_us, count] of the non-empty buckets
+        out << ", \"histogram\": [";
+        bool first = true;
+        for (size_t b = 0; b < h.buckets.size(); b++) {
+            if (h.buckets[b] == 0) {
+                continue;
+            }
+            out << (first ? "" : ", ") << "[" << b << ", " << h.buckets[b] << "]";
+            first = false;
+        }
+        out << "]}" << (i + 1 < cores.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+    return static_cast<bool>(out);
+}
+
+static bool write_histogram_file(const std::string& path, const std::vector<std::pair<int, Histogram>>& cores) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[Bench] Cannot write " << path << std::endl;
+        return false;
+    }
+    
+    // Last non-empty bucket of any core
+    size_t last = 0;
+    for (const auto& core : cores) {
+        for (size_t b = 0; b < core.second.buckets.size(); b++) {
+            if (core.second.buckets[b] > 0) {
+                last = std::max(last, b);
+            }
+        }
+    }
+    
+    out << "# Wakeup latency histogram (1 us buckets)\n";
+    out << "# gnuplot: set logscale y; plot for [c=2:" << cores.size() + 1
+        << "] '" << path << "' using 1:c with steps title columnhead\n";
+    out << "latency_us";
+    for (const auto& core : cores) {
+        out << " cpu" << core.first;
+    }
+    out << "\n";
+    for (size_t b = 0; b <= last; b++) {
+        out << b;
+        for (const auto& core : cores) {
+            out << " " << core.second.buckets[b];
+        }
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+int main(int argc, char** argv) {
+    RTConfig rt_config;
+    int thread_count = 0;
+    int64_t interval_ns = 1000000;
+    int64_t distance_ns = 500000;
+    double duration_s = 10;
+    uint64_t loops = 0;
+    size_t histogram_us = 1000;
+    std::string json_file;
+    std::string histogram_file;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            thread_count = std::max(std::stoi(argv[++i]), 1);
+        } else if (arg == "--interval-us" && i + 1 < argc) {
+            interval_ns = std::max<int64_t>(std::stoll(argv[++i]), 1) * 1000;
+        } else if (arg == "--distance-us" && i + 1 < argc) {
+            distance_ns = std::stoll(argv[++i]) * 1000;
+        } else if (arg == "--duration-s" && i + 1 < argc) {
+            duration_s = std::stod(argv[++i]);
+        } else if (arg == "--loops" && i + 1 < argc) {
+            loops = std::stoull(argv[++i]);
+        } else if (arg == "--histogram-us" && i + 1 < argc) {
+            histogram_us = std::max<size_t>(std::stoul(argv[++i]), 1);
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_file = argv[++i];
+        } else if (arg == "--histogram-file" && i + 1 < argc) {
+            histogram_file = argv[++i];
+        } else if (arg == "--policy" && i + 1 < argc) {
+            rt_config.policy = RTUtils::string_to_policy(argv[++i]);
+        } else if (arg == "--priority" && i + 1 < argc) {
+            rt_config.priority = std::stoi(argv[++i]);
+        } else if (arg == "--cpu-affinity" && i + 1 < argc) {
+            std::string cpus = argv[++i];
+            if (RTUtils::is_cpu_list(cpus)) {
+                rt_config.cpu_list = cpus;
+            } else {
+                rt_config.cpu_affinity = std::stoi(cpus);
+            }
+        } else if (arg == "--numa" && i + 1 < argc) {
+            rt_config.numa_policy = RTUtils::string_to_numa_policy(argv[++i]);
+        } else if (arg == "--lock-memory") {
+            rt_config.lock_memory = true;
+            rt_config.prefault_stack = true;
+        } else if (arg == "--rt-heap" && i + 1 < argc) {
+            rt_config.tune_malloc = true;
+            rt_config.heap_reserve_bytes = std::stoull(argv[++i]) * 1024 * 1024;
+        } else if (arg == "--huge-pages" && i + 1 < argc) {
+            rt_config.huge_pages = RTUtils::string_to_huge_pages(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    // Thread i runs on the i-th CPU of the affinity list
+    std::vector<int> cpus;
+    cpu_set_t cpu_set;
+    if (!rt_config.cpus().empty()) {
+        if (!RTUtils::parse_cpu_list(rt_config.cpus(), cpu_set)) {
+            std::cerr << "Invalid CPU list: " << rt_config.cpus() << std::endl;
+            return 1;
+        }
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &cpu_set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    if (thread_count == 0) {
+        thread_count = cpus.empty() ? 1 : static_cast<int>(cpus.size());
+    }
+    
+    RTUtils::apply_memory_profile(rt_config);
+    if (rt_config.lock_memory && !RTUtils::lock_memory()) {
+        std::cerr << "[Bench] Continuing without locked memory" << std::endl;
+    }
+    
+    long cpu_count = sysconf(_SC_NPROCESSORS_CONF);
+    size_t core_slots = static_cast<size_t>(std::max<long>(cpu_count, 1));
+    std::vector<MeasurementThread> threads(thread_count);
+    for (int i = 0; i < thread_count; i++) {
+        threads[i].id = i;
+        threads[i].cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+        threads[i].interval_ns = interval_ns + i * distance_ns;
+        threads[i].cores.resize(core_slots);
+    }
+    
+    std::cout << "=== RT wakeup latency benchmark ===" << std::endl;
+    std::cout << "Threads: " << thread_count << ", interval: " << interval_ns / 1000 << " us (+"
+              << distance_ns / 1000 << " us per thread), policy: " << RTUtils::policy_to_string(rt_config.policy)
+              << " prio " << rt_config.priority << ", CPUs: "
+              << (rt_config.cpus().empty() ? "any" : rt_config.cpus()) << std::endl;
+    if (loops > 0) {
+        std::cout << "Measuring " << loops << " wakeups per thread..." << std::endl;
+    } else {
+        std::cout << "Measuring for " << duration_s << " s..." << std::endl;
+    }
+    
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    
+    // Mute apply_rt_config's per-thread report while measuring
+    std::streambuf* saved_cout = std::cout.rdbuf(nullptr);
+    
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int64_t end_ns = loops > 0 ? 0 : timespec_ns(start) + static_cast<int64_t>(duration_s * 1e9);
+    for (auto& m : threads) {
+        m.thread = std::thread(measure, std::ref(m), std::cref(rt_config), histogram_us, loops, end_ns);
+    }
+    for (auto& m : threads) {
+        m.thread.join();
+    }
+    
+    struct timespec finish;
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    double elapsed_s = (timespec_ns(finish) - timespec_ns(start)) / 1e9;
+    
+    std::cout.rdbuf(saved_cout);
+    std::cout.clear();
+    
+    // Merge the threads' histograms per core
+    std::vector<std::pair<int, Histogram>> cores;
+    for (size_t cpu = 0; cpu < core_slots; cpu++) {
+        Histogram merged(histogram_us);
+        for (const auto& m : threads) {
+            if (m.cores[cpu]) {
+                merged.merge(*m.cores[cpu]);
+            }
+        }
+        if (merged.samples > 0) {
+            cores.emplace_back(static_cast<int>(cpu), std::move(merged));
+        }
+    }
+    
+    bool all_configured = true;
+    uint64_t missed_periods = 0;
+    for (const auto& m : threads) {
+        all_configured = all_configured && m.configured;
+        missed_periods += m.missed_periods;
+    }
+    if (!all_configured) {
+        std::cerr << "[Bench] Warning: the RT configuration could not be fully applied "
+                  << "(missing CAP_SYS_NICE?), results reflect the fallback" << std::endl;
+    }
+    
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(8) << "CPU" << std::right
+              << std::setw(12) << "Samples"
+              << std::setw(10) << "Min(us)"
+              << std::setw(10) << "Avg(us)"
+              << std::setw(10) << "P99(us)"
+              << std::setw(10) << "Max(us)"
+              << std::setw(12) << "Overflows" << std::endl;
+    for (const auto& core : cores) {
+        const Histogram& h = core.second;
+        std::cout << std::left << std::setw(8) << core.first << std::right
+                  << std::setw(12) << h.samples
+                  << std::setw(10) << h.min_ns / 1000.0
+                  << std::setw(10) << h.avg_us()
+                  << std::setw(10) << h.percentile_us(0.99)
+                  << std::setw(10) << h.max_ns / 1000.0
+                  << std::setw(12) << h.overflows << std::endl;
+    }
+    if (missed_periods > 0) {
+        std::cout << "Missed periods: " << missed_periods << std::endl;
+    }
+    
+    bool success = true;
+    if (!json_file.empty()) {
+        if (write_json(json_file, rt_config, interval_ns, distance_ns, elapsed_s, threads, cores)) {
+            std::cout << "JSON written to " << json_file << std::endl;
+        } else {
+            success = false;
+        }
+    }
+    if (!histogram_file.empty()) {
+        if (write_histogram_file(histogram_file, cores)) {
+            std::cout << "Histogram written to " << histogram_file << std::endl;
+        } else {
+            success = false;
+        }
+    }
+    
+    return success ? 0 : 1;
+}
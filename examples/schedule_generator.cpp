@@ -0,0 +1,462 @@
+#include "schedule.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace orchestrator;
+
+// Generates large synthetic schedules (YAML or JSON) for scalability tests.
+// Shapes: chains, fork-join stages, random layered DAGs, dense timed bursts
+// and periodic task sets with a target utilization per wrapper. Task
+// durations are drawn from a range and passed as duration_ms (sleep) or
+// iterations (pure computation), both honored by the example task_main.
+// The same seed always produces the same schedule.
+
+void print_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " --shape <shape> [OPTIONS]" << std::endl;
+    std::cout << "\nShapes:" << std::endl;
+    std::cout << "  chain                   Each task depends on the previous one" << std::endl;
+    std::cout << "  fork-join               Fork task, --width parallel branches, join task (repeated)" << std::endl;
+    std::cout << "  layered                 Random DAG in layers of up to --width tasks" << std::endl;
+    std::cout << "  burst                   Timed bursts of --width tasks released together" << std::endl;
+    std::cout << "  periodic                Periodic timed jobs, --utilization per wrapper" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --tasks <n>             Tasks (periodic: periodic tasks; default: 100)" << std::endl;
+    std::cout << "  --width <n>             Branches / layer width / burst size (default: 8)" << std::endl;
+    std::cout << "  --edge-prob <p>         layered: edge probability to the previous layer (default: 0.3)" << std::endl;
+    std::cout << "  --max-deps <n>          layered: dependencies per task at most (default: 4)" << std::endl;
+    std::cout << "  --burst-spacing-ms <ms> burst: time between bursts (default: 100)" << std::endl;
+    std::cout << "  --jitter-us <us>        burst: release jitter inside a burst (default: 0)" << std::endl;
+    std::cout << "  --utilization <u>       periodic: utilization per wrapper (default: 0.5)" << std::endl;
+    std::cout << "  --period-ms <min:max>   periodic: log-uniform period range (default: 10:100)" << std::endl;
+    std::cout << "  --horizon-ms <ms>       periodic: jobs released within (default: 1000)" << std::endl;
+    std::cout << "  --duration-ms <min:max> Per-task duration_ms range (default: 1:5)" << std::endl;
+    std::cout << "  --iterations <min:max>  Use CPU-bound iterations instead of duration_ms" << std::endl;
+    std::cout << "  --wrappers <list>       Comma-separated wrapper addresses, assigned round robin" << std::endl;
+    std::cout << "                          (default: localhost:50051,localhost:50052,localhost:50053)" << std::endl;
+    std::cout << "  --seed <n>              Random seed (default: 1)" << std::endl;
+    std::cout << "  --name <name>           Schedule name (default: generated_<shape>)" << std::endl;
+    std::cout << "  --format <yaml|json>    Output format (default: from --output, else yaml)" << std::endl;
+    std::cout << "  --output <file>         Output file (default: stdout)" << std::endl;
+    std::cout << "  --help                  Show this help message" << std::endl;
+}
+
+struct Range {
+    int64_t min;
+    int64_t max;
+};
+
+static bool parse_range(const std::string& value, Range& range) {
+    try {
+        size_t colon = value.find(':');
+        range.min = std::stoll(value.substr(0, colon));
+        range.max = colon == std::string::npos ? range.min : std::stoll(value.substr(colon + 1));
+    } catch (...) {
+        return false;
+    }
+    return range.min >= 0 && range.max >= range.min;
+}
+
+struct GeneratorConfig {
+    std::string shape;
+    int tasks = 100;
+    int width = 8;
+    double edge_prob = 0.3;
+    int max_deps = 4;
+    int64_t burst_spacing_ms = 100;
+    int64_t jitter_us = 0;
+    double utilization = 0.5;
+    Range period_ms = {10, 100};
+    int64_t horizon_ms = 1000;
+    Range duration_ms = {1, 5};
+    Range iterations = {0, 0};
+    bool use_iterations = false;
+    std::vector<std::string> wrappers = {"localhost:50051", "localhost:50052", "localhost:50053"};
+    uint64_t seed = 1;
+};
+
+class Generator {
+public:
+    explicit Generator(const GeneratorConfig& config) : config_(config), rng_(config.seed) {}
+    
+    TaskSchedule generate() {
+        if (config_.shape == "chain") {
+            chain();
+        } else if (config_.shape == "fork-join") {
+            fork_join();
+        } else if (config_.shape == "layered") {
+            layered();
+        } else if (config_.shape == "burst") {
+            burst();
+        } else if (config_.shape == "periodic") {
+            periodic();
+        }
+        schedule_.time_horizon_start_us = 0;
+        schedule_.time_horizon_end_us = 0;
+        for (const ScheduledTask& task : schedule_.tasks) {
+            schedule_.time_horizon_end_us = std::max(schedule_.time_horizon_end_us,
+                                                     task.scheduled_time_us + task.deadline_us);
+        }
+        schedule_.tick_duration_us = 1000;
+        return schedule_;
+    }
+
+private:
+    int64_t uniform(const Range& range) {
+        return std::uniform_int_distribution<int64_t>(range.min, range.max)(rng_);
+    }
+    
+    double uniform01() {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(rng_);
+    }
+    
+    // New task on the next wrapper with a random duration (sequential mode)
+    ScheduledTask& add_task(const std::string& id) {
+        ScheduledTask task;
+        task.task_id = id;
+        task.task_address = config_.wrappers[schedule_.tasks.size() % config_.wrappers.size()];
+        task.task_addresses.push_back(task.task_address);
+        task.execution_mode = TASK_MODE_SEQUENTIAL;
+        task.scheduled_time_us = 0;
+        task.deadline_us = 1000000;
+        task.priority = 50;
+        task.max_retries = 0;
+        task.critical = false;
+        task.rt_policy = "none";
+        task.rt_priority = 50;
+        task.cpu_affinity = -1;
+        if (config_.use_iterations) {
+            int64_t iterations = uniform(config_.iterations);
+            task.parameters["iterations"] = std::to_string(iterations);
+            task.estimated_duration_us = 0;
+        } else {
+            int64_t duration_ms = uniform(config_.duration_ms);
+            task.parameters["duration_ms"] = std::to_string(duration_ms);
+            task.estimated_duration_us = duration_ms * 1000;
+        }
+        schedule_.tasks.push_back(task);
+        return schedule_.tasks.back();
+    }
+    
+    static void depend(ScheduledTask& task, const std::string& dependency) {
+        task.depends_on.push_back(dependency);
+        task.wait_for_task_id = task.depends_on.front();
+    }
+    
+    void chain() {
+        for (int i = 0; i < config_.tasks; i++) {
+            ScheduledTask& task = add_task("chain_" + std::to_string(i));
+            if (i > 0) {
+                depend(task, "chain_" + std::to_string(i - 1));
+            }
+        }
+    }
+    
+    void fork_join() {
+        int per_stage = config_.width + 2;
+        int stages = std::max(1, config_.tasks / per_stage);
+        std::string previous_join;
+        for (int stage = 0; stage < stages; stage++) {
+            std::string prefix = "s" + std::to_string(stage) + "_";
+            ScheduledTask& fork = add_task(prefix + "fork");
+            if (!previous_join.empty()) {
+                depend(fork, previous_join);
+            }
+            for (int b = 0; b < config_.width; b++) {
+                depend(add_task(prefix + "branch_" + std::to_string(b)), prefix + "fork");
+            }
+            ScheduledTask& join = add_task(prefix + "join");
+            for (int b = 0; b < config_.width; b++) {
+                depend(join, prefix + "branch_" + std::to_string(b));
+            }
+            previous_join = prefix + "join";
+        }
+    }
+    
+    void layered() {
+        std::vector<std::string> previous_layer;
+        int created = 0;
+        for (int layer = 0; created < config_.tasks; layer++) {
+            int width = static_cast<int>(uniform({1, config_.width}));
+            width = std::min(width, config_.tasks - created);
+            std::vector<std::string> current_layer;
+            for (int n = 0; n < width; n++) {
+                std::string id = "l" + std::to_string(layer) + "_" + std::to_string(n);
+                ScheduledTask& task = add_task(id);
+                if (!previous_layer.empty()) {
+                    for (const std::string& candidate : previous_layer) {
+                        if (static_cast<int>(task.depends_on.size()) < config_.max_deps &&
+                            uniform01() < config_.edge_prob) {
+                            depend(task, candidate);
+                        }
+                    }
+                    // Every task below the first layer is reachable
+                    if (task.depends_on.empty()) {
+                        depend(task, previous_layer[uniform({0, static_cast<int64_t>(previous_layer.size()) - 1})]);
+                    }
+                }
+                current_layer.push_back(id);
+            }
+            created += width;
+            previous_layer.swap(current_layer);
+        }
+    }
+    
+    void burst() {
+        int bursts = std::max(1, (config_.tasks + config_.width - 1) / config_.width);
+        int created = 0;
+        for (int b = 0; b < bursts; b++) {
+            int64_t release_us = b * config_.burst_spacing_ms * 1000;
+            for (int n = 0; n < config_.width && created < config_.tasks; n++, created++) {
+                ScheduledTask& task = add_task("b" + std::to_string(b) + "_" + std::to_string(n));
+                task.execution_mode = TASK_MODE_TIMED;
+                task.scheduled_time_us = release_us + (config_.jitter_us > 0 ? uniform({0, config_.jitter_us}) : 0);
+                task.deadline_us = config_.burst_spacing_ms * 1000;
+            }
+        }
+    }
+    
+    // UUniFast: n utilizations summing to `total`, uniformly distributed
+    std::vector<double> uunifast(int n, double total) {
+        std::vector<double> utilizations;
+        double remaining = total;
+        for (int i = 1; i < n; i++) {
+            double next = remaining * std::pow(uniform01(), 1.0 / (n - i));
+            utilizations.push_back(remaining - next);
+            remaining = next;
+        }
+        utilizations.push_back(remaining);
+        return utilizations;
+    }
+    
+    void periodic() {
+        size_t wrapper_count = config_.wrappers.size();
+        std::vector<std::vector<double>> per_wrapper(wrapper_count);
+        for (size_t w = 0; w < wrapper_count; w++) {
+            int n = config_.tasks / static_cast<int>(wrapper_count) +
+                    (static_cast<int>(w) < config_.tasks % static_cast<int>(wrapper_count) ? 1 : 0);
+            if (n > 0) {
+                per_wrapper[w] = uunifast(n, config_.utilization);
+            }
+        }
+        
+        double log_min = std::log(static_cast<double>(std::max<int64_t>(config_.period_ms.min, 1)));
+        double log_max = std::log(static_cast<double>(std::max<int64_t>(config_.period_ms.max, 1)));
+        for (size_t w = 0; w < wrapper_count; w++) {
+            for (size_t t = 0; t < per_wrapper[w].size(); t++) {
+                std::string id = "tau" + std::to_string(w) + "_" + std::to_string(t);
+                int64_t period_ms = static_cast<int64_t>(std::round(std::exp(log_min + uniform01() * (log_max - log_min))));
+                int64_t wcet_ms = std::max<int64_t>(1, static_cast<int64_t>(std::round(per_wrapper[w][t] * period_ms)));
+                
+                for (int64_t release_ms = 0, job = 0; release_ms < config_.horizon_ms; release_ms += period_ms, job++) {
+                    ScheduledTask task;
+                    task.task_id = id + "_j" + std::to_string(job);
+                    task.task_address = config_.wrappers[w];
+                    task.task_addresses.push_back(task.task_address);
+                    task.execution_mode = TASK_MODE_TIMED;
+                    task.scheduled_time_us = release_ms * 1000;
+                    task.deadline_us = period_ms * 1000;
+                    // Rate monotonic: shorter period, higher priority
+                    task.priority = static_cast<int32_t>(std::max<int64_t>(1, 100 - period_ms / 10));
+                    task.max_retries = 0;
+                    task.critical = false;
+                    task.rt_policy = "none";
+                    task.rt_priority = 50;
+                    task.cpu_affinity = -1;
+                    task.estimated_duration_us = wcet_ms * 1000;
+                    task.parameters["duration_ms"] = std::to_string(wcet_ms);
+                    task.parameters["period_ms"] = std::to_string(period_ms);
+                    schedule_.tasks.push_back(task);
+                }
+            }
+        }
+        schedule_.sort_by_time();
+    }
+    
+    GeneratorConfig config_;
+    std::mt19937_64 rng_;
+    TaskSchedule schedule_;
+};
+
+static std::string quoted(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out + "\"";
+}
+
+// One flow-style YAML mapping / JSON object per task (both parse with ScheduleParser)
+static void write_schedule(std::ostream& out, const TaskSchedule& schedule, const std::string& name,
+                           const std::string& description, bool json) {
+    const char* sep = json ? "\": " : ": ";
+    const char* open = json ? "\"" : "";
+    auto key = [&](const char* k) { return std::string(open) + k + sep; };
+    
+    if (json) {
+        out << "{\"schedule\": {\n";
+        out << "  \"name\": " << quoted(name) << ",\n";
+        out << "  \"description\": " << quoted(description) << ",\n";
+        out << "  \"tasks\": [\n";
+    } else {
+        out << "# " << description << "\n";
+        out << "schedule:\n";
+        out << "  name: " << quoted(name) << "\n";
+        out << "  description: " << quoted(description) << "\n";
+        out << "  tasks:\n";
+    }
+    
+    for (size_t i = 0; i < schedule.tasks.size(); i++) {
+        const ScheduledTask& task = schedule.tasks[i];
+        out << (json ? "    {" : "    - {");
+        out << key("id") << quoted(task.task_id);
+        out << ", " << key("address") << quoted(task.task_address);
+        out << ", " << key("mode") << quoted(task.execution_mode == TASK_MODE_TIMED ? "timed" : "sequential");
+        if (task.execution_mode == TASK_MODE_TIMED) {
+            out << ", " << key("scheduled_time_us") << task.scheduled_time_us;
+        }
+        out << ", " << key("deadline_us") << task.deadline_us;
+        out << ", " << key("priority") << task.priority;
+        out << ", " << key("max_retries") << task.max_retries;
+        if (task.estimated_duration_us > 0) {
+            out << ", " << key("estimated_duration_us") << task.estimated_duration_us;
+        }
+        if (!task.depends_on.empty()) {
+            out << ", " << key("depends_on") << "[";
+            for (size_t d = 0; d < task.depends_on.size(); d++) {
+                out << (d > 0 ? ", " : "") << quoted(task.depends_on[d]);
+            }
+            out << "]";
+        }
+        out << ", " << key("parameters") << "{";
+        bool first = true;
+        for (const auto& param : task.parameters) {
+            out << (first ? "" : ", ") << (json ? quoted(param.first) + ": " : param.first + ": ")
+                << quoted(param.second);
+            first = false;
+        }
+        out << "}}";
+        out << (json && i + 1 < schedule.tasks.size() ? ",\n" : "\n");
+    }
+    
+    if (json) {
+        out << "  ]\n}}\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    GeneratorConfig config;
+    std::string name;
+    std::string format;
+    std::string output;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool valid = true;
+        
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--shape" && i + 1 < argc) {
+            config.shape = argv[++i];
+        } else if (arg == "--tasks" && i + 1 < argc) {
+            config.tasks = std::max(std::stoi(argv[++i]), 1);
+        } else if (arg == "--width" && i + 1 < argc) {
+            config.width = std::max(std::stoi(argv[++i]), 1);
+        } else if (arg == "--edge-prob" && i + 1 < argc) {
+            config.edge_prob = std::stod(argv[++i]);
+        } else if (arg == "--max-deps" && i + 1 < argc) {
+            config.max_deps = std::max(std::stoi(argv[++i]), 1);
+        } else if (arg == "--burst-spacing-ms" && i + 1 < argc) {
+            config.burst_spacing_ms = std::max<int64_t>(std::stoll(argv[++i]), 1);
+        } else if (arg == "--jitter-us" && i + 1 < argc) {
+            config.jitter_us = std::stoll(argv[++i]);
+        } else if (arg == "--utilization" && i + 1 < argc) {
+            config.utilization = std::stod(argv[++i]);
+        } else if (arg == "--period-ms" && i + 1 < argc) {
+            valid = parse_range(argv[++i], config.period_ms) && config.period_ms.min > 0;
+        } else if (arg == "--horizon-ms" && i + 1 < argc) {
+            config.horizon_ms = std::stoll(argv[++i]);
+        } else if (arg == "--duration-ms" && i + 1 < argc) {
+            valid = parse_range(argv[++i], config.duration_ms);
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            valid = parse_range(argv[++i], config.iterations);
+            config.use_iterations = true;
+        } else if (arg == "--wrappers" && i + 1 < argc) {
+            config.wrappers.clear();
+            std::stringstream list(argv[++i]);
+            std::string address;
+            while (std::getline(list, address, ',')) {
+                if (!address.empty()) {
+                    config.wrappers.push_back(address);
+                }
+            }
+            valid = !config.wrappers.empty();
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = std::stoull(argv[++i]);
+        } else if (arg == "--name" && i + 1 < argc) {
+            name = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            format = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            valid = false;
+        }
+        
+        if (!valid) {
+            std::cerr << "Invalid option: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    const std::vector<std::string> shapes = {"chain", "fork-join", "layered", "burst", "periodic"};
+    if (std::find(shapes.begin(), shapes.end(), config.shape) == shapes.end()) {
+        std::cerr << "Error: --shape must be one of chain, fork-join, layered, burst, periodic" << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (format.empty()) {
+        format = output.size() > 5 && output.compare(output.size() - 5, 5, ".json") == 0 ? "json" : "yaml";
+    }
+    if (format != "yaml" && format != "json") {
+        std::cerr << "Error: --format must be yaml or json" << std::endl;
+        return 1;
+    }
+    if (name.empty()) {
+        name = "generated_" + config.shape;
+    }
+    
+    TaskSchedule schedule = Generator(config).generate();
+    
+    std::ostringstream description;
+    description << "Generated: shape=" << config.shape << " tasks=" << schedule.tasks.size()
+                << " seed=" << config.seed << " wrappers=" << config.wrappers.size();
+    if (config.shape == "periodic") {
+        description << " utilization=" << config.utilization << "/wrapper horizon_ms=" << config.horizon_ms;
+    }
+    
+    if (output.empty() || output == "-") {
+        write_schedule(std::cout, schedule, name, description.str(), format == "json");
+    } else {
+        std::ofstream file(output);
+        if (!file) {
+            std::cerr << "Error: cannot write " << output << std::endl;
+            return 1;
+        }
+        write_schedule(file, schedule, name, description.str(), format == "json");
+        std::cerr << "Wrote " << schedule.tasks.size() << " tasks to " << output << " (" << format << ")" << std::endl;
+    }
+    
+    return 0;
+}
@@ -1,11 +1,14 @@
 #include "task_wrapper.h"
 #include "rt_utils.h"
+#include "rt_memory_pool.h"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <thread>
 #include <chrono>
 #include <signal.h>
 #include <cstring>
+#include <vector>
 
 using namespace orchestrator;
 
@@ -32,8 +35,13 @@ TaskResult example_task_function(const std::map<std::string, std::string>& param
     std::cout << "[" << std::setw(13) << get_absolute_time_ms() << " ms] "
               << "[Task Function] Starting execution with parameters:" << std::endl;
     
+    // Outputs of the dependencies may be large or binary: long values show their size
     for (const auto& param : params) {
-        std::cout << "  " << param.first << " = " << param.second << std::endl;
+        if (param.second.size() > 64) {
+            std::cout << "  " << param.first << " = <" << param.second.size() << " bytes>" << std::endl;
+        } else {
+            std::cout << "  " << param.first << " = " << param.second << std::endl;
+        }
     }
     
     // Get task_id to determine which string to print
@@ -72,6 +80,22 @@ TaskResult example_task_function(const std::map<std::string, std::string>& param
         }
     }
     
+    // Scratch memory, from the wrapper's pool when one is configured (--rt-pool)
+    auto alloc_it = params.find("alloc_kb");
+    if (alloc_it != params.end()) {
+        size_t alloc_bytes = 0;
+        try {
+            alloc_bytes = std::stoull(alloc_it->second) * 1024;
+        } catch (...) {
+            std::cerr << "[" << std::setw(13) << get_absolute_time_ms() << " ms] "
+                      << "[Task Function] Invalid alloc_kb parameter" << std::endl;
+        }
+        std::vector<char, RTPoolAllocator<char>> scratch(alloc_bytes);
+        for (size_t i = 0; i < scratch.size(); i += 4096) {
+            scratch[i] = static_cast<char>(i);
+        }
+    }
+    
     // Check if we should do pure computation (iterations) or sleep-based work
     auto iter_it = params.find("iterations");
     if (iter_it != params.end()) {
@@ -101,10 +125,12 @@ TaskResult example_task_function(const std::map<std::string, std::string>& param
         std::cout << "[" << std::setw(13) << get_absolute_time_ms() << " ms] "
                   << "[Task Function] Simulating work for " << duration_ms << " ms..." << std::endl;
         
-        // Simulate work in chunks to allow for interruption
-        int chunks = duration_ms / 100;
+        // Simulate work in chunks of up to 100 ms to allow for interruption
+        // (the last chunk carries the remainder, so short durations are honored)
+        int chunks = (duration_ms + 99) / 100;
         for (int i = 0; i < chunks; i++) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            int chunk_ms = std::min(100, duration_ms - i * 100);
+            std::this_thread::sleep_for(std::chrono::milliseconds(chunk_ms));
             std::cout << "[" << std::setw(13) << get_absolute_time_ms() << " ms] "
                       << "[Task Function] Progress: " << ((i + 1) * 100 / chunks) << "%" << std::endl;
         }
@@ -127,6 +153,24 @@ TaskResult example_task_function(const std::map<std::string, std::string>& param
                   << "[Task Function] Work completed successfully" << std::endl;
     }
     
+    // Output for the dependents: "<task_id>.result", inline when small,
+    // written straight into shared memory otherwise
+    auto output_it = params.find("output_kb");
+    if (output_it != params.end() && g_task_wrapper) {
+        size_t output_bytes = 0;
+        try {
+            output_bytes = std::stoull(output_it->second) * 1024;
+        } catch (...) {
+            std::cerr << "[" << std::setw(13) << get_absolute_time_ms() << " ms] "
+                      << "[Task Function] Invalid output_kb parameter" << std::endl;
+        }
+        if (output_bytes <= INLINE_OUTPUT_BYTES) {
+            g_task_wrapper->publish_output("result", task_id);
+        } else if (char* output = g_task_wrapper->allocate_output("result", output_bytes)) {
+            memset(output, task_id.empty() ? 0 : task_id.back(), output_bytes);
+        }
+    }
+    
     return TASK_RESULT_SUCCESS;
 }
 
@@ -134,13 +178,35 @@ void print_usage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [OPTIONS]" << std::endl;
     std::cout << "\nRequired Options:" << std::endl;
     std::cout << "  --name <id>             Task ID" << std::endl;
-    std::cout << "  --address <addr>        Listen address" << std::endl;
-    std::cout << "  --orchestrator <addr>   Orchestrator address" << std::endl;
+    std::cout << "  --address <addr>        Listen address (host:port or unix:<path>)" << std::endl;
+    std::cout << "  --orchestrator <addr>   Orchestrator address (host:port or unix:<path>)" << std::endl;
     std::cout << "\nReal-Time Options:" << std::endl;
     std::cout << "  --policy <policy>       RT scheduling policy: none, fifo, rr (default: none)" << std::endl;
     std::cout << "  --priority <n>          RT priority: 1-99 (default: 50)" << std::endl;
-    std::cout << "  --cpu-affinity <n>      Bind to CPU core (default: -1, no affinity)" << std::endl;
+    std::cout << "  --cpu-affinity <cpus>   Bind to a CPU core or a CPU list, e.g. 2-5,8 (default: none)" << std::endl;
+    std::cout << "  --numa <policy>         Memory on the NUMA nodes of the bound CPUs:" << std::endl;
+    std::cout << "                          none, preferred, bind (default: none)" << std::endl;
     std::cout << "  --lock-memory           Lock memory pages (prevents page faults)" << std::endl;
+    std::cout << "  --rt-heap <MB>          Tune malloc and pre-touch this much heap at startup" << std::endl;
+    std::cout << "  --rt-pool <KB>          Pre-faulted memory pool for the task callbacks" << std::endl;
+    std::cout << "  --huge-pages <mode>     Backing of the reserved memory: none, thp, explicit" << std::endl;
+    std::cout << "  --grpc-pollers <n>      gRPC server polling threads (default: gRPC's)" << std::endl;
+    std::cout << "  --grpc-max-threads <n>  Cap on gRPC server threads (default: none)" << std::endl;
+    std::cout << "  --grpc-policy <policy>  RT policy of the gRPC handler threads (default: none)" << std::endl;
+    std::cout << "  --grpc-priority <n>     RT priority of the gRPC handler threads (default: 49)" << std::endl;
+    std::cout << "  --housekeeping-cpus <m> CPU mask for gRPC's internal threads, e.g. 0x1" << std::endl;
+    std::cout << "  --zero-alloc            Persistent worker, no heap allocation after warmup" << std::endl;
+    std::cout << "  --notify-window-us <us> Coalesce end notifications within this window" << std::endl;
+    std::cout << "  --cgroup                Run each execution in a cgroup v2 child (cpuset," << std::endl;
+    std::cout << "                          cpu.max, memory.max); needs a delegated subtree" << std::endl;
+    std::cout << "  --cgroup-cpus <list>    Default cpuset of the executions, e.g. 2-3" << std::endl;
+    std::cout << "  --perf                  Measure each execution with perf counters (task-clock," << std::endl;
+    std::cout << "                          context switches, migrations, faults, cycles, ...)" << std::endl;
+    std::cout << "\nTransport Options:" << std::endl;
+    std::cout << "  --shm <name>            Also serve starts over a shared-memory channel" << std::endl;
+    std::cout << "                          (use address shm://<listen_addr> in the schedule)" << std::endl;
+    std::cout << "  --uds <path>            Also listen on a Unix domain socket; a co-located" << std::endl;
+    std::cout << "                          orchestrator dials it instead of TCP loopback" << std::endl;
     std::cout << "  --help                  Show this help message" << std::endl;
     std::cout << "\nBackward Compatible Usage:" << std::endl;
     std::cout << "  " << program_name << " <task_id> <listen_address> <orchestrator_address>" << std::endl;
@@ -152,6 +218,13 @@ int main(int argc, char** argv) {
     std::string listen_address;
     std::string orchestrator_address;
     RTConfig rt_config;
+    bool zero_alloc = false;
+    int64_t notify_window_us = 0;
+    std::string shm_name;
+    std::string uds_path;
+    bool cgroup = false;
+    bool perf = false;
+    std::string cgroup_cpus;
     
     // Backward compatibility: positional arguments
     if (argc >= 4 && argv[1][0] != '-') {
@@ -177,10 +250,49 @@ int main(int argc, char** argv) {
             } else if (arg == "--priority" && i + 1 < argc) {
                 rt_config.priority = std::stoi(argv[++i]);
             } else if (arg == "--cpu-affinity" && i + 1 < argc) {
-                rt_config.cpu_affinity = std::stoi(argv[++i]);
+                std::string cpus = argv[++i];
+                if (RTUtils::is_cpu_list(cpus)) {
+                    rt_config.cpu_list = cpus;
+                } else {
+                    rt_config.cpu_affinity = std::stoi(cpus);
+                }
+            } else if (arg == "--numa" && i + 1 < argc) {
+                rt_config.numa_policy = RTUtils::string_to_numa_policy(argv[++i]);
             } else if (arg == "--lock-memory") {
                 rt_config.lock_memory = true;
                 rt_config.prefault_stack = true;
+            } else if (arg == "--rt-heap" && i + 1 < argc) {
+                rt_config.tune_malloc = true;
+                rt_config.heap_reserve_bytes = std::stoull(argv[++i]) * 1024 * 1024;
+            } else if (arg == "--rt-pool" && i + 1 < argc) {
+                rt_config.pool_bytes = std::stoull(argv[++i]) * 1024;
+            } else if (arg == "--huge-pages" && i + 1 < argc) {
+                rt_config.huge_pages = RTUtils::string_to_huge_pages(argv[++i]);
+            } else if (arg == "--grpc-pollers" && i + 1 < argc) {
+                rt_config.grpc_pollers = std::stoi(argv[++i]);
+            } else if (arg == "--grpc-max-threads" && i + 1 < argc) {
+                rt_config.grpc_max_threads = std::stoi(argv[++i]);
+            } else if (arg == "--grpc-policy" && i + 1 < argc) {
+                rt_config.grpc_policy = RTUtils::string_to_policy(argv[++i]);
+            } else if (arg == "--grpc-priority" && i + 1 < argc) {
+                rt_config.grpc_priority = std::stoi(argv[++i]);
+            } else if (arg == "--housekeeping-cpus" && i + 1 < argc) {
+                rt_config.housekeeping_cpu_mask = RTUtils::string_to_cpu_mask(argv[++i]);
+            } else if (arg == "--zero-alloc") {
+                zero_alloc = true;
+            } else if (arg == "--notify-window-us" && i + 1 < argc) {
+                notify_window_us = std::stoll(argv[++i]);
+            } else if (arg == "--shm" && i + 1 < argc) {
+                shm_name = argv[++i];
+            } else if (arg == "--uds" && i + 1 < argc) {
+                uds_path = argv[++i];
+            } else if (arg == "--perf") {
+                perf = true;
+            } else if (arg == "--cgroup") {
+                cgroup = true;
+            } else if (arg == "--cgroup-cpus" && i + 1 < argc) {
+                cgroup = true;
+                cgroup_cpus = argv[++i];
             }
         }
     }
@@ -201,6 +313,10 @@ int main(int argc, char** argv) {
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     
+    // malloc settings only reach arenas created afterwards: apply them before
+    // gRPC starts its threads
+    RTUtils::apply_memory_profile(rt_config);
+    
     // Create task wrapper
     TaskWrapper task_wrapper(
         task_id,
@@ -212,13 +328,31 @@ int main(int argc, char** argv) {
     g_task_wrapper = &task_wrapper;
     
     // Set real-time configuration
-    if (rt_config.policy != RT_POLICY_NONE) {
+    if (rt_config.policy != RT_POLICY_NONE || rt_config.configures_grpc() ||
+        rt_config.numa_policy != NUMA_POLICY_NONE || rt_config.configures_memory()) {
         std::cout << "[Main] Configuring real-time scheduling" << std::endl;
         task_wrapper.set_rt_config(rt_config);
     } else {
         std::cout << "[Main] Running in non-real-time mode" << std::endl;
     }
     
+    if (zero_alloc) {
+        task_wrapper.set_zero_allocation_mode(true);
+    }
+    if (notify_window_us > 0) {
+        task_wrapper.set_notify_coalescing_window(notify_window_us);
+    }
+    if (!shm_name.empty()) {
+        task_wrapper.set_shm_endpoint(shm_name);
+    }
+    if (!uds_path.empty()) {
+        task_wrapper.set_uds_path(uds_path);
+    }
+    if (cgroup) {
+        task_wrapper.set_cgroup_isolation(true, cgroup_cpus);
+    }
+    task_wrapper.set_perf_counters(perf);
+    
     // Start task wrapper (listen for commands)
     task_wrapper.start();
     
@@ -0,0 +1,162 @@
+#include "trace_file.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace orchestrator;
+
+// Reads a binary execution trace written by the orchestrator (--trace) and
+// prints per-task summaries, or exports every record as CSV.
+
+void print_usage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " <trace file> [OPTIONS]" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --csv <file>            Export all records as CSV ('-' for stdout)" << std::endl;
+    std::cout << "  --no-summary            Do not print the per-task summary" << std::endl;
+    std::cout << "  --help                  Show this help message" << std::endl;
+}
+
+struct TaskSummary {
+    uint64_t count = 0;
+    uint64_t success = 0;
+    uint64_t failed = 0;
+    int64_t min_duration_us = 0;
+    int64_t max_duration_us = 0;
+    int64_t total_duration_us = 0;
+    int64_t max_start_delay_us = 0;
+    int64_t total_start_delay_us = 0;
+};
+
+static void print_summary(const TraceReader& reader) {
+    const auto& records = reader.records();
+    std::vector<TaskSummary> summaries(reader.task_ids().size());
+    
+    for (const TraceRecord& rec : records) {
+        if (rec.handle >= summaries.size()) {
+            continue;
+        }
+        TaskSummary& s = summaries[rec.handle];
+        int64_t duration = rec.end_time_us - rec.actual_start_time_us;
+        int64_t delay = rec.actual_start_time_us - rec.scheduled_time_us;
+        
+        if (s.count == 0 || duration < s.min_duration_us) {
+            s.min_duration_us = duration;
+        }
+        s.max_duration_us = std::max(s.max_duration_us, duration);
+        s.total_duration_us += duration;
+        s.max_start_delay_us = std::max(s.max_start_delay_us, delay);
+        s.total_start_delay_us += delay;
+        s.count++;
+        if (rec.result == TASK_RESULT_SUCCESS) {
+            s.success++;
+        } else {
+            s.failed++;
+        }
+    }
+    
+    int64_t span_us = 0;
+    for (const TraceRecord& rec : records) {
+        span_us = std::max(span_us, rec.end_time_us);
+    }
+    
+    std::cout << "=== Trace Summary ===" << std::endl;
+    std::cout << "Start time: " << reader.header().start_time_us << " us (unix epoch)" << std::endl;
+    std::cout << "Tasks: " << reader.task_ids().size() << std::endl;
+    std::cout << "Executions: " << records.size() << std::endl;
+    std::cout << "Span: " << span_us / 1000.0 << " ms" << std::endl;
+    std::cout << std::endl;
+    
+    std::cout << std::left << std::setw(24) << "Task"
+              << std::right << std::setw(8) << "Runs"
+              << std::setw(8) << "Failed"
+              << std::setw(12) << "Min ms"
+              << std::setw(12) << "Avg ms"
+              << std::setw(12) << "Max ms"
+              << std::setw(14) << "Avg delay ms"
+              << std::setw(14) << "Max delay ms" << std::endl;
+    
+    std::cout << std::fixed << std::setprecision(3);
+    for (size_t h = 0; h < summaries.size(); h++) {
+        const TaskSummary& s = summaries[h];
+        if (s.count == 0) {
+            continue;
+        }
+        std::cout << std::left << std::setw(24) << reader.task_id(static_cast<uint32_t>(h))
+                  << std::right << std::setw(8) << s.count
+                  << std::setw(8) << s.failed
+                  << std::setw(12) << s.min_duration_us / 1000.0
+                  << std::setw(12) << s.total_duration_us / 1000.0 / s.count
+                  << std::setw(12) << s.max_duration_us / 1000.0
+                  << std::setw(14) << s.total_start_delay_us / 1000.0 / s.count
+                  << std::setw(14) << s.max_start_delay_us / 1000.0 << std::endl;
+    }
+}
+
+static void write_csv(const TraceReader& reader, std::ostream& out) {
+    out << "sequence,task_id,state,result,scheduled_us,start_us,end_us,duration_us,start_delay_us\n";
+    for (const TraceRecord& rec : reader.records()) {
+        out << rec.sequence << ','
+            << reader.task_id(rec.handle) << ','
+            << TaskState_Name(static_cast<TaskState>(rec.state)) << ','
+            << TaskResult_Name(static_cast<TaskResult>(rec.result)) << ','
+            << rec.scheduled_time_us << ','
+            << rec.actual_start_time_us << ','
+            << rec.end_time_us << ','
+            << (rec.end_time_us - rec.actual_start_time_us) << ','
+            << (rec.actual_start_time_us - rec.scheduled_time_us) << '\n';
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string trace_path;
+    std::string csv_path;
+    bool summary = true;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (arg == "--no-summary") {
+            summary = false;
+        } else if (arg[0] != '-' && trace_path.empty()) {
+            trace_path = arg;
+        }
+    }
+    
+    if (trace_path.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    TraceReader reader;
+    if (!reader.open(trace_path)) {
+        return 1;
+    }
+    
+    if (!csv_path.empty()) {
+        if (csv_path == "-") {
+            write_csv(reader, std::cout);
+        } else {
+            std::ofstream out(csv_path);
+            if (!out) {
+                std::cerr << "Failed to open " << csv_path << std::endl;
+                return 1;
+            }
+            write_csv(reader, out);
+            std::cout << "Wrote " << reader.records().size() << " records to " << csv_path << std::endl;
+        }
+    }
+    
+    if (summary && csv_path != "-") {
+        print_summary(reader);
+    }
+    
+    return 0;
+}
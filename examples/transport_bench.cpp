@@ -0,0 +1,215 @@
+#include "task_wrapper.h"
+#include "shm_transport.h"
+#include "address_utils.h"
+#include <grpcpp/grpcpp.h>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace orchestrator;
+
+// Start latency and StartTask -> NotifyTaskEnd round trip over gRPC on TCP
+// loopback, gRPC on Unix domain sockets and the shared-memory channel,
+// against in-process wrappers running an empty task. The next start is sent
+// once the previous task's end notification has arrived.
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Counts task ends, whichever transport they arrive on
+class EndCounter {
+public:
+    void add() {
+        int64_t now = now_ns();
+        std::lock_guard<std::mutex> lock(mutex_);
+        ends_++;
+        last_end_ns_ = now;
+        cv_.notify_all();
+    }
+    
+    // Returns the arrival time of the last end
+    int64_t wait_for(uint64_t ends) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this, ends]() { return ends_ >= ends; });
+        return last_end_ns_;
+    }
+    
+    uint64_t ends() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ends_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint64_t ends_ = 0;
+    int64_t last_end_ns_ = 0;
+};
+
+// Orchestrator side of the gRPC end notifications
+class EndService final : public OrchestratorService::Service {
+public:
+    explicit EndService(EndCounter& counter) : counter_(counter) {}
+    
+    grpc::Status NotifyTaskEnd(grpc::ServerContext*, const TaskEndNotification*,
+                               TaskEndResponse* response) override {
+        counter_.add();
+        response->set_acknowledged(true);
+        return grpc::Status::OK;
+    }
+
+private:
+    EndCounter& counter_;
+};
+
+struct Samples {
+    std::vector<int64_t> start_ns;        // Start command round trip
+    std::vector<int64_t> round_trip_ns;   // Start sent -> end notification received
+};
+
+static double percentile_us(std::vector<int64_t>& samples, double p) {
+    std::sort(samples.begin(), samples.end());
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    return samples[index] / 1000.0;
+}
+
+static void print_row(const char* name, Samples& samples) {
+    std::cout << std::left << std::setw(12) << name << std::right
+              << std::setw(12) << percentile_us(samples.start_ns, 0.50)
+              << std::setw(12) << percentile_us(samples.start_ns, 0.99)
+              << std::setw(12) << percentile_us(samples.round_trip_ns, 0.50)
+              << std::setw(12) << percentile_us(samples.round_trip_ns, 0.99) << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = 5000;
+    size_t warmup = 200;
+    int port = 50180;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max<size_t>(std::stoul(argv[++i]), 1);
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            warmup = std::stoul(argv[++i]);
+        } else if (arg == "--port" && i + 1 < argc) {
+            port = std::stoi(argv[++i]);
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0]
+                      << " [--iterations N] [--warmup N] [--port P]" << std::endl;
+            return 0;
+        }
+    }
+    
+    std::string orchestrator_address = "localhost:" + std::to_string(port);
+    std::string wrapper_address = "localhost:" + std::to_string(port + 1);
+    std::string shm_name = "transport_bench_" + std::to_string(port);
+    std::string orchestrator_uds = "unix:/tmp/transport_bench_" + std::to_string(port) + ".sock";
+    std::string wrapper_uds = "unix:/tmp/transport_bench_" + std::to_string(port + 1) + ".sock";
+    
+    EndCounter counter;
+    EndService service(counter);
+    grpc::ServerBuilder builder;
+    AddressUtils::prepare_listen(orchestrator_uds);
+    builder.AddListeningPort(orchestrator_address, grpc::InsecureServerCredentials());
+    builder.AddListeningPort(orchestrator_uds, grpc::InsecureServerCredentials());
+    builder.RegisterService(&service);
+    std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+    if (!server) {
+        std::cerr << "Failed to listen on " << orchestrator_address << std::endl;
+        return 1;
+    }
+    
+    // The wrapper logs every execution; keep the output out of the measurement
+    std::streambuf* saved_cout = std::cout.rdbuf(nullptr);
+    
+    TaskWrapper wrapper("bench", wrapper_address, orchestrator_address,
+                        [](const TaskParameterView&) { return TASK_RESULT_SUCCESS; });
+    wrapper.set_zero_allocation_mode(true);
+    wrapper.set_shm_endpoint(shm_name);
+    wrapper.start();
+    
+    // Same wrapper over Unix domain sockets in both directions
+    TaskWrapper uds_wrapper("bench", wrapper_uds, orchestrator_uds,
+                            [](const TaskParameterView&) { return TASK_RESULT_SUCCESS; });
+    uds_wrapper.set_zero_allocation_mode(true);
+    uds_wrapper.start();
+    
+    auto tcp_stub = TaskService::NewStub(grpc::CreateChannel(wrapper_address, grpc::InsecureChannelCredentials()));
+    auto uds_stub = TaskService::NewStub(grpc::CreateChannel(wrapper_uds, grpc::InsecureChannelCredentials()));
+    ShmClient shm([&counter](const TaskEndNotification&) { counter.add(); });
+    bool shm_ok = !wrapper.get_shm_name().empty() && shm.connect(wrapper.get_shm_name());
+    
+    StartTaskRequest start;
+    start.set_task_id("bench");
+    StartTaskResponse response;
+    
+    Samples tcp_samples, uds_samples, shm_samples;
+    
+    // Rejected while the previous end notification was in flight: retry
+    auto run = [&](TaskService::Stub* stub, Samples* samples, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            uint64_t ends = counter.ends();
+            int64_t begin;
+            int64_t elapsed_ns;
+            bool accepted;
+            do {
+                response.Clear();
+                begin = now_ns();
+                grpc::Status status;
+                if (stub) {
+                    grpc::ClientContext context;
+                    status = stub->StartTask(&context, start, &response);
+                } else {
+                    status = shm.start_task(start, &response, 1000000);
+                }
+                elapsed_ns = now_ns() - begin;
+                accepted = status.ok() && response.success();
+            } while (!accepted);
+            int64_t end_ns = counter.wait_for(ends + 1);
+            if (samples) {
+                samples->start_ns.push_back(elapsed_ns);
+                samples->round_trip_ns.push_back(end_ns - begin);
+            }
+        }
+    };
+    
+    run(tcp_stub.get(), nullptr, warmup);
+    run(tcp_stub.get(), &tcp_samples, iterations);
+    run(uds_stub.get(), nullptr, warmup);
+    run(uds_stub.get(), &uds_samples, iterations);
+    if (shm_ok) {
+        run(nullptr, nullptr, warmup);
+        run(nullptr, &shm_samples, iterations);
+    }
+    
+    shm.disconnect();
+    wrapper.stop();
+    uds_wrapper.stop();
+    std::cout.rdbuf(saved_cout);
+    std::cout.clear();
+    server->Shutdown();
+    AddressUtils::remove_socket(orchestrator_uds);
+    
+    std::cout << "=== Transport benchmark ===" << std::endl;
+    std::cout << "Iterations: " << iterations << " (after " << warmup << " warm-up starts)" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(12) << "Transport" << std::right
+              << std::setw(12) << "start p50" << std::setw(12) << "start p99"
+              << std::setw(12) << "r-trip p50" << std::setw(12) << "r-trip p99" << "  (us)" << std::endl;
+    print_row("TCP", tcp_samples);
+    print_row("UDS", uds_samples);
+    if (shm_ok) {
+        print_row("shm", shm_samples);
+    } else {
+        std::cerr << "Shared-memory channel unavailable, not measured" << std::endl;
+    }
+    return 0;
+}
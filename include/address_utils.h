@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+
+namespace orchestrator {
+
+// Helpers for the listen/dial addresses accepted everywhere an address is:
+// "host:port" (TCP) or "unix:<path>" / "unix:///<absolute path>" (Unix
+// domain socket, same syntax as gRPC). Schedules may prefix a task address
+// with "shm://" to request the shared-memory channel (see EndpointPool).
+class AddressUtils {
+public:
+    static constexpr const char* UNIX_SCHEME = "unix:";
+    static constexpr const char* SHM_SCHEME = "shm://";
+    
+    // True for "shm://" task addresses
+    static bool is_shm(const std::string& address);
+    
+    // The gRPC address of a task address (without "shm://")
+    static std::string strip_shm(const std::string& address);
+    
+    // True for "unix:" addresses
+    static bool is_unix(const std::string& address);
+    
+    // Filesystem path of a "unix:" address ("" for TCP addresses)
+    static std::string unix_path(const std::string& address);
+    
+    // True for TCP addresses on this host (localhost, 127.0.0.0/8, ::1)
+    static bool is_loopback(const std::string& address);
+    
+    // True if the address reaches this host ("unix:" or loopback, with or
+    // without "shm://"), i.e. the peer shares /dev/shm with us
+    static bool is_local(const std::string& address);
+    
+    // True if the address is "host:port" or "unix:<path>"
+    static bool is_valid(const std::string& address);
+    
+    // True if a Unix domain socket exists at the path of a "unix:" address
+    static bool unix_socket_exists(const std::string& address);
+    
+    // Before listening on a "unix:" address: remove a stale socket file left
+    // by a previous run. False if another process is still listening there or
+    // the path is not a socket. TCP addresses always succeed.
+    static bool prepare_listen(const std::string& address);
+    
+    // After the server shut down: remove the socket file of a "unix:" address
+    static void remove_socket(const std::string& address);
+};
+
+} // namespace orchestrator
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+namespace orchestrator {
+
+// Heap allocation counter used to verify allocation-free hot paths.
+// Counting is only active when the library is built with
+// -DORCHESTRATOR_COUNT_ALLOCATIONS=ON, which interposes malloc/calloc/realloc
+// (glibc). Otherwise enabled() returns false and all counters stay at zero.
+class AllocCounter {
+public:
+    // Whether allocation counting is compiled in
+    static bool enabled();
+    
+    // Number of allocations made by the calling thread so far
+    static uint64_t thread_allocations();
+    
+    // Number of allocations made by the whole process so far
+    static uint64_t total_allocations();
+};
+
+// Counts the allocations made by the calling thread inside a scope
+class ScopedAllocCounter {
+public:
+    ScopedAllocCounter() : start_(AllocCounter::thread_allocations()) {}
+    uint64_t count() const { return AllocCounter::thread_allocations() - start_; }
+
+private:
+    uint64_t start_;
+};
+
+} // namespace orchestrator
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace orchestrator {
+
+// Per-execution CPU isolation with cgroup v2 (wrapper side).
+// At init the wrapper process moves into its own cgroup <delegated>/<name>
+// (memory limit) holding a threaded child "exec" (cpuset, cpu.max). The
+// thread running an execution joins "exec" for the duration of the callback
+// and goes back afterwards, so a noisy task is contained by cpuset and CPU
+// bandwidth while keeping its RT policy. cpu.stat deltas of "exec" give the
+// throttling each execution suffered. Note that cpu.max only throttles
+// SCHED_OTHER threads (without RT group scheduling, RT threads are bounded
+// by the global sched_rt_runtime_us); RT executions are contained by cpuset.
+// memory is a domain controller, charged per process, so a memory limit
+// caps the whole wrapper while the execution runs: a limit at or below the
+// wrapper's memory.current is refused rather than OOM-killing it.
+//
+// Needs a delegated cgroup v2 subtree with the cpu controller (cpuset and
+// memory are used when available); otherwise init() fails and the wrapper
+// runs without isolation.
+class CgroupIsolation {
+public:
+    // Limits of one execution
+    struct Limits {
+        std::string cpus;              // cpuset.cpus ("" = wrapper's default)
+        double cpu_bandwidth = 0;      // CPUs worth of bandwidth (0 = unlimited)
+        int64_t estimated_duration_us = 0;  // Sets the bandwidth period
+        int64_t memory_limit_bytes = 0;     // memory.max of the wrapper during the execution (0 = unlimited)
+    };
+    
+    // cpu.stat counters (microseconds / periods)
+    struct CpuStat {
+        int64_t usage_us = 0;
+        uint64_t nr_periods = 0;
+        uint64_t nr_throttled = 0;
+        int64_t throttled_us = 0;
+    };
+    
+    // Bounds of the cpu.max period (kernel limits: 1 ms .. 1 s)
+    static constexpr int64_t MIN_PERIOD_US = 1000;
+    static constexpr int64_t MAX_PERIOD_US = 1000000;
+    
+    // Bandwidth periods per estimated execution, so throttling is spread
+    // over the run instead of hitting it as one long stall
+    static constexpr int64_t PERIODS_PER_EXECUTION = 10;
+    
+    CgroupIsolation();
+    ~CgroupIsolation();
+    
+    // Set up <root>/<name> and its "exec" child. root = "" uses the cgroup
+    // the process is in. default_cpus = "" keeps the inherited cpuset.
+    bool init(const std::string& name, const std::string& default_cpus = "", const std::string& root = "");
+    
+    // Move the process back to the cgroup it started in and remove the
+    // cgroups created by init(). Call once no execution is running. While
+    // other wrappers still use the same parent the process cannot leave, and
+    // the wrapper cgroup is left in place (the next run reuses it).
+    void release();
+    
+    bool enabled() const { return enabled_; }
+    const std::string& path() const { return wrapper_path_; }
+    
+    // Apply the limits and move the calling thread into "exec"; `before`
+    // receives the counters to diff against at leave(). False if the thread
+    // could not be moved (leave() must not be called then).
+    bool enter(const Limits& limits, CpuStat& before);
+    
+    // Move the calling thread back to the wrapper cgroup; `usage` receives
+    // the counters accumulated since enter()
+    void leave(const CpuStat& before, CpuStat& usage);
+    
+    // cpu.max "quota period" for a bandwidth and an estimated duration
+    static void bandwidth_to_max(double cpu_bandwidth, int64_t estimated_duration_us,
+                                 int64_t& quota_us, int64_t& period_us);
+
+private:
+    bool setup(const std::string& name, const std::string& default_cpus, const std::string& root);
+    bool read_cpu_stat(CpuStat& stat) const;
+    bool move_thread(int threads_fd) const;
+    int64_t read_memory_current() const;
+    
+    // Enable a controller in base's subtree_control, remembering the ones
+    // release() has to disable again
+    bool enable_controller(const std::string& enabled, const char* name);
+    
+    // Write a value to a control file only if it changed since the last write
+    bool write_cached(int fd, std::string& cache, const char* value, const char* file);
+    
+    static std::string own_cgroup();
+    static bool write_file(const std::string& path, const std::string& value);
+    static std::string read_file(const std::string& path);
+    
+    bool enabled_;
+    std::string origin_path_;       // The cgroup the process started in
+    std::string base_path_;
+    std::vector<const char*> base_controllers_;  // Enabled below base by init()
+    std::string wrapper_path_;
+    std::string exec_path_;
+    bool has_cpuset_;
+    bool has_memory_;
+    std::string default_cpus_;
+    
+    // Control files kept open: an execution writes without path lookups
+    int exec_threads_fd_;
+    int wrapper_threads_fd_;
+    int cpu_max_fd_;
+    int cpuset_fd_;
+    int memory_max_fd_;
+    int memory_current_fd_;
+    int cpu_stat_fd_;
+    std::string cpu_max_;
+    std::string cpuset_;
+    std::string memory_max_;
+};
+
+} // namespace orchestrator
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "task_table.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace orchestrator {
+
+struct TaskExecution;
+struct TimelineDependency;
+
+// One execution on the critical path of a finished run
+struct CriticalPathStep {
+    std::string task_id;
+    int64_t start_us;        // Actual start (relative to orchestrator start)
+    int64_t end_us;
+    int64_t wait_us;         // Start minus the end of the previous step (0 for the first)
+};
+
+// Bottom levels of the dependency graph: the longest path from a task to
+// a sink, its own duration included. A task with a larger bottom level has
+// more work waiting behind it, so dispatching it first shortens the
+// makespan when several released tasks tie on priority or deadline.
+//
+// Durations start from the schedule's estimates and are replaced by the
+// measured ones as executions end; the change propagates to the task's
+// (transitive) dependencies only. Tasks on a dependency cycle keep their own
+// duration as bottom level. Not thread-safe: the orchestrator guards it with
+// its mutex.
+class CriticalPath {
+public:
+    // Build the graph from the task table and one duration per handle
+    void build(const TaskTable& tasks, const std::vector<int64_t>& duration_us);
+    
+    // Replace a task's duration (e.g. with a measured one) and update the
+    // bottom levels of the tasks it depends on
+    void update_duration(TaskHandle handle, int64_t duration_us);
+    
+    int64_t bottom_level(TaskHandle handle) const {
+        return handle < bottom_level_us_.size() ? bottom_level_us_[handle] : 0;
+    }
+    int64_t duration(TaskHandle handle) const { return duration_us_[handle]; }
+    
+    // Longest path of the graph: its length and its tasks, source first
+    int64_t length_us() const;
+    std::vector<TaskHandle> path() const;
+    
+    // Critical path of a finished run: from the execution that ended last,
+    // walk back through the dependency whose end released it (the one that
+    // ended last before its start)
+    static std::vector<CriticalPathStep> from_history(const std::vector<TaskExecution>& history,
+                                                      const std::vector<TimelineDependency>& dependencies);
+
+private:
+    // Bottom level from the current duration and dependents
+    int64_t compute(TaskHandle handle) const;
+    
+    std::vector<int64_t> duration_us_;
+    std::vector<int64_t> bottom_level_us_;
+    std::vector<std::vector<TaskHandle>> dependents_;
+    std::vector<std::vector<TaskHandle>> dependencies_;
+    std::vector<uint8_t> in_cycle_;
+    std::vector<uint32_t> order_;     // Topological position, sinks first
+    std::vector<uint8_t> queued_;
+    std::vector<TaskHandle> stack_;   // Propagation heap on order_ (reused)
+};
+
+} // namespace orchestrator
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace orchestrator {
+
+// Measured execution times of one task id
+struct TaskDurationStats {
+    // Recent samples kept for the percentiles
+    static constexpr size_t RECENT_SAMPLES = 64;
+    
+    // Weight of the latest sample in the EWMA (1/8, like the endpoint latency EWMA)
+    static constexpr int EWMA_SHIFT = 3;
+    
+    uint64_t executions = 0;
+    int64_t ewma_us = 0;
+    int64_t min_us = 0;
+    int64_t wcet_us = 0;               // High-water mark over every run
+    std::vector<int64_t> recent_us;    // Ring of the last RECENT_SAMPLES samples
+    size_t next = 0;                   // Ring position of the next sample
+    
+    // Add one sample (does not allocate once the ring is full)
+    void add(int64_t duration_us);
+    
+    // Percentile of the recent samples (0 without samples), p in [0, 100]
+    int64_t percentile(double p) const;
+    
+    // Recent samples, oldest first
+    std::vector<int64_t> samples() const;
+};
+
+// Per-task-id execution time statistics, persisted between runs in a small
+// YAML file:
+//
+//   tasks:
+//     <task id>: {executions: N, ewma_us: .., min_us: .., wcet_us: .., recent_us: [..]}
+//
+// Not thread-safe: the orchestrator guards it with its mutex.
+class DurationStore {
+public:
+    // Load a store written by save(); a missing file is an empty store
+    bool load(const std::string& path);
+    
+    // Write the store (to a temporary file renamed over `path`)
+    bool save(const std::string& path) const;
+    
+    // Statistics of a task id, created empty if unknown. References stay
+    // valid while the store lives (callers keep them per task handle).
+    TaskDurationStats& get(const std::string& task_id) { return tasks_[task_id]; }
+    const TaskDurationStats* find(const std::string& task_id) const;
+    
+    void add(const std::string& task_id, int64_t duration_us) { get(task_id).add(duration_us); }
+    
+    size_t size() const { return tasks_.size(); }
+    const std::unordered_map<std::string, TaskDurationStats>& tasks() const { return tasks_; }
+
+private:
+    std::unordered_map<std::string, TaskDurationStats> tasks_;
+};
+
+} // namespace orchestrator
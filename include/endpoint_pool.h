@@ -0,0 +1,154 @@
+#pragma once
+
+#include "orchestrator.grpc.pb.h"
+#include "shm_transport.h"
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace orchestrator {
+
+using EndpointId = uint32_t;
+constexpr EndpointId INVALID_ENDPOINT = UINT32_MAX;
+
+// Maximum replicas per task considered by select() (tried set is a bitmask)
+constexpr size_t MAX_TASK_REPLICAS = 64;
+
+// Outcome of the startup probe of an endpoint
+struct EndpointReadiness {
+    bool ready = false;
+    int64_t ready_us = -1;     // Time from the start of the probe to the first answer
+    std::string transport;     // "tcp", "uds", "unix" or "shm"
+    std::string error;         // Why the endpoint is not ready
+};
+
+// Pool of task wrapper endpoints (one channel/stub per distinct address).
+// Each endpoint tracks the number of tasks it is running (dispatched but not
+// yet ended), an EWMA of its StartTask latency and, after an UNAVAILABLE
+// error, a cool-down during which it is only used if no healthy replica is
+// left. All counters are atomics: dispatch threads select and update
+// endpoints without taking the orchestrator mutex.
+//
+// An address of the form "shm://<host:port>" names a co-located wrapper:
+// starts go over the shared-memory channel the wrapper advertises in
+// GetTaskStatus, everything else over gRPC at <host:port>. Without a
+// channel the endpoint stays gRPC-only. Loopback TCP endpoints whose wrapper
+// advertises a Unix domain socket are dialed over that socket instead.
+class EndpointPool {
+public:
+    // Unhealthy endpoints are avoided for this long after UNAVAILABLE
+    static constexpr int64_t UNAVAILABLE_COOLDOWN_US = 1000000;
+    
+    // Probe deadline when the startup barrier does not wait
+    static constexpr int DISCOVERY_TIMEOUT_MS = 500;
+    
+    // Reconnection backoff of the wrapper channels (gRPC defaults to 1 s
+    // initial / 120 s max, far too slow for a wrapper started just after
+    // the orchestrator)
+    static constexpr int RECONNECT_BACKOFF_MS = 100;
+    static constexpr int MAX_RECONNECT_BACKOFF_MS = 1000;
+    
+    // Weight of the latest sample in the latency EWMA (1/8)
+    static constexpr int EWMA_SHIFT = 3;
+    
+    // Add an endpoint (returns the existing id if the address is known).
+    // Not thread-safe: endpoints are added while loading the schedule.
+    EndpointId add(const std::string& address);
+    
+    // Remove all endpoints
+    void clear();
+    
+    // Receiver of task ends arriving over shared-memory channels
+    // (set before wait_ready())
+    void set_end_handler(ShmClient::EndHandler handler) { end_handler_ = std::move(handler); }
+    
+    // Startup barrier: probe every endpoint in parallel with GetTaskStatus,
+    // waiting up to timeout_us for its wrapper to come up (0 = a single
+    // attempt each). A co-located wrapper's advertised transports are set up
+    // on the way: its stub is switched to the Unix domain socket and its
+    // shared-memory channel attached. Returns the number of ready endpoints.
+    // Call before dispatching starts.
+    size_t wait_ready(int64_t timeout_us);
+    const EndpointReadiness& readiness(EndpointId id) const { return endpoints_[id]->readiness; }
+    
+    // Shared-memory client of an endpoint; nullptr for gRPC endpoints or
+    // when no channel is available
+    ShmClient* shm(EndpointId id) const { return endpoints_[id]->shm.get(); }
+    
+    // Close every shared-memory channel
+    void disconnect_shm();
+    
+    // Pick the least-loaded replica among `replicas`, skipping quarantined
+    // ones and those whose bit is set in `tried_mask`; returns its index in
+    // `replicas`, or replicas.size() when no replica is left. Load is
+    // (in-flight + 1) * latency EWMA; healthy endpoints always win over
+    // endpoints in cool-down.
+    size_t select(const std::vector<EndpointId>& replicas, uint64_t tried_mask, int64_t now_us) const;
+    
+    // A task was dispatched to / ended on an endpoint (`rt`: under a
+    // real-time policy, see rt_in_flight)
+    void begin(EndpointId id, bool rt = false) {
+        endpoints_[id]->in_flight.fetch_add(1, std::memory_order_relaxed);
+        if (rt) {
+            endpoints_[id]->rt_in_flight.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    void end(EndpointId id, bool rt = false) {
+        endpoints_[id]->in_flight.fetch_sub(1, std::memory_order_relaxed);
+        if (rt) {
+            endpoints_[id]->rt_in_flight.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+    
+    // Record the outcome of a StartTask call
+    void record_success(EndpointId id, int64_t latency_us);
+    void record_unavailable(EndpointId id, int64_t now_us);
+    
+    const std::string& address(EndpointId id) const { return endpoints_[id]->address; }
+    TaskService::Stub* stub(EndpointId id) const { return endpoints_[id]->stub.get(); }
+    int32_t in_flight(EndpointId id) const { return endpoints_[id]->in_flight.load(std::memory_order_relaxed); }
+    int32_t rt_in_flight(EndpointId id) const { return endpoints_[id]->rt_in_flight.load(std::memory_order_relaxed); }
+    int64_t latency_ewma_us(EndpointId id) const { return endpoints_[id]->latency_ewma_us.load(std::memory_order_relaxed); }
+    bool healthy(EndpointId id, int64_t now_us) const {
+        return endpoints_[id]->unavailable_until_us.load(std::memory_order_relaxed) <= now_us;
+    }
+    
+    // Quarantined endpoints (heartbeat lost) are never selected
+    void set_quarantined(EndpointId id, bool quarantined) {
+        endpoints_[id]->quarantined.store(quarantined, std::memory_order_relaxed);
+    }
+    bool quarantined(EndpointId id) const { return endpoints_[id]->quarantined.load(std::memory_order_relaxed); }
+    size_t size() const { return endpoints_.size(); }
+
+private:
+    struct Endpoint {
+        std::string address;
+        std::string grpc_address;   // address without the shm:// scheme
+        std::unique_ptr<TaskService::Stub> stub;
+        std::shared_ptr<grpc::Channel> channel;
+        bool shm_requested = false;
+        EndpointReadiness readiness;
+        std::unique_ptr<ShmClient> shm;
+        std::atomic<int32_t> in_flight{0};
+        std::atomic<int32_t> rt_in_flight{0};           // Of which under a real-time policy
+        std::atomic<int64_t> latency_ewma_us{0};       // 0 = no sample yet
+        std::atomic<int64_t> unavailable_until_us{0};
+        std::atomic<bool> quarantined{false};
+    };
+    
+    // Probe one endpoint until `deadline` (wait_ready worker)
+    void probe(Endpoint& endpoint, std::chrono::system_clock::time_point deadline, bool wait);
+    
+    static std::shared_ptr<grpc::Channel> make_channel(const std::string& address);
+    
+    std::vector<std::unique_ptr<Endpoint>> endpoints_;
+    std::unordered_map<std::string, EndpointId> index_;
+    ShmClient::EndHandler end_handler_;
+};
+
+} // namespace orchestrator
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "task_table.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace orchestrator {
+
+// Fixed-capacity ring of the most recent executions.
+// Writes never allocate and overwrite the oldest entry once the ring is full.
+// Readers never block the writer: each slot is guarded by a sequence number
+// (seqlock), and a snapshot simply skips slots that were overwritten while
+// being copied. Writers must be serialized by the caller (the orchestrator
+// pushes under its own mutex).
+class ExecutionHistory {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+    
+    explicit ExecutionHistory(size_t capacity = DEFAULT_CAPACITY);
+    
+    // Drop all entries and resize the ring (not safe against concurrent readers)
+    void reset(size_t capacity);
+    
+    // Append a record (single writer at a time)
+    void push(const ExecutionRecord& record);
+    
+    // Copy the retained records into `out`, oldest first (lock-free)
+    void snapshot(std::vector<ExecutionRecord>& out) const;
+    
+    // Number of records ever pushed since the last reset
+    uint64_t total() const { return head_.load(std::memory_order_acquire); }
+    
+    // Number of records currently retained
+    size_t size() const;
+    
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;  // 2*pos+1 while writing, 2*pos+2 when complete
+        ExecutionRecord record;
+    };
+    
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_;
+    std::atomic<uint64_t> head_;
+};
+
+} // namespace orchestrator
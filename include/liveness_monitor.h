@@ -0,0 +1,81 @@
+#pragma once
+
+#include "endpoint_pool.h"
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace orchestrator {
+
+// Wrapper liveness from heartbeat streams.
+// One Heartbeat stream per endpoint (a reader thread each) plus a watchdog
+// thread. An endpoint is declared down when its stream breaks (process gone,
+// connection reset) or when no beat arrived for `missed_beats` intervals;
+// it is quarantined in the EndpointPool until beats resume. Endpoints whose
+// wrapper does not implement Heartbeat are left unmonitored. The silence
+// window is suspended while a real-time task is in flight on the endpoint
+// (EndpointPool::rt_in_flight) or the last beat reported a real-time
+// callback: on a shared CPU the callback may starve the beat writer. A
+// broken stream still declares the endpoint down.
+class LivenessMonitor {
+public:
+    // Called on every up/down transition (from a monitor thread)
+    using StateHandler = std::function<void(EndpointId id, bool alive)>;
+    
+    static constexpr int DEFAULT_MISSED_BEATS = 3;
+    
+    LivenessMonitor(EndpointPool& pool, StateHandler on_change);
+    ~LivenessMonitor();
+    
+    // Open a stream to every endpoint of the pool (endpoints are not added
+    // while the monitor runs)
+    void start(int64_t interval_us, int missed_beats = DEFAULT_MISSED_BEATS);
+    void stop();
+    
+    bool is_running() const { return running_; }
+    
+    // Beats received so far from an endpoint
+    uint64_t beats(EndpointId id) const { return peers_[id]->beats.load(std::memory_order_relaxed); }
+
+private:
+    enum PeerState { PEER_UNKNOWN, PEER_ALIVE, PEER_DOWN };
+    
+    struct Peer {
+        std::atomic<int64_t> last_beat_us{0};
+        std::atomic<uint64_t> beats{0};
+        std::atomic<bool> rt_execution{false};  // Reported by the last beat
+        PeerState state = PEER_UNKNOWN;       // Guarded by mutex_
+        grpc::ClientContext* stream = nullptr; // Open stream (guarded by mutex_)
+        std::thread reader;
+    };
+    
+    void reader_loop(EndpointId id);
+    void watchdog_loop();
+    
+    // Record a transition; the handler runs outside the lock
+    void set_state(EndpointId id, PeerState state, const char* reason);
+    
+    // Sleep up to timeout_us, returning early on stop()
+    void wait(int64_t timeout_us);
+    
+    static int64_t now_us();
+    
+    EndpointPool& pool_;
+    StateHandler on_change_;
+    std::vector<std::unique_ptr<Peer>> peers_;
+    std::thread watchdog_;
+    std::atomic<bool> running_;
+    int64_t interval_us_;
+    int64_t window_us_;
+    
+    std::mutex mutex_;
+    std::condition_variable stop_cv_;
+};
+
+} // namespace orchestrator
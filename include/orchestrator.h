@@ -3,7 +3,18 @@
 #include "schedule.h"
 #include "orchestrator.grpc.pb.h"
 #include "rt_utils.h"
+#include "task_table.h"
+#include "execution_history.h"
+#include "trace_file.h"
+#include "endpoint_pool.h"
+#include "release_queue.h"
+#include "liveness_monitor.h"
+#include "perf_counters.h"
+#include "critical_path.h"
+#include "duration_store.h"
+#include "result_cache.h"
 #include <grpcpp/grpcpp.h>
+#include <google/protobuf/arena.h>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -23,6 +34,21 @@ struct TaskExecution {
     TaskState state;
     TaskResult result;
     std::string error_message;
+    std::string task_address;  // Wrapper that ran the task
+    TaskTimeline timeline;     // Per-phase timestamps (see TaskTimeline)
+};
+
+// Learned execution times of a task id against its declared estimate
+struct TaskDurationReport {
+    // Estimates off by more than this factor (either way) are flagged
+    static constexpr double MISESTIMATE_FACTOR = 2.0;
+    
+    std::string task_id;
+    int64_t declared_us;       // ScheduledTask::estimated_duration_us
+    bool declared;             // false: the parser's default estimate
+    TaskDurationStats stats;   // Every run so far, this one included
+    uint32_t overruns;         // Executions of this run over their budget
+    bool misestimated;
 };
 
 // Orchestrator service implementation (receives task end notifications)
@@ -35,6 +61,11 @@ public:
         const TaskEndNotification* request,
         TaskEndResponse* response) override;
     
+    grpc::Status NotifyTaskEnds(
+        grpc::ServerContext* context,
+        const TaskEndBatch* request,
+        TaskEndResponse* response) override;
+    
     grpc::Status HealthCheck(
         grpc::ServerContext* context,
         const HealthCheckRequest* request,
@@ -56,8 +87,59 @@ public:
     // Set real-time configuration for orchestrator threads
     void set_rt_config(const RTConfig& config);
     
-    // Start the orchestrator (begins scheduling tasks)
-    void start();
+    // Order of released tasks waiting for dispatch (default: priority)
+    void set_dispatch_order(DispatchOrder order);
+    
+    // Break dispatch priority/deadline ties by bottom level (longest path
+    // to a sink, from estimated_duration_us refined by measured durations;
+    // default: enabled)
+    void set_critical_path_priority(bool enabled) { critical_path_priority_ = enabled; }
+    
+    // Learn per-task-id execution times (EWMA, recent percentiles, WCET) in
+    // a file kept between runs: loaded here, saved on stop (set before
+    // load_schedule). Learned durations replace the declared estimates for
+    // dispatch tie-breaks and wrapper cgroup sizing, and a watchdog warns
+    // about executions running past budget_margin * WCET.
+    bool set_duration_store(const std::string& path, double budget_margin = DEFAULT_BUDGET_MARGIN);
+    
+    // Learned execution times of the schedule's tasks (needs a duration store)
+    std::vector<TaskDurationReport> get_duration_report() const;
+    
+    // Complete tasks marked cacheable from a content-addressed store of
+    // earlier successful results in `directory` (see ResultCache), when
+    // their parameters and dependency outputs are unchanged. Call before
+    // load_schedule()
+    bool set_result_cache(const std::string& directory);
+    
+    // Maximum number of concurrent StartTask RPCs (set before start)
+    void set_max_inflight_dispatches(size_t max_inflight);
+    
+    // Send up to max_batch released tasks bound to the same single wrapper
+    // in one StartTasks RPC (1 = one StartTask per task, the default)
+    void set_start_batching(size_t max_batch);
+    
+    // Pre-arm TIMED tasks: send them lead_us ahead of their scheduled time
+    // with an absolute release time, and let the wrapper release them
+    // locally (0 = disabled, the default; set before start)
+    void set_prearm_lead(int64_t lead_us);
+    
+    // Also listen on a Unix domain socket at `path`, so co-located wrappers
+    // can send end notifications to "unix:<path>" (set before start)
+    void set_uds_path(const std::string& path);
+    
+    // Heartbeat-based failure detection (0 = disabled, the default; set
+    // before start): a wrapper silent for missed_beats intervals, or whose
+    // stream breaks, is quarantined and its running tasks are marked FAILED
+    void set_heartbeat(int64_t interval_us, int missed_beats = LivenessMonitor::DEFAULT_MISSED_BEATS);
+    
+    // How long start() waits for the wrappers to answer (0 = a single
+    // attempt each; set before start)
+    void set_ready_timeout(int64_t timeout_us);
+    
+    // Start the orchestrator: bring up the gRPC server, wait until every
+    // wrapper answers (or the ready timeout expires), then begin scheduling
+    // with t=0 at that point. False if the server could not listen.
+    bool start();
     
     // Stop the orchestrator
     void stop();
@@ -65,9 +147,32 @@ public:
     // Wait for all tasks to complete
     void wait_for_completion();
     
-    // Get execution statistics
+    // Number of recent executions kept in memory (default 4096; set before load_schedule)
+    void set_history_capacity(size_t capacity);
+    
+    // Stream every finished execution to a binary trace file (set before start)
+    void set_trace_file(const std::string& path);
+    
+    // Get execution statistics (the most recent executions, oldest first)
     std::vector<TaskExecution> get_execution_history() const;
     
+    // Write the execution history as a Chrome Trace / Perfetto JSON timeline
+    bool export_timeline(const std::string& path) const;
+    
+    // Critical path of the run: the dependency chain that ended last
+    std::vector<CriticalPathStep> get_critical_path() const;
+    
+    // perf counters reported by the wrappers, aggregated per task id (tasks
+    // whose wrapper measured nothing are left out)
+    std::vector<TaskPerfStats> get_perf_stats() const;
+    
+    // Total number of executions recorded, including those no longer in the history
+    uint64_t get_execution_count() const { return history_.total(); }
+    
+    // Heap allocations made while preparing dispatches (see AllocCounter)
+    uint64_t get_dispatch_allocations() const { return dispatch_allocations_; }
+    uint64_t get_dispatch_count() const { return dispatch_count_; }
+    
     // Called by service when task ends
     void on_task_end(const TaskEndNotification& notification);
     
@@ -81,8 +186,97 @@ private:
     // Scheduler thread function
     void scheduler_loop();
     
+    // Release thread: queues timed tasks at their scheduled time
+    void release_loop();
+    
+    // Queue a released task for the dispatch workers (mutex_ held)
+    void release_task(size_t task_index, int64_t release_time_us);
+    
+    // Dispatch worker: sends the start of queued tasks in queue order
+    void dispatch_loop();
+    
     // Execute a scheduled task (send start command via gRPC)
-    void execute_task(const ScheduledTask& task);
+    void execute_task(size_t task_index);
+    
+    // Start several tasks bound to the same wrapper with one StartTasks RPC;
+    // tasks the wrapper rejects fall back to execute_task
+    void execute_task_batch(const std::vector<size_t>& batch);
+    
+    // Whether `next` can join a StartTasks batch opened by `first`
+    bool batchable(size_t first, size_t next) const;
+    
+    // Reset the runtime state of a task about to be dispatched (mutex_ held)
+    void begin_dispatch(TaskHandle handle, int64_t dispatch_time_us);
+    
+    // Build the StartTaskRequest of every task and the stubs they use
+    void build_dispatch_cache();
+    
+    // Cancel the armed starts that were not released (on stop)
+    void disarm_pending_tasks();
+    
+    // Liveness transition of an endpoint: on loss, cancel the starts in
+    // flight to it and fail the tasks it was running
+    void on_endpoint_state(EndpointId endpoint, bool alive);
+    
+    // Record a dispatched task that will never send its end (mutex_ held)
+    void abandon_task(TaskHandle handle, const std::string& reason);
+    
+    // Expected execution time: the learned EWMA, else `measured_us` (if
+    // set), else the declared estimate (mutex_ held)
+    int64_t expected_duration_us(TaskHandle handle, int64_t measured_us = 0) const;
+    
+    // Watchdog thread: flags running tasks past their budget. Only the
+    // tasks in watched_ are scanned; the report is written after unlocking
+    void watchdog_loop();
+    
+    // Add a measured duration to the task's statistics, flag an overrun the
+    // watchdog missed and refresh its budget (mutex_ held)
+    void learn_duration(TaskHandle handle, int64_t duration_us);
+    
+    // Output passing (mutex_ held). attach_inputs puts the latest outputs of
+    // the task's dependencies into its start request and references their
+    // shared-memory buffers until release_inputs (the task ended or failed).
+    void attach_inputs(TaskHandle handle, StartTaskRequest& request);
+    void release_inputs(TaskHandle handle);
+    
+    // Copy the shared-memory inputs of a request into inline values, for a
+    // wrapper on another host (the references taken by attach_inputs keep
+    // the segments alive; mutex_ not held)
+    void inline_inputs(StartTaskRequest& request);
+    
+    // Keep the outputs of a finished execution for the task's dependents,
+    // replacing the previous ones (mutex_ held). `digest` is the
+    // ResultCache::digest of what the dependents will read, computed by the
+    // caller before taking mutex_ (unused unless the task feeds a cacheable one)
+    void store_outputs(TaskHandle handle, const TaskEndNotification& notification, uint64_t digest);
+    
+    // Whether the dependents of a finished execution get its outputs
+    bool keeps_outputs(TaskHandle handle, TaskResult result) const;
+    
+    // Result cache key of a cacheable task from its parameters and the
+    // digests of its dependencies' outputs (mutex_ held)
+    uint64_t result_cache_key(size_t task_index) const;
+    
+    // Complete a task from a cached result instead of starting it
+    void complete_from_cache(size_t task_index, CachedResult& result);
+    
+    // Drop the producer's own reference to its shared-memory outputs
+    void release_producer_outputs(TaskHandle producer);
+    
+    // Drop one reference to a shared-memory output; the last one unlinks it
+    void release_output(const std::string& segment);
+    
+    // Unlink every shared-memory output still referenced (load, stop)
+    void release_all_outputs();
+    
+    // Every (task, dependency) pair of the schedule
+    std::vector<TimelineDependency> schedule_dependencies() const;
+    
+    // Append a finished execution to the history and the trace (mutex_ held)
+    void record_execution(TaskHandle handle);
+    
+    // Add the "perf.*" metrics of an end notification to the task's aggregate (mutex_ held)
+    void record_perf_metrics(TaskHandle handle, const TaskEndNotification& notification);
     
     // Get current time in microseconds
     int64_t get_current_time_us() const;
@@ -91,24 +285,114 @@ private:
     std::unique_ptr<grpc::Server> server_;
     std::unique_ptr<OrchestratorServiceImpl> service_;
     std::string listen_address_;
+    std::string uds_address_;   // Additional "unix:" listener (empty = none)
     
     // Schedule data
     TaskSchedule schedule_;
     size_t next_task_index_;
     int64_t start_time_us_;
+    int64_t start_system_time_us_;  // System clock at start_time_us_ (armed release times)
     
     // Threading
     std::atomic<bool> running_;
     std::thread scheduler_thread_;
     std::thread server_thread_;
+    std::thread release_thread_;
+    std::vector<std::thread> dispatch_threads_;
     
-    // Task tracking
+    // Task tracking (runtime state indexed by interned task handle)
     mutable std::mutex mutex_;
-    std::unordered_map<std::string, TaskExecution> active_tasks_;
-    std::vector<TaskExecution> completed_tasks_;
-    std::unordered_map<std::string, bool> task_completed_;  // Track completed tasks for dependencies
+    std::mutex stop_mutex_;
+    TaskTable tasks_;
+    std::vector<TaskHandle> schedule_handles_;  // Handle of each entry in schedule_.tasks
+    
+    // Recent executions (lock-free reads) and the optional on-disk trace
+    size_t history_capacity_;
+    ExecutionHistory history_;
+    std::string trace_path_;
+    TraceWriter trace_;
+    
+    // Bottom levels of the dependency graph (guarded by mutex_)
+    CriticalPath critical_path_;
+    bool critical_path_priority_;
+    
+    // Learned execution times and watchdog budgets, by TaskHandle (guarded by mutex_)
+    static constexpr double DEFAULT_BUDGET_MARGIN = 1.2;
+    static constexpr uint64_t MIN_BUDGET_SAMPLES = 3;   // Executions before a budget applies
+    static constexpr int WATCHDOG_INTERVAL_MS = 10;
+    DurationStore durations_;
+    std::string duration_store_path_;
+    double budget_margin_;
+    std::vector<TaskDurationStats*> duration_stats_;    // nullptr without a store
+    std::vector<int64_t> declared_duration_us_;
+    std::vector<uint8_t> duration_declared_;
+    std::vector<int64_t> budget_us_;                    // 0 = no budget
+    std::vector<uint8_t> over_budget_;                  // Current execution already flagged
+    std::vector<TaskHandle> watched_;                   // Dispatched tasks with a budget
+    std::vector<uint8_t> is_watched_;
+    std::vector<uint32_t> overruns_;
+    std::thread watchdog_thread_;
+    std::condition_variable watchdog_cv_;
+    
+    // Outputs passed to dependents, by TaskHandle (guarded by mutex_): the
+    // latest outputs of each task, the dependents that have not taken them
+    // yet (the producer holds a reference until then) and the shared-memory
+    // outputs referenced by each dispatched consumer
+    std::vector<std::vector<TaskOutput>> task_outputs_;
+    std::vector<std::vector<TaskHandle>> waiting_consumers_;
+    std::vector<std::vector<std::string>> held_inputs_;
+    std::unordered_map<std::string, uint32_t> output_refs_;   // Segment -> references
+    
+    // Result cache: digest of the outputs each task passed on, whether a
+    // cacheable task reads them, and the key of each cacheable task's
+    // current dispatch (0 = not cached), guarded by mutex_
+    ResultCache result_cache_;
+    std::vector<uint64_t> output_digest_;
+    std::vector<uint8_t> feeds_cacheable_;
+    std::vector<uint64_t> cache_key_;
+    
+    // perf counter aggregates indexed by TaskHandle (guarded by mutex_)
+    std::vector<TaskPerfStats> perf_stats_;
+    
+    // Dispatch cache: one pre-built request per schedule entry (on an arena),
+    // and the replica endpoints each entry can be dispatched to
+    std::unique_ptr<google::protobuf::Arena> request_arena_;
+    std::vector<StartTaskRequest*> start_requests_;
+    std::vector<ArmTaskRequest*> arm_requests_;  // TIMED entries (wrapping their start request), else nullptr
+    EndpointPool endpoints_;
+    std::vector<std::vector<EndpointId>> task_endpoints_;
+    std::vector<uint8_t> remote_replicas_;   // Per entry: a replica does not share /dev/shm with us
+    std::vector<uint8_t> rt_task_;           // Per handle: requests a real-time policy
+    std::atomic<uint64_t> dispatch_allocations_;
+    std::atomic<uint64_t> dispatch_count_;
+    
+    // Wrapper heartbeats
+    LivenessMonitor liveness_;
+    int64_t heartbeat_interval_us_;
+    int heartbeat_missed_beats_;
+    
+    // Startup readiness barrier
+    static constexpr int64_t DEFAULT_READY_TIMEOUT_US = 5000000;
+    int64_t ready_timeout_us_;
+    
+    // Release queue and dispatch worker pool
+    static constexpr size_t DEFAULT_MAX_INFLIGHT_DISPATCHES = 8;
+    ReleaseQueue release_queue_;
+    size_t max_inflight_dispatches_;
+    struct ActiveDispatch {
+        grpc::ClientContext* context;
+        EndpointId endpoint;
+    };
+    std::vector<ActiveDispatch> active_dispatches_;  // StartTask RPCs in flight (cancelled by stop())
+    size_t max_start_batch_;
+    
+    // Pre-armed timed starts
+    int64_t prearm_lead_us_;
+    std::vector<size_t> armed_tasks_;  // Armed on a wrapper and not yet ended
     
     // Synchronization
+    std::condition_variable release_cv_;
+    std::condition_variable dispatch_cv_;
     std::condition_variable completion_cv_;
     std::condition_variable task_end_cv_;  // For sequential execution
     std::atomic<int> pending_tasks_;
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+namespace orchestrator {
+
+// Counters measured around a task callback
+enum PerfCounter {
+    // Software (kernel) counters, available wherever perf_event_open is
+    PERF_TASK_CLOCK_NS = 0,
+    PERF_CONTEXT_SWITCHES,
+    PERF_CPU_MIGRATIONS,
+    PERF_PAGE_FAULTS,
+    // Hardware (PMU) counters, often missing in VMs and containers
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+};
+
+// Counter values of one execution
+struct PerfSample {
+    int64_t values[PERF_COUNTER_COUNT];
+    bool valid[PERF_COUNTER_COUNT];
+};
+
+// Aggregate of one counter over the executions of a task
+struct PerfCounterStats {
+    uint64_t samples = 0;
+    int64_t sum = 0;
+    int64_t min = 0;
+    int64_t max = 0;
+    
+    void add(int64_t value) {
+        min = samples == 0 || value < min ? value : min;
+        max = samples == 0 || value > max ? value : max;
+        sum += value;
+        samples++;
+    }
+    
+    double mean() const { return samples > 0 ? static_cast<double>(sum) / samples : 0.0; }
+};
+
+// Counters of every measured execution of one task id (orchestrator side)
+struct TaskPerfStats {
+    std::string task_id;
+    uint64_t executions = 0;   // Executions that reported perf metrics
+    PerfCounterStats counters[PERF_COUNTER_COUNT];
+};
+
+// perf_event_open counters of the calling thread (wrapper side).
+// Software and hardware counters form two groups, each read with a single
+// read() at begin() and end(); hardware counters are scaled when the PMU
+// multiplexed them. A group that cannot be opened (no PMU, restrictive
+// perf_event_paranoid, seccomp) is skipped and its counters are reported
+// as invalid. Counters follow one thread: begin() reopens them when called
+// from a different thread than the previous execution.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    
+    // Snapshot the counters of the calling thread; false if none is available
+    bool begin();
+    
+    // Counter deltas since begin() (same thread)
+    void end(PerfSample& sample);
+    
+    bool software_available() const { return groups_[0].leader >= 0; }
+    bool hardware_available() const { return groups_[1].leader >= 0; }
+    
+    // Key of a counter in TaskEndNotification.metrics ("perf.<name>")
+    static const char* metric_name(PerfCounter counter);
+    
+    // Counter of a metrics key (false for other metrics)
+    static bool parse_metric(const std::string& key, PerfCounter& counter);
+
+private:
+    // Values read with PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING
+    struct GroupValues {
+        uint64_t nr;
+        uint64_t time_enabled;
+        uint64_t time_running;
+        uint64_t values[PERF_COUNTER_COUNT];
+    };
+    
+    struct Group {
+        int leader = -1;
+        int fds[PERF_COUNTER_COUNT];
+        int first = 0;    // First PerfCounter of the group
+        int count = 0;    // Counters opened (members that failed are skipped)
+        int counters[PERF_COUNTER_COUNT];  // PerfCounter of each opened member
+        GroupValues before;
+    };
+    
+    void open(pid_t tid);
+    void open_group(Group& group, uint32_t type, const uint64_t* configs, int first, int count);
+    void close_all();
+    static bool read_group(const Group& group, GroupValues& values);
+    
+    Group groups_[2];   // Software, hardware
+    pid_t tid_;         // Thread the counters are attached to (0 = none)
+    bool warned_;
+};
+
+} // namespace orchestrator
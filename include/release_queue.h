@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace orchestrator {
+
+// Order in which released tasks are handed to the dispatch workers
+enum DispatchOrder {
+    DISPATCH_ORDER_FIFO,       // Release order
+    DISPATCH_ORDER_PRIORITY,   // Highest ScheduledTask::priority first
+    DISPATCH_ORDER_EDF         // Earliest absolute deadline first
+};
+
+// A task whose start is due (times relative to orchestrator start)
+struct ReleasedTask {
+    size_t task_index;              // Entry in the schedule
+    int64_t release_time_us;
+    int64_t absolute_deadline_us;   // release time + ScheduledTask::deadline_us
+    int32_t priority;
+    int64_t bottom_level_us;        // Longest path to a sink (see CriticalPath; 0 = unknown)
+    uint64_t sequence;              // Release order (assigned by push)
+};
+
+// Queue of released tasks waiting for a dispatch worker.
+// A binary heap on a vector reserved up front, so push/pop do not allocate
+// once the queue has held a whole schedule. Priority and deadline ties go to
+// the task with the larger bottom level (more work behind it), then to
+// release order.
+// Not thread-safe: the orchestrator guards it with its mutex.
+class ReleaseQueue {
+public:
+    explicit ReleaseQueue(DispatchOrder order = DISPATCH_ORDER_PRIORITY);
+    
+    // Change the ordering (only while the queue is empty)
+    void set_order(DispatchOrder order) { order_ = order; }
+    DispatchOrder order() const { return order_; }
+    
+    void reserve(size_t capacity) { heap_.reserve(capacity); }
+    void push(ReleasedTask task);
+    ReleasedTask pop();
+    const ReleasedTask& top() const { return heap_.front(); }
+    void clear();
+    
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+    
+    // Convert dispatch order to/from its name ("fifo", "priority", "edf")
+    static DispatchOrder string_to_order(const std::string& name);
+    static std::string order_to_string(DispatchOrder order);
+
+private:
+    // Heap comparator: true if `a` should be dispatched after `b`
+    bool after(const ReleasedTask& a, const ReleasedTask& b) const;
+    
+    DispatchOrder order_;
+    std::vector<ReleasedTask> heap_;
+    uint64_t next_sequence_;
+};
+
+} // namespace orchestrator
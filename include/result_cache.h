@@ -0,0 +1,65 @@
+#pragma once
+
+#include "orchestrator.pb.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace orchestrator {
+
+// Content-addressed store of successful task results, one file per entry
+// (<directory>/<key as 16 hex digits>.result, a serialized CachedResult).
+//
+// The key hashes everything a task reads: its id, its parameters and the
+// digest of the outputs each dependency passed on. A task whose key is
+// found is completed from the entry instead of being executed. The key does
+// not cover the task's code: clear the directory after changing it.
+//
+// lookup, store and restore_outputs may run concurrently (entries are
+// written aside and renamed into place); open before using it.
+class ResultCache {
+public:
+    ResultCache();
+    
+    // Use `directory` (created if missing)
+    bool open(const std::string& directory);
+    bool is_open() const { return !directory_.empty(); }
+    const std::string& directory() const { return directory_; }
+    
+    // Key of an execution: (dependency id, output digest) pairs in dependency order
+    static uint64_t key(const std::string& task_id, const std::map<std::string, std::string>& parameters,
+                        const std::vector<std::pair<std::string, uint64_t>>& inputs);
+    
+    // Digest of a set of outputs (independent of their order); shared-memory
+    // values are read through their segment
+    static uint64_t digest(const google::protobuf::RepeatedPtrField<TaskOutput>& outputs);
+    
+    // Entry of a key; false on a miss
+    bool lookup(uint64_t key, const std::string& task_id, CachedResult& result);
+    
+    // Record a successful execution (shared-memory outputs are copied in)
+    bool store(uint64_t key, const std::string& task_id, int64_t execution_duration_us,
+               const google::protobuf::RepeatedPtrField<TaskOutput>& outputs);
+    
+    // Move the values of a hit that are too large to travel inline into
+    // fresh shared-memory outputs, as a wrapper would have published them
+    bool restore_outputs(google::protobuf::RepeatedPtrField<TaskOutput>& outputs);
+    
+    uint64_t hits() const { return hits_.load(); }
+    uint64_t misses() const { return misses_.load(); }
+    uint64_t stores() const { return stores_.load(); }
+
+private:
+    std::string entry_path(uint64_t key) const;
+    
+    std::string directory_;
+    std::atomic<uint64_t> output_sequence_;   // Names the restored shared-memory outputs
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> stores_;
+};
+
+} // namespace orchestrator
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "rt_utils.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace orchestrator {
+
+// Pre-faulted bump allocator for task callbacks.
+// The whole pool is mapped and touched up front (optionally on huge pages),
+// so allocations during an execution never page-fault or enter the kernel.
+// Memory is released all at once with reset() between executions; deallocate()
+// only rewinds when it frees the last block. When the pool is exhausted
+// allocations fall back to the heap and are counted as overflows.
+//
+// The wrapper installs its pool as the thread's current() pool around the
+// callback; RTPoolAllocator picks it up so STL containers can use it.
+class RTMemoryPool {
+public:
+    RTMemoryPool(size_t capacity, HugePageMode huge_pages = HUGE_PAGES_NONE);
+    ~RTMemoryPool();
+    
+    RTMemoryPool(const RTMemoryPool&) = delete;
+    RTMemoryPool& operator=(const RTMemoryPool&) = delete;
+    
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    void deallocate(void* ptr, size_t size);
+    
+    // Release every allocation (fallback blocks must have been deallocated)
+    void reset();
+    
+    bool owns(const void* ptr) const {
+        return ptr >= base_ && ptr < base_ + capacity_;
+    }
+    
+    bool valid() const { return base_ != nullptr; }
+    bool huge_pages() const { return huge_; }
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return offset_; }
+    size_t high_water() const { return high_water_; }
+    uint64_t overflows() const { return overflows_; }  // Heap fallbacks since reset()
+    
+    // Pool of the calling thread (nullptr outside an execution)
+    static RTMemoryPool* current();
+    static void set_current(RTMemoryPool* pool);
+
+private:
+    char* base_;
+    size_t capacity_;
+    size_t offset_;
+    size_t high_water_;
+    uint64_t overflows_;
+    bool huge_;
+};
+
+// STL allocator drawing from the thread's current pool (heap without one)
+template <typename T>
+class RTPoolAllocator {
+public:
+    using value_type = T;
+    
+    RTPoolAllocator() noexcept : pool_(RTMemoryPool::current()) {}
+    explicit RTPoolAllocator(RTMemoryPool* pool) noexcept : pool_(pool) {}
+    template <typename U>
+    RTPoolAllocator(const RTPoolAllocator<U>& other) noexcept : pool_(other.pool()) {}
+    
+    T* allocate(size_t n) {
+        if (pool_) {
+            return static_cast<T*>(pool_->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    
+    void deallocate(T* ptr, size_t n) noexcept {
+        if (pool_) {
+            pool_->deallocate(ptr, n * sizeof(T));
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+    
+    RTMemoryPool* pool() const noexcept { return pool_; }
+
+private:
+    RTMemoryPool* pool_;
+};
+
+template <typename T, typename U>
+bool operator==(const RTPoolAllocator<T>& a, const RTPoolAllocator<U>& b) noexcept {
+    return a.pool() == b.pool();
+}
+
+template <typename T, typename U>
+bool operator!=(const RTPoolAllocator<T>& a, const RTPoolAllocator<U>& b) noexcept {
+    return a.pool() != b.pool();
+}
+
+} // namespace orchestrator
@@ -2,7 +2,15 @@
 #define RT_UTILS_H
 
 #include <string>
+#include <cstdint>
+#include <memory>
 #include <pthread.h>
+#include <sched.h>
+
+namespace grpc {
+class Server;
+class ServerBuilder;
+}
 
 namespace orchestrator {
 
@@ -16,6 +24,24 @@ enum RTSchedulingPolicy {
     RT_POLICY_DEADLINE = 3   // SCHED_DEADLINE (Linux 3.14+)
 };
 
+/**
+ * NUMA memory placement of a thread pinned to CPUs
+ */
+enum NumaPolicy {
+    NUMA_POLICY_NONE = 0,       // Kernel default (first touch)
+    NUMA_POLICY_PREFERRED = 1,  // Prefer the nodes of the CPUs, fall back to others
+    NUMA_POLICY_BIND = 2        // Only the nodes of the CPUs
+};
+
+/**
+ * Page size backing pre-reserved memory
+ */
+enum HugePageMode {
+    HUGE_PAGES_NONE = 0,         // Base pages
+    HUGE_PAGES_TRANSPARENT = 1,  // madvise(MADV_HUGEPAGE), kernel THP
+    HUGE_PAGES_EXPLICIT = 2      // MAP_HUGETLB from the hugetlbfs pool (falls back to THP)
+};
+
 /**
  * Real-time configuration parameters
  */
@@ -23,17 +49,60 @@ struct RTConfig {
     RTSchedulingPolicy policy;
     int priority;              // Priority: 1-99 (99 = highest)
     int cpu_affinity;          // CPU core to bind to (-1 = no affinity)
+    std::string cpu_list;      // CPUs to bind to, e.g. "2-5,8" (overrides cpu_affinity)
+    NumaPolicy numa_policy;    // Memory placement on the nodes of the bound CPUs
     bool lock_memory;          // Lock all memory pages
     bool prefault_stack;       // Pre-fault stack to avoid page faults
     size_t stack_size;         // Thread stack size (0 = default)
     
+    // RT memory profile (process-wide, see RTUtils::apply_memory_profile)
+    bool tune_malloc;          // Never trim the heap or mmap() allocations, one arena
+    size_t heap_reserve_bytes; // Heap pre-touched at startup (0 = none)
+    size_t pool_bytes;         // RTMemoryPool for task callbacks (0 = none)
+    HugePageMode huge_pages;   // Backing of the heap reserve and the pool
+    
+    // gRPC's own threads
+    int grpc_pollers;                  // Sync server polling threads (0 = gRPC default)
+    int grpc_max_threads;              // Cap on server threads via ResourceQuota (0 = none);
+                                       // a wrapper adds one per Heartbeat stream it serves
+    RTSchedulingPolicy grpc_policy;    // Policy of the threads running the RPC handlers
+    int grpc_priority;                 // Their priority (1-99)
+    uint64_t housekeeping_cpu_mask;    // CPUs of gRPC's timer/executor/event engine
+                                       // threads (bit n = CPU n, 0 = any)
+    
     RTConfig()
         : policy(RT_POLICY_NONE)
         , priority(50)
         , cpu_affinity(-1)
+        , numa_policy(NUMA_POLICY_NONE)
         , lock_memory(false)
         , prefault_stack(false)
-        , stack_size(0) {}
+        , stack_size(0)
+        , tune_malloc(false)
+        , heap_reserve_bytes(0)
+        , pool_bytes(0)
+        , huge_pages(HUGE_PAGES_NONE)
+        , grpc_pollers(0)
+        , grpc_max_threads(0)
+        , grpc_policy(RT_POLICY_NONE)
+        , grpc_priority(49)
+        , housekeeping_cpu_mask(0) {}
+    
+    // CPUs to bind to as a CPU list ("" = no affinity)
+    std::string cpus() const {
+        return !cpu_list.empty() ? cpu_list : cpu_affinity >= 0 ? std::to_string(cpu_affinity) : "";
+    }
+    
+    // True if any gRPC thread setting differs from gRPC's defaults
+    bool configures_grpc() const {
+        return grpc_pollers > 0 || grpc_max_threads > 0 ||
+               grpc_policy != RT_POLICY_NONE || housekeeping_cpu_mask != 0;
+    }
+    
+    // True if any RT memory profile setting is requested
+    bool configures_memory() const {
+        return tune_malloc || heap_reserve_bytes > 0 || pool_bytes > 0;
+    }
 };
 
 /**
@@ -60,6 +129,56 @@ public:
      */
     static void prefault_stack(size_t size = 8 * 1024 * 1024);
     
+    /**
+     * Apply the RT memory profile of a configuration once per process:
+     * tune glibc malloc (M_TRIM_THRESHOLD, M_MMAP_MAX, M_ARENA_MAX) so freed
+     * memory stays in the heap, then pre-touch heap_reserve_bytes of it.
+     * Heap growth at runtime then reuses already faulted pages.
+     * Call it before any other thread allocates (M_ARENA_MAX only binds
+     * arenas created afterwards); later calls do nothing.
+     * @param config Real-time configuration
+     * @return true on success, false on failure
+     */
+    static bool apply_memory_profile(const RTConfig& config);
+    
+    /**
+     * Keep freed memory in the heap: no trimming, no mmap()-backed
+     * allocations, a single arena (so every thread reuses the reserve)
+     * @return true on success, false on failure
+     */
+    static bool tune_malloc();
+    
+    /**
+     * Allocate, touch and free `bytes` of heap (needs tune_malloc() to stay
+     * resident)
+     * @param bytes Reserve size
+     * @param huge_pages Ask for transparent huge pages on the reserve
+     */
+    static void reserve_heap(size_t bytes, HugePageMode huge_pages);
+    
+    /**
+     * Map and pre-touch anonymous memory
+     * @param bytes Size (rounded up to the page size used)
+     * @param huge_pages Page size requested
+     * @param mapped_bytes Receives the mapped size
+     * @param huge Receives whether huge pages back the mapping
+     * @return The mapping, nullptr on failure
+     */
+    static void* map_prefaulted(size_t bytes, HugePageMode huge_pages, size_t& mapped_bytes, bool& huge);
+    
+    /**
+     * Page faults of the calling thread so far (getrusage RUSAGE_THREAD)
+     * @param minor Minor faults (page was in memory)
+     * @param major Major faults (I/O needed)
+     */
+    static void thread_page_faults(int64_t& minor, int64_t& major);
+    
+    /**
+     * String representation / parsing of huge page modes ("none", "thp", "explicit")
+     */
+    static std::string huge_pages_to_string(HugePageMode mode);
+    static HugePageMode string_to_huge_pages(const std::string& mode_str);
+    
     /**
      * Set real-time scheduling policy for current thread
      * @param policy Scheduling policy (FIFO, RR, DEADLINE)
@@ -77,6 +196,14 @@ public:
      */
     static bool set_thread_realtime(pthread_t thread, RTSchedulingPolicy policy, int priority);
     
+    /**
+     * Put a thread back to SCHED_OTHER (priority 0), e.g. after it ran with
+     * a real-time policy. No-op if it already runs under SCHED_OTHER
+     * @param thread Thread handle
+     * @return true on success, false on failure
+     */
+    static bool set_thread_normal(pthread_t thread);
+    
     /**
      * Set CPU affinity for current thread
      * @param cpu_id CPU core ID to bind to
@@ -92,6 +219,67 @@ public:
      */
     static bool set_cpu_affinity(pthread_t thread, int cpu_id);
     
+    /**
+     * Set CPU affinity for specific thread to a set of CPUs
+     * @param thread Thread handle
+     * @param cpu_list CPU list, e.g. "2-5,8"
+     * @return true on success, false on failure
+     */
+    static bool set_cpu_affinity(pthread_t thread, const std::string& cpu_list);
+    
+    /**
+     * Let a thread run on any CPU again (within the process's cpuset)
+     * @param thread Thread handle
+     * @return true on success, false on failure
+     */
+    static bool clear_cpu_affinity(pthread_t thread);
+    
+    /**
+     * Parse a CPU list of numbers and ranges, e.g. "2-5,8"
+     * @param cpu_list CPU list
+     * @param cpus Receives the CPUs
+     * @return false if the list is malformed or empty
+     */
+    static bool parse_cpu_list(const std::string& cpu_list, cpu_set_t& cpus);
+    
+    /**
+     * True if a --cpu-affinity style argument is a CPU list rather than a
+     * single CPU number
+     */
+    static bool is_cpu_list(const std::string& value);
+    
+    /**
+     * NUMA nodes holding any of the CPUs (from /sys/devices/system/node)
+     * @param cpus CPU set
+     * @return Node mask (bit n = node n), 0 if unknown
+     */
+    static uint64_t numa_nodes_of_cpus(const cpu_set_t& cpus);
+    
+    /**
+     * Set the memory policy of the calling thread (set_mempolicy): new pages
+     * of the thread come from the given nodes
+     * @param policy NUMA policy (NONE restores the default)
+     * @param node_mask Nodes (bit n = node n)
+     * @return true on success, false on failure
+     */
+    static bool set_numa_policy(NumaPolicy policy, uint64_t node_mask);
+    
+    /**
+     * Resident pages of the whole process (every thread, not only the
+     * caller) on and off a set of nodes, summed from /proc/self/numa_maps
+     * @param node_mask Local nodes
+     * @param local_pages Pages on the local nodes
+     * @param remote_pages Pages on the other nodes
+     * @return false if numa_maps is not available
+     */
+    static bool numa_page_counts(uint64_t node_mask, int64_t& local_pages, int64_t& remote_pages);
+    
+    /**
+     * String representation / parsing of NUMA policies ("none", "preferred", "bind")
+     */
+    static std::string numa_policy_to_string(NumaPolicy policy);
+    static NumaPolicy string_to_numa_policy(const std::string& policy_str);
+    
     /**
      * Apply complete real-time configuration to current thread
      * @param config Real-time configuration
@@ -140,6 +328,46 @@ public:
      * @return Scheduling policy enum
      */
     static RTSchedulingPolicy string_to_policy(const std::string& policy_str);
+    
+    /**
+     * Thread name (comm) gRPC gives its synchronous server threads, which
+     * poll the completion queues and run the RPC handlers
+     */
+    static constexpr const char* GRPC_SERVER_THREAD_NAME = "grpcpp_sync_ser";
+    
+    /**
+     * BuildAndStart() a server with the gRPC thread settings of a config:
+     * the number of polling threads and the thread cap are set on the
+     * builder, the server threads are created under grpc_policy/grpc_priority
+     * (the calling thread's policy is restored afterwards; threads spawned
+     * later inherit it from the pollers), and configure_grpc_threads() runs
+     * once the server is up
+     * @param builder Server builder, ports and services already added
+     * @param config Real-time configuration
+     * @param stream_threads Threads held by long-lived streams, added to
+     *        grpc_max_threads so they do not starve the unary RPCs
+     * @return The started server, nullptr on failure
+     */
+    static std::unique_ptr<grpc::Server> build_grpc_server(grpc::ServerBuilder& builder, const RTConfig& config,
+                                                           int stream_threads = 0);
+    
+    /**
+     * Apply grpc_policy/grpc_priority to gRPC's server threads and
+     * housekeeping_cpu_mask to its internal threads, found by name in
+     * /proc/self/task; internal threads that inherited a real-time policy
+     * are moved back to SCHED_OTHER. Threads gRPC creates later inherit the
+     * settings from the thread that spawns them.
+     * @param config Real-time configuration
+     * @return Number of threads reconfigured, -1 on failure
+     */
+    static int configure_grpc_threads(const RTConfig& config);
+    
+    /**
+     * Parse a CPU mask ("0x3", "3" or "0b11")
+     * @param mask_str Mask string
+     * @return Mask (bit n = CPU n), 0 if invalid
+     */
+    static uint64_t string_to_cpu_mask(const std::string& mask_str);
 
 private:
     static int policy_to_sched_policy(RTSchedulingPolicy policy);
@@ -18,22 +18,39 @@ enum TaskExecutionMode {
 struct ScheduledTask {
     std::string task_id;
     std::string task_address;          // gRPC address (e.g., "localhost:50051")
+    std::vector<std::string> task_addresses;  // Equivalent replicas (first = task_address)
     int64_t scheduled_time_us;         // Scheduled start time in microseconds
     int64_t deadline_us;               // Task deadline in microseconds
     int32_t priority;                  // Task priority
     std::map<std::string, std::string> parameters;  // Task parameters
     TaskExecutionMode execution_mode;  // Sequential or timed execution
-    std::string wait_for_task_id;      // Task ID to wait for (if sequential)
+    std::string wait_for_task_id;      // Task ID to wait for (if sequential; first of depends_on)
+    std::vector<std::string> depends_on;  // Every task ID to wait for (YAML: id or list of ids)
     
     // Optional metadata
     int64_t estimated_duration_us;     // Estimated execution time
+    bool estimate_declared = false;    // false: the parser's 1 s default
     int32_t max_retries;               // Maximum retry attempts
     bool critical;                     // Is this a critical task?
+    bool cacheable = false;            // Same parameters and inputs: reuse a cached result
     
     // Real-time configuration
     std::string rt_policy;             // RT scheduling policy: "none", "fifo", "rr", "deadline"
     int32_t rt_priority;               // RT priority (1-99, 99 = highest)
     int32_t cpu_affinity;              // CPU core to bind to (-1 = no affinity)
+    std::string cpu_list;              // CPUs to bind to, e.g. "2-5,8" (overrides cpu_affinity)
+    
+    // cgroup isolation on wrappers started with --cgroup
+    double cpu_bandwidth = 0;          // CPU bandwidth in CPUs (0 = unlimited)
+    int64_t memory_limit_bytes = 0;    // Memory limit (0 = unlimited)
+    
+    // Every dependency (depends_on, or wait_for_task_id for tasks built in code)
+    std::vector<std::string> dependencies() const {
+        if (!depends_on.empty()) {
+            return depends_on;
+        }
+        return wait_for_task_id.empty() ? std::vector<std::string>() : std::vector<std::string>{wait_for_task_id};
+    }
 };
 
 // Represents the complete schedule
@@ -43,9 +60,10 @@ struct TaskSchedule {
     int64_t tick_duration_us;          // Duration of one tick
     std::vector<ScheduledTask> tasks;  // List of scheduled tasks
     
-    // Sort tasks by scheduled time
+    // Sort tasks by scheduled time (stable: sequential tasks, all at time 0,
+    // keep their file order)
     void sort_by_time() {
-        std::sort(tasks.begin(), tasks.end(), 
+        std::stable_sort(tasks.begin(), tasks.end(), 
             [](const ScheduledTask& a, const ScheduledTask& b) {
                 return a.scheduled_time_us < b.scheduled_time_us;
             });
@@ -58,9 +76,12 @@ public:
     // Parse schedule from YAML file
     static TaskSchedule parse_yaml(const std::string& yaml_path);
     
-    // Parse schedule from JSON string
+    // Parse schedule from JSON string (same structure as the YAML files)
     static TaskSchedule parse_json(const std::string& json_str);
     
+    // Parse a schedule file: JSON for *.json, YAML otherwise
+    static TaskSchedule parse_file(const std::string& path);
+    
     // Create a simple test schedule
     static TaskSchedule create_test_schedule();
 };
@@ -0,0 +1,245 @@
+#pragma once
+
+#include "orchestrator.h"
+#include "schedule.h"
+#include "task_table.h"
+#include "execution_history.h"
+#include "trace_file.h"
+#include "release_queue.h"
+#include "critical_path.h"
+#include "duration_store.h"
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace orchestrator {
+
+// How the simulator draws the execution time of a task from its
+// ScheduledTask::estimated_duration_us
+enum DurationModel {
+    DURATION_MODEL_FIXED,     // Exactly the estimate
+    DURATION_MODEL_UNIFORM,   // Uniform in estimate * [1 - spread, 1 + spread]
+    DURATION_MODEL_NORMAL,    // Normal with mean estimate and stddev estimate * spread
+    DURATION_MODEL_LEARNED    // One of the task's recent measured durations (see DurationStore)
+};
+
+// Outcome of a simulated run (times on the virtual clock)
+struct SimulationReport {
+    size_t executions = 0;
+    size_t completed = 0;
+    size_t failed = 0;                    // Starts every replica rejected
+    int64_t makespan_us = 0;              // End of the last execution
+    
+    // Start lateness: actual start minus release (scheduled time for TIMED
+    // tasks, dependencies satisfied for SEQUENTIAL ones)
+    int64_t lateness_mean_us = 0;
+    int64_t lateness_p50_us = 0;
+    int64_t lateness_p99_us = 0;
+    int64_t lateness_max_us = 0;
+    
+    // Executions ending after release + ScheduledTask::deadline_us
+    size_t deadline_misses = 0;
+    std::vector<std::string> missed_tasks;
+    
+    // SEQUENTIAL tasks whose dependencies never complete (a live run would hang on them)
+    std::vector<std::string> stalled_tasks;
+};
+
+// Discrete-event simulation of a schedule (dry run).
+// Runs a TaskSchedule through the Orchestrator's scheduling logic on a
+// virtual clock: TIMED tasks are released at their scheduled time, the
+// SEQUENTIAL phase launches one task at a time once its dependencies have
+// completed, released tasks go through a ReleaseQueue to a pool of
+// max-inflight dispatch workers, and starts are sent to the least-loaded
+// replica, failing over when a wrapper is busy and retrying with the same
+// backoff and max_retries budget. Each wrapper runs one callback at a time.
+//
+// Callbacks compete for CPUs like the wrappers' threads would: tasks bound
+// to the same CPU (cpu_affinity, or the least-loaded CPU of cpu_list) share
+// it by policy. The highest rt_priority runs; at that level the oldest
+// "fifo" task runs alone, "rr" and non-RT tasks share the CPU evenly (time
+// slices are approximated by processor sharing); "deadline" tasks run above
+// every RT priority. cpu_bandwidth caps a callback's share of its CPU.
+// Unbound tasks never contend.
+//
+// The result is the same ExecutionRecord stream as a live run: history,
+// binary trace and Chrome Trace timeline, with wrapper-side milestones
+// taken from the virtual clock.
+class ScheduleSimulator {
+public:
+    ScheduleSimulator();
+    
+    // Load the schedule to simulate (sorted by time, like the orchestrator)
+    void load_schedule(const TaskSchedule& schedule);
+    
+    // Same knobs as the orchestrator (set before run)
+    void set_dispatch_order(DispatchOrder order);
+    void set_max_inflight_dispatches(size_t max_inflight);
+    void set_history_capacity(size_t capacity);
+    void set_trace_file(const std::string& path);
+    
+    // Break dispatch ties by bottom level, like the orchestrator (default: enabled)
+    void set_critical_path_priority(bool enabled) { critical_path_priority_ = enabled; }
+    
+    // Execution times learned by live runs (set before load_schedule; the
+    // store must outlive the simulator): their EWMA replaces the declared
+    // estimate, and the learned model draws from their recent samples
+    void set_duration_store(const DurationStore* store) { duration_store_ = store; }
+    
+    // Execution time model (spread is relative to the estimate) and its seed
+    void set_duration_model(DurationModel model, double spread = 0.1);
+    void set_seed(uint64_t seed) { seed_ = seed; }
+    
+    // Virtual cost of a StartTask round trip and of an end notification
+    // (default: 0, the scheduling logic alone)
+    void set_rpc_latency(int64_t start_latency_us, int64_t end_latency_us);
+    
+    // Simulate the whole schedule. False if some SEQUENTIAL task stalled on
+    // dependencies that never complete, or the trace file could not be opened.
+    bool run();
+    
+    // Same views of the run as the orchestrator's
+    std::vector<TaskExecution> get_execution_history() const;
+    uint64_t get_execution_count() const { return history_.total(); }
+    bool export_timeline(const std::string& path) const;
+    std::vector<CriticalPathStep> get_critical_path() const;
+    
+    // Makespan, lateness distribution and deadline misses of the last run
+    const SimulationReport& report() const { return report_; }
+    
+    // Convert a duration model to/from its name ("fixed", "uniform", "normal", "learned")
+    static DurationModel string_to_duration_model(const std::string& name);
+    static std::string duration_model_to_string(DurationModel model);
+
+private:
+    enum EventType {
+        EVENT_RELEASE,        // TIMED task due
+        EVENT_START_ARRIVED,  // StartTask reached the wrapper
+        EVENT_START_ACKED,    // StartTask response reached the dispatch worker
+        EVENT_RETRY,          // Retry backoff elapsed
+        EVENT_END_NOTIFIED    // End notification reached the orchestrator
+    };
+    
+    struct Event {
+        int64_t time_us;
+        uint64_t sequence;
+        EventType type;
+        size_t task_index;
+    };
+    
+    struct EventAfter {
+        bool operator()(const Event& a, const Event& b) const {
+            return a.time_us != b.time_us ? a.time_us > b.time_us : a.sequence > b.sequence;
+        }
+    };
+    
+    // A callback holding (a share of) a CPU
+    struct Execution {
+        size_t task_index;
+        double remaining_us;   // Work left at full speed
+        double rate;           // Current share of the CPU
+        int32_t level;         // rt_priority, 100 for deadline, 0 for non-RT
+        bool fifo;             // Runs alone among its level
+        double bandwidth;      // Share cap (0 = none)
+        uint64_t arrival;
+    };
+    
+    // A CPU and the callbacks bound to it (cpu -1: unbound, no contention)
+    struct Core {
+        int32_t cpu;
+        std::vector<Execution> executions;
+    };
+    
+    // State of the start attempts of a dispatched task
+    struct Dispatch {
+        uint64_t tried_mask;
+        int32_t retries_left;
+        bool rejected;
+        std::string message;
+    };
+    
+    void schedule_event(int64_t time_us, EventType type, size_t task_index);
+    void handle_event(const Event& event);
+    
+    // Orchestrator logic on the virtual clock
+    void release_task(size_t task_index, int64_t release_time_us);
+    void advance_sequential();
+    void dispatch_released();
+    void try_start(size_t task_index);
+    void fail_start(size_t task_index, const std::string& message);
+    void end_task(size_t task_index);
+    
+    // CPU model
+    void begin_callback(size_t task_index);
+    size_t core_for(size_t task_index);
+    void share_core(Core& core);
+    void advance_clock(int64_t time_us);
+    int64_t next_callback_end() const;
+    void finish_callbacks();
+    int64_t draw_duration(size_t task_index);
+    
+    // Append a finished execution to the history, the trace and the report
+    void record_execution(TaskHandle handle);
+    void build_report();
+    std::vector<TimelineDependency> schedule_dependencies() const;
+    
+    TaskSchedule schedule_;
+    TaskTable tasks_;
+    std::vector<TaskHandle> schedule_handles_;
+    
+    // Wrappers: one per distinct address, each running one callback at a time
+    std::vector<std::string> addresses_;
+    std::vector<std::vector<EndpointId>> task_endpoints_;
+    std::vector<int32_t> in_flight_;
+    std::vector<size_t> wrapper_task_;      // Task running on the wrapper (SIZE_MAX = idle)
+    
+    // Bottom levels, rebuilt from the estimates at every run
+    const DurationStore* duration_store_;
+    std::vector<int64_t> estimated_us_;      // Longest estimate (or learned EWMA) by handle
+    std::vector<const TaskDurationStats*> learned_;  // By handle (nullptr = never measured)
+    CriticalPath critical_path_;
+    
+    // Configuration
+    DispatchOrder dispatch_order_;
+    size_t max_inflight_dispatches_;
+    size_t history_capacity_;
+    std::string trace_path_;
+    DurationModel duration_model_;
+    double duration_spread_;
+    uint64_t seed_;
+    int64_t start_latency_us_;
+    int64_t end_latency_us_;
+    bool critical_path_priority_;
+    
+    // Virtual clock and pending events
+    int64_t now_us_;
+    uint64_t next_sequence_;
+    std::priority_queue<Event, std::vector<Event>, EventAfter> events_;
+    std::mt19937_64 rng_;
+    
+    // Dispatch
+    ReleaseQueue release_queue_;
+    size_t idle_workers_;
+    std::vector<Dispatch> dispatches_;
+    
+    // SEQUENTIAL phase: next entry, and whether it is waiting for its
+    // dependencies or for its own completion
+    size_t next_sequential_;
+    bool sequential_launched_;
+    bool sequential_waiting_;
+    
+    // CPUs
+    std::vector<Core> cores_;
+    uint64_t next_arrival_;
+    
+    // Results
+    ExecutionHistory history_;
+    TraceWriter trace_;
+    SimulationReport report_;
+    std::vector<int64_t> lateness_;          // Start lateness of every completed execution
+    std::vector<int64_t> deadline_us_;       // Relative deadline by handle
+};
+
+} // namespace orchestrator
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "orchestrator.pb.h"
+#include <grpcpp/support/status.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace orchestrator {
+
+// Messages carried over a shared-memory channel (payload: the serialized proto)
+enum ShmMessageType : uint32_t {
+    SHM_MSG_START = 1,            // StartTaskRequest
+    SHM_MSG_START_RESPONSE = 2,   // StartTaskResponse
+    SHM_MSG_STOP = 3,             // StopTaskRequest
+    SHM_MSG_STOP_RESPONSE = 4,    // StopTaskResponse
+    SHM_MSG_TASK_END = 5          // TaskEndNotification
+};
+
+constexpr size_t SHM_SLOT_SIZE = 4096;   // Slot header + largest serialized message
+constexpr size_t SHM_RING_SLOTS = 64;
+
+// Single-producer/single-consumer ring of fixed-size slots in shared memory.
+// The producer publishes a slot by advancing `head`; the consumer spins
+// briefly when the ring is empty, then sleeps on `head` with a shared futex.
+struct ShmRing {
+    struct Slot {
+        uint32_t type;
+        uint32_t length;
+        uint32_t sequence;   // Call id echoed by the reply (0 = not a call)
+        uint32_t reserved;
+        uint8_t data[SHM_SLOT_SIZE - 16];
+    };
+    
+    alignas(64) std::atomic<uint32_t> head;       // Next slot to write (producer)
+    alignas(64) std::atomic<uint32_t> tail;       // Next slot to read (consumer)
+    alignas(64) std::atomic<uint32_t> sleeping;   // Consumer is (about to be) in futex wait
+    alignas(64) Slot slots[SHM_RING_SLOTS];
+};
+
+// Largest serialized message a slot carries (larger ones need gRPC)
+constexpr size_t SHM_MAX_MESSAGE_SIZE = sizeof(ShmRing::Slot::data);
+
+// Task outputs up to this size in total travel inline in the end
+// notification; larger ones go to ShmOutputBuffer segments
+constexpr size_t INLINE_OUTPUT_BYTES = 1024;
+
+// Segment shared by a wrapper and the orchestrator: one ring per direction
+struct ShmSegment {
+    uint32_t magic;
+    uint32_t version;
+    ShmRing to_wrapper;        // Starts, stops
+    ShmRing to_orchestrator;   // Start/stop responses, task ends
+};
+
+// One end of a shared-memory channel (/dev/shm/orchestrator_<name>).
+// The wrapper creates the segment, the orchestrator opens it. Sends are
+// serialized by a mutex (each ring has one producer); receive() must only be
+// called from a single thread.
+class ShmChannel {
+public:
+    // Spin this long on an empty ring before sleeping on the futex
+    static constexpr int64_t DEFAULT_SPIN_US = 50;
+    
+    ShmChannel();
+    ~ShmChannel();
+    
+    // Wrapper side: create (or replace) the segment
+    bool create(const std::string& name);
+    
+    // Orchestrator side: attach to an existing segment
+    bool open(const std::string& name);
+    
+    // Unmap the segment (and unlink it on the creating side)
+    void close();
+    
+    bool is_open() const { return segment_ != nullptr; }
+    const std::string& name() const { return name_; }
+    
+    // Serialize `message` into the next outgoing slot; false if the channel is
+    // closed, the message does not fit in a slot or the ring stays full.
+    // A reply carries the sequence of the request it answers.
+    bool send(ShmMessageType type, const google::protobuf::MessageLite& message, uint32_t sequence = 0);
+    
+    // Wait up to timeout_us for the next incoming message. The payload stays
+    // valid until consume() is called.
+    bool receive(ShmMessageType& type, uint32_t& sequence, const void*& data, uint32_t& length,
+                 int64_t timeout_us);
+    void consume();
+    
+    // Drop every incoming message not yet received
+    void discard_pending();
+    
+    // Segment path for shm_open
+    static std::string segment_path(const std::string& name);
+
+private:
+    bool map(int fd, bool initialize);
+    
+    ShmSegment* segment_;
+    ShmRing* tx_;
+    ShmRing* rx_;
+    bool owner_;
+    std::string name_;
+    std::mutex send_mutex_;
+};
+
+// Large task output in its own segment (/dev/shm/orchestrator_<name>).
+// The producing wrapper creates and fills it, dependents map it read-only
+// by name, and the orchestrator unlinks it once its last consumer ended.
+class ShmOutputBuffer {
+public:
+    ShmOutputBuffer();
+    ~ShmOutputBuffer();
+    ShmOutputBuffer(ShmOutputBuffer&& other) noexcept;
+    ShmOutputBuffer& operator=(ShmOutputBuffer&& other) noexcept;
+    ShmOutputBuffer(const ShmOutputBuffer&) = delete;
+    ShmOutputBuffer& operator=(const ShmOutputBuffer&) = delete;
+    
+    // Producer: create (or replace) a segment of `size` bytes, mapped read-write
+    bool create(const std::string& name, size_t size);
+    
+    // Consumer: map an existing segment read-only
+    bool open(const std::string& name, size_t size);
+    
+    // Unmap (the segment itself stays until unlink)
+    void close();
+    
+    bool is_open() const { return data_ != nullptr; }
+    char* data() { return static_cast<char*>(data_); }
+    const char* data() const { return static_cast<const char*>(data_); }
+    size_t size() const { return size_; }
+    const std::string& name() const { return name_; }
+    
+    // Remove a segment (mappings stay valid until unmapped)
+    static void unlink(const std::string& name);
+
+private:
+    bool map(int fd, size_t size, int protection);
+    
+    void* data_;
+    size_t size_;
+    std::string name_;
+};
+
+// Orchestrator end of a wrapper's channel: starts are synchronous calls (one
+// at a time), end notifications are delivered by a reader thread. Each call
+// has its own sequence; a reply that arrives after its call timed out is
+// dropped instead of answering the next call.
+class ShmClient {
+public:
+    using EndHandler = std::function<void(const TaskEndNotification&)>;
+    
+    explicit ShmClient(EndHandler on_end);
+    ~ShmClient();
+    
+    // Attach to the segment of a wrapper and start the reader thread
+    bool connect(const std::string& name);
+    void disconnect();
+    
+    // Send a start and wait for the wrapper's response. Failures map to
+    // gRPC status codes (UNAVAILABLE, DEADLINE_EXCEEDED) so callers treat
+    // both transports alike.
+    grpc::Status start_task(const StartTaskRequest& request, StartTaskResponse* response, int64_t timeout_us);
+    
+    const std::string& name() const { return channel_.name(); }
+
+private:
+    grpc::Status call(ShmMessageType type, const google::protobuf::MessageLite& request,
+                      ShmMessageType reply_type, google::protobuf::MessageLite* reply, int64_t timeout_us);
+    void reader_loop();
+    
+    ShmChannel channel_;
+    EndHandler on_end_;
+    std::thread reader_;
+    std::atomic<bool> running_;
+    
+    // Reply hand-off: the reader copies the payload of the reply to
+    // awaited_seq_, then publishes its sequence in reply_seq_
+    std::mutex call_mutex_;
+    uint32_t call_seq_;                  // Last call sent (call_mutex_)
+    std::atomic<uint32_t> awaited_seq_;  // Call waiting for its reply (0 = none)
+    std::atomic<uint32_t> reply_seq_;
+    ShmMessageType reply_type_;
+    std::string reply_payload_;
+};
+
+} // namespace orchestrator
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "orchestrator.pb.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace orchestrator {
+
+// Dense integer handle assigned to every distinct task id at load time
+using TaskHandle = uint32_t;
+constexpr TaskHandle INVALID_TASK_HANDLE = std::numeric_limits<TaskHandle>::max();
+
+// Milestones of one execution, relative to orchestrator start (0 = not reached).
+// Wrapper-side times come from the wrapper's steady clock, so they line up with
+// the orchestrator's only when both run on the same host.
+struct TaskTimeline {
+    int64_t wait_start_us;       // Started waiting for dependencies
+    int64_t release_us;          // Released (dependencies satisfied / timer fired)
+    int64_t dispatch_us;         // StartTask sent
+    int64_t dispatch_done_us;    // StartTask response received
+    int64_t wrapper_start_us;    // Start accepted by the wrapper
+    int64_t callback_start_us;   // Task callback entered
+    int64_t callback_end_us;     // Task callback returned
+    int64_t notify_received_us;  // End notification received by the orchestrator
+    int32_t cpu_core;            // Core the callback ran on (-1 = unknown)
+};
+
+// Compact record of one finished execution (no strings, cheap to copy)
+struct ExecutionRecord {
+    TaskHandle handle;
+    int64_t scheduled_time_us;
+    int64_t actual_start_time_us;
+    int64_t end_time_us;
+    TaskState state;
+    TaskResult result;
+    uint32_t endpoint;           // Replica that ran the execution
+    TaskTimeline timeline;
+};
+
+// Runtime task table.
+// Task ids are interned once when the schedule is loaded; afterwards the hot
+// runtime state lives in parallel arrays indexed by TaskHandle, so the
+// dispatch / completion path never hashes or copies a string. Strings are only
+// touched at the API and proto boundaries (id(), find(), error_message).
+class TaskTable {
+public:
+    // Intern a task id (returns the existing handle if already known)
+    TaskHandle intern(const std::string& task_id);
+
+    // Look up the handle of a task id (INVALID_TASK_HANDLE if unknown)
+    TaskHandle find(const std::string& task_id) const;
+
+    // Resolve a handle received from the wire, falling back to the id lookup
+    // when the handle is missing or does not match the id
+    TaskHandle resolve(TaskHandle hint, const std::string& task_id) const;
+
+    const std::string& id(TaskHandle handle) const { return ids_[handle]; }
+    size_t size() const { return ids_.size(); }
+    bool valid(TaskHandle handle) const { return handle < ids_.size(); }
+
+    // Register that `task` must wait for `depends_on` to complete
+    void add_dependency(TaskHandle task, TaskHandle depends_on);
+
+    // Remove all tasks and dependencies
+    void clear();
+
+    // Reset runtime state of all tasks (keeps ids and dependency graph)
+    void reset_runtime();
+
+    // Record dispatch of a task
+    void mark_started(TaskHandle handle, int64_t start_time_us);
+
+    // Record completion of a task and release its dependents
+    void mark_completed(TaskHandle handle, TaskState state, TaskResult result, int64_t end_time_us);
+
+    bool is_active(TaskHandle handle) const {
+        return state[handle] == TASK_STATE_STARTING || state[handle] == TASK_STATE_RUNNING;
+    }
+    bool dependencies_satisfied(TaskHandle handle) const { return pending_deps[handle] == 0; }
+
+    // Snapshot the current state of a task as a compact record
+    ExecutionRecord record(TaskHandle handle) const;
+    
+    // Tasks waiting for `handle` to complete
+    const std::vector<TaskHandle>& dependents(TaskHandle handle) const { return dependents_[handle]; }
+    
+    // Tasks `handle` waits for
+    const std::vector<TaskHandle>& dependencies(TaskHandle handle) const { return dependencies_[handle]; }
+
+    // Hot runtime state (parallel arrays indexed by handle)
+    std::vector<TaskState> state;
+    std::vector<TaskResult> result;
+    std::vector<int64_t> scheduled_time_us;
+    std::vector<int64_t> actual_start_time_us;
+    std::vector<int64_t> end_time_us;
+    std::vector<uint8_t> completed;          // Completed at least once (for dependencies)
+    std::vector<int32_t> pending_deps;       // Dependencies not yet completed
+    std::vector<uint32_t> endpoint;          // Replica of the current dispatch
+
+    // Cold state
+    std::vector<TaskTimeline> timeline;
+    std::vector<std::string> error_message;
+
+private:
+    std::vector<std::string> ids_;
+    std::unordered_map<std::string, TaskHandle> index_;
+    std::vector<int32_t> dependency_count_;
+    std::vector<std::vector<TaskHandle>> dependents_;
+    std::vector<std::vector<TaskHandle>> dependencies_;
+};
+
+} // namespace orchestrator
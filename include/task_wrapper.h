@@ -2,18 +2,50 @@
 
 #include "orchestrator.grpc.pb.h"
 #include "rt_utils.h"
+#include "shm_transport.h"
+#include "cgroup_isolation.h"
+#include "rt_memory_pool.h"
+#include "perf_counters.h"
 #include <grpcpp/grpcpp.h>
+#include <google/protobuf/arena.h>
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
 #include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace orchestrator {
 
+// Read-only, allocation-free view of the task parameters.
+// Entries are sorted by key and point into storage owned by the TaskWrapper;
+// they are valid only for the duration of the execution callback.
+class TaskParameterView {
+public:
+    using Entry = std::pair<std::string_view, std::string_view>;
+    
+    // Value of a parameter, or default_value if not present
+    std::string_view get(std::string_view key, std::string_view default_value = {}) const;
+    bool contains(std::string_view key) const;
+    
+    size_t size() const { return entries_.size(); }
+    std::vector<Entry>::const_iterator begin() const { return entries_.begin(); }
+    std::vector<Entry>::const_iterator end() const { return entries_.end(); }
+
+private:
+    friend class TaskWrapper;
+    std::vector<Entry> entries_;
+};
+
 // Task execution callback type
 using TaskExecutionCallback = std::function<TaskResult(const std::map<std::string, std::string>&)>;
 
+// Task execution callback type using the parameter view (no parameter copies)
+using TaskExecutionViewCallback = std::function<TaskResult(const TaskParameterView&)>;
+
 // Task service implementation (receives start/stop commands)
 class TaskServiceImpl final : public TaskService::Service {
 public:
@@ -24,6 +56,21 @@ public:
         const StartTaskRequest* request,
         StartTaskResponse* response) override;
     
+    grpc::Status StartTasks(
+        grpc::ServerContext* context,
+        const StartTasksRequest* request,
+        StartTasksResponse* response) override;
+    
+    grpc::Status ArmTask(
+        grpc::ServerContext* context,
+        const ArmTaskRequest* request,
+        ArmTaskResponse* response) override;
+    
+    grpc::Status DisarmTask(
+        grpc::ServerContext* context,
+        const DisarmTaskRequest* request,
+        DisarmTaskResponse* response) override;
+    
     grpc::Status StopTask(
         grpc::ServerContext* context,
         const StopTaskRequest* request,
@@ -33,9 +80,23 @@ public:
         grpc::ServerContext* context,
         const TaskStatusRequest* request,
         TaskStatusResponse* response) override;
+    
+    grpc::Status Heartbeat(
+        grpc::ServerContext* context,
+        const HeartbeatRequest* request,
+        grpc::ServerWriter<HeartbeatBeat>* writer) override;
+    
+    // Accepted range of heartbeat intervals
+    static constexpr int64_t MIN_HEARTBEAT_INTERVAL_US = 1000;
+    static constexpr int64_t MAX_HEARTBEAT_INTERVAL_US = 1000000;
+    
+    // Streams open at once (a reconnecting orchestrator overlaps the old
+    // one). Each holds a server thread, reserved on top of grpc_max_threads.
+    static constexpr int MAX_HEARTBEAT_STREAMS = 2;
 
 private:
     class TaskWrapper* wrapper_;
+    std::atomic<int> heartbeat_streams_;
 };
 
 // Task Wrapper class
@@ -47,50 +108,245 @@ public:
         const std::string& orchestrator_address,
         TaskExecutionCallback execution_callback);
     
+    TaskWrapper(
+        const std::string& task_id,
+        const std::string& listen_address,
+        const std::string& orchestrator_address,
+        TaskExecutionViewCallback execution_callback);
+    
     ~TaskWrapper();
     
     // Set real-time configuration for task execution thread
     void set_rt_config(const RTConfig& config);
     
+    // Zero-allocation mode (must be set before start()): executions run on a
+    // persistent worker thread and reuse parameter storage, the end
+    // notification and the client context, so after the first (warmup)
+    // execution the hot path performs no heap allocation
+    void set_zero_allocation_mode(bool enabled);
+    
+    // Coalesce end notifications (must be set before start()): completions
+    // are flushed as one NotifyTaskEnds batch window_us after the first
+    // pending one (0 = one NotifyTaskEnd per execution, the default)
+    void set_notify_coalescing_window(int64_t window_us);
+    
+    // Also serve starts/stops over a shared-memory channel named `name`
+    // (must be set before start()); advertised to the orchestrator through
+    // GetTaskStatus. Ends of starts received this way go back over the channel.
+    void set_shm_endpoint(const std::string& name);
+    const std::string& get_shm_name() const { return shm_name_; }
+    
+    // Also listen on a Unix domain socket at `path` (must be set before
+    // start()); advertised through GetTaskStatus so a co-located orchestrator
+    // can dial it instead of TCP loopback
+    void set_uds_path(const std::string& path);
+    const std::string& get_uds_address() const { return uds_address_; }
+    
+    // Run each execution in a cgroup v2 child (must be set before start()):
+    // cpuset from the request's CPUs (default_cpus otherwise),
+    // cpu.max from its cpu_bandwidth and estimated duration, memory.max from
+    // its memory limit; throttling is reported in the end notification.
+    // Without a delegated cgroup v2 subtree the wrapper runs unisolated.
+    void set_cgroup_isolation(bool enabled, const std::string& default_cpus = "");
+    
+    // Measure each callback with perf_event_open counters, reported as
+    // "perf.*" metrics of the end notification (software counters always,
+    // hardware counters where the PMU is accessible)
+    void set_perf_counters(bool enabled) { perf_enabled_ = enabled; }
+    
+    // Publish a named output of the running execution (call from the
+    // execution callback). Outputs travel inline in the end notification up
+    // to INLINE_OUTPUT_BYTES in total; larger ones are copied once into a
+    // shared-memory buffer. The orchestrator hands them to the task's
+    // dependents, which see parameters named "<task id>.<name>" (values of
+    // shared-memory outputs point into the read-only mapping, no copy).
+    bool publish_output(const std::string& name, std::string_view value);
+    
+    // Zero-copy variant: a writable shared-memory output of `size` bytes,
+    // published when the callback returns (nullptr outside a callback or on failure)
+    char* allocate_output(const std::string& name, size_t size);
+    
+    // Heap allocations seen on the hot path after warmup (see AllocCounter)
+    uint64_t get_hot_path_allocations() const { return hot_path_allocations_; }
+    
     // Start the task wrapper (listen for commands)
     void start();
     
     // Stop the task wrapper
     void stop();
     
-    // Execute the task (called by service when .start is received)
-    void execute_task(const StartTaskRequest& request);
+    // Execute the task (called by service when .start is received). Returns
+    // why it was not started (a shared-memory input that cannot be mapped),
+    // or nullptr
+    const char* execute_task(const StartTaskRequest& request, bool via_shm = false);
+    
+    // Execute several tasks back to back, in order (StartTasks batch). A later
+    // start whose inputs cannot be mapped ends FAILED instead.
+    const char* execute_tasks(const StartTaskRequest* const* requests, size_t count, bool via_shm = false);
+    
+    // Why a start would be rejected now, or nullptr if it can be accepted
+    const char* start_rejection() const;
+    
+    // Check and execute in one step, so concurrent starts (gRPC threads, the
+    // shared-memory channel) cannot both be accepted. Returns the rejection,
+    // or nullptr if the starts were accepted.
+    const char* accept_tasks(const StartTaskRequest* const* requests, size_t count, bool via_shm = false);
+    
+    // Starts of a batch waiting for the current execution to finish
+    size_t get_queued_starts() const;
+    
+    // Pre-arm a start: the arm thread releases it at release_time_us (system
+    // clock, us since the Unix epoch), without waiting for the orchestrator.
+    // Several starts may be armed; they are released in release-time order.
+    bool arm_task(const StartTaskRequest& request, int64_t release_time_us, std::string& message);
+    
+    // Cancel the armed start of task_id (empty = every armed start)
+    bool disarm_task(const std::string& task_id, std::string& message);
+    
+    // At least one start is armed and not yet released
+    bool is_armed() const;
     
     // Get current task state
     TaskState get_state() const { return state_; }
     
+    // Between start() and stop()
+    bool is_running() const { return running_; }
+    
+    // A callback is running under a real-time policy
+    bool is_running_rt() const { return rt_execution_; }
+    
     // Get task ID
     std::string get_task_id() const { return task_id_; }
     
     // Get execution statistics
     int64_t get_start_time_us() const { return start_time_us_; }
+    int64_t get_accept_time_us() const { return accept_time_us_; }
     int64_t get_elapsed_time_us() const;
     
     // Get relative time since wrapper creation (for logging)
     int64_t get_relative_time_ms() const;
 
 private:
-    // Task execution thread function
-    void task_execution_thread(StartTaskRequest request);
+    // Reusable execution slot, filled from the StartTaskRequest. Strings are
+    // assigned in place so their capacity is reused across executions.
+    struct ExecutionSlot {
+        std::string task_id;
+        uint32_t task_handle = 0;
+        std::string rt_policy;
+        int32_t rt_priority = 0;
+        std::string cpus;                   // CPU list ("" = no affinity)
+        int64_t estimated_duration_us = 0;
+        double cpu_bandwidth = 0;
+        int64_t memory_limit_bytes = 0;
+        std::vector<std::pair<std::string, std::string>> param_storage;
+        size_t param_count = 0;
+        bool via_shm = false;               // Started over the shared-memory channel
+        bool armed = false;                 // Released by the arm thread
+        int64_t release_lateness_us = 0;    // Wakeup lateness of an armed release
+        std::string missing_input;          // Shared-memory input that could not be mapped
+    };
+    
+    // Output published by the current execution (storage reused)
+    struct PublishedOutput {
+        std::string name;
+        std::string data;           // Inline value
+        std::string segment;        // Shared-memory value ("" = inline)
+        uint64_t size = 0;
+        ShmOutputBuffer buffer;     // Its mapping, closed once the callback returns
+    };
+    
+    // Copy the request into the execution slot (false if an input could not
+    // be mapped, see ExecutionSlot::missing_input)
+    bool stage_request(const StartTaskRequest& request);
+    
+    // Unmap the inputs of the staged execution
+    void close_inputs();
+    
+    // Slot of a new output (replacing one of the same name); nullptr outside a callback
+    PublishedOutput* next_output(const std::string& name);
+    
+    // Give an output a fresh shared-memory buffer of `size` bytes (the
+    // output is dropped if that fails)
+    char* map_output(PublishedOutput& output, size_t size);
+    
+    // Task execution thread function (one thread per execution)
+    void task_execution_thread();
+    
+    // Persistent worker loop (zero-allocation mode)
+    void worker_loop();
+    
+    // Append starts to the queue (mutex_ held, room checked by the caller)
+    void queue_starts(const StartTaskRequest* const* requests, size_t count);
+    
+    // The starts can run now and end, by their estimates, before the
+    // earliest armed release (mutex_ held, at least one start armed)
+    bool fits_before_release(const StartTaskRequest* const* requests, size_t count) const;
+    
+    // Stage the next queued start of a batch; false if none is left
+    bool stage_queued_start();
+    
+    // Run the queued starts on the arm thread (after an armed release, or
+    // when the starts they waited for were disarmed)
+    void run_queued_starts();
+    
+    // Run the staged execution, then the queued starts of its batch
+    void run_executions();
+    
+    // Serves starts/stops received on the shared-memory channel
+    void shm_loop();
+    
+    // Arm thread: sleeps until the armed release time, then runs the execution
+    void arm_loop();
+    
+    // Apply the RT configuration requested in the execution slot
+    void apply_slot_rt_config();
+    
+    // Same, skipped when the slot asks for the configuration already applied
+    void refresh_slot_rt_config();
+    
+    // Apply a request-level RT configuration to the calling thread
+    void apply_request_rt_config(const std::string& policy, int32_t priority, const std::string& cpus);
+    
+    // Back to the wrapper-level CPUs and memory policy (calling thread)
+    void reset_placement();
+    
+    // Back to the wrapper-level scheduling policy, or SCHED_OTHER without
+    // one (calling thread: it may have inherited or kept an RT policy)
+    void reset_scheduling();
+    
+    // CPU list of a request (cpu_list, else cpu_affinity; "" = none)
+    static std::string request_cpus(const StartTaskRequest& request);
+    
+    // Run one execution from the slot: callback + end notification
+    void run_execution();
+    
+    // Refresh the legacy parameter map, reusing its nodes when possible
+    void sync_param_map();
     
     // Send task end notification to orchestrator
     void notify_orchestrator_end(TaskResult result, const std::string& error_msg = "");
     
+    // Fill an end notification from the current execution
+    void fill_notification(TaskEndNotification& notification, TaskResult result, const std::string& error_msg);
+    
+    // Flusher thread: sends the coalesced end notifications
+    void notify_loop();
+    
     // Get current time in microseconds
     int64_t get_current_time_us() const;
     
+    // System clock in microseconds since the Unix epoch (armed release times)
+    static int64_t get_system_time_us();
+    
     // Task identification
     std::string task_id_;
+    uint32_t task_handle_;  // Orchestrator handle of the current execution
     
     // gRPC server for receiving commands
     std::unique_ptr<grpc::Server> server_;
     std::unique_ptr<TaskServiceImpl> service_;
     std::string listen_address_;
+    std::string uds_address_;   // Additional "unix:" listener (empty = none)
     
     // gRPC client for notifying orchestrator
     std::unique_ptr<OrchestratorService::Stub> orchestrator_stub_;
@@ -98,16 +354,117 @@ private:
     
     // Task execution
     TaskExecutionCallback execution_callback_;
+    TaskExecutionViewCallback view_callback_;
     std::thread execution_thread_;
     
+    // Reusable per-execution state
+    ExecutionSlot slot_;
+    std::vector<PublishedOutput> outputs_;
+    size_t output_count_;
+    size_t inline_output_bytes_;
+    uint64_t output_sequence_;                  // Names the shared-memory outputs
+    std::vector<ShmOutputBuffer> input_buffers_;  // Mapped shared-memory inputs
+    size_t input_buffer_count_;
+    bool shm_outputs_;    // Orchestrator on this host: large outputs go through /dev/shm
+    TaskParameterView param_view_;
+    std::map<std::string, std::string> params_;
+    google::protobuf::Arena notify_arena_;
+    TaskEndNotification* notification_;
+    TaskEndResponse* notify_response_;
+    std::unique_ptr<grpc::ClientContext> notify_context_;
+    
+    // Zero-allocation mode
+    bool zero_alloc_mode_;
+    std::thread worker_thread_;
+    std::condition_variable worker_cv_;
+    bool start_pending_;
+    bool worker_busy_;
+    std::string applied_rt_policy_;
+    int32_t applied_rt_priority_;
+    std::string applied_cpus_;
+    std::atomic<uint64_t> execution_count_;
+    
+    // Starts of a StartTasks batch after the first, or starts waiting behind
+    // an armed start (guarded by mutex_): a ring of requests allocated once,
+    // assigned in place so their strings keep their capacity. Larger batches
+    // are rejected.
+    static constexpr size_t MAX_QUEUED_STARTS = 32;
+    std::vector<StartTaskRequest> queued_starts_;
+    size_t queued_head_;
+    size_t queued_count_;
+    
+    // End notification coalescing: executions append to pending_ends_, the
+    // flusher swaps it with sending_ends_ (cleared messages are reused)
+    int64_t notify_window_us_;
+    std::thread notify_thread_;
+    std::mutex notify_mutex_;
+    std::condition_variable notify_cv_;
+    TaskEndBatch* pending_ends_;
+    TaskEndBatch* sending_ends_;
+    int64_t notify_flush_at_us_;
+    
+    // Shared-memory channel (optional)
+    std::string shm_name_;
+    ShmChannel shm_channel_;
+    std::thread shm_thread_;
+    std::mutex start_mutex_;    // Serializes accept_tasks()
+    std::thread stop_thread_;   // Runs stop() after a stop received over the channel
+    static constexpr int64_t SHM_POLL_US = 100000;  // Reader wakes up to notice stop()
+    
+    // cgroup isolation (optional)
+    bool cgroup_requested_;
+    std::string cgroup_cpus_;
+    CgroupIsolation cgroup_;
+    CgroupIsolation::Limits cgroup_limits_;
+    CgroupIsolation::CpuStat cgroup_before_;
+    CgroupIsolation::CpuStat cgroup_usage_;   // Of the last execution
+    
+    // Pages the whole process gained on / off the last execution's NUMA nodes
+    // while it ran (numa_maps has no per-thread view)
+    int64_t numa_local_pages_;
+    int64_t numa_remote_pages_;
+    
+    // Pre-faulted pool current during executions (RTConfig::pool_bytes)
+    std::unique_ptr<RTMemoryPool> memory_pool_;
+    
+    // perf counters of the last execution's callback (optional)
+    bool perf_enabled_;
+    bool perf_measured_;
+    PerfCounters perf_;
+    PerfSample perf_sample_;
+    std::string perf_keys_[PERF_COUNTER_COUNT];  // Metrics keys, built once
+    char perf_value_[24];
+    
+    // Page faults of the last execution's callback
+    int64_t minor_page_faults_;
+    int64_t major_page_faults_;
+    
+    // Pre-armed starts (guarded by mutex_, waits on worker_cv_)
+    struct ArmedStart {
+        StartTaskRequest request;
+        int64_t release_time_us;    // System clock
+    };
+    static constexpr size_t MAX_ARMED_STARTS = 16;
+    std::thread arm_thread_;
+    std::vector<ArmedStart> armed_starts_;  // Ordered by release time
+    uint64_t arm_generation_;       // Bumped when the earliest armed start changes
+    
+    // The arm thread sleeps on the condition variable until this long before
+    // the release, then sleeps on the absolute system-clock time
+    static constexpr int64_t ARM_PRECISE_WAIT_US = 2000;
+    std::atomic<uint64_t> hot_path_allocations_;
+    
     // State management
     std::atomic<TaskState> state_;
+    std::atomic<bool> rt_execution_;
     std::atomic<bool> running_;
     std::atomic<bool> stop_requested_;
     
     // Timing
     int64_t start_time_us_;
     int64_t end_time_us_;
+    std::atomic<int64_t> accept_time_us_;  // Last start command accepted
+    int32_t cpu_core_;                     // Core the last callback ran on
     int64_t creation_time_us_;  // Time when wrapper was created (for logging)
     
     // Thread safety
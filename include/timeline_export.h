@@ -0,0 +1,35 @@
+#pragma once
+
+#include "orchestrator.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace orchestrator {
+
+// Schedule dependency: task_id waits for depends_on
+struct TimelineDependency {
+    std::string task_id;
+    std::string depends_on;
+};
+
+// Chrome Trace Event (JSON) exporter, viewable in ui.perfetto.dev or
+// chrome://tracing.
+// Each wrapper address is a process with one "orchestrator" track (release,
+// dependency wait, dispatch RPC, end notification) and one track per CPU core
+// the wrapper ran callbacks on (wrapper start, callback execution). Flow
+// arrows link a dependency's callback to the dispatch it released.
+class TimelineExporter {
+public:
+    // Write the timeline to a file
+    static bool write_chrome_trace(const std::string& path,
+                                   const std::vector<TaskExecution>& executions,
+                                   const std::vector<TimelineDependency>& dependencies);
+    
+    // Write the timeline to a stream
+    static void write_chrome_trace(std::ostream& out,
+                                   const std::vector<TaskExecution>& executions,
+                                   const std::vector<TimelineDependency>& dependencies);
+};
+
+} // namespace orchestrator
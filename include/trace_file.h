@@ -0,0 +1,102 @@
+#pragma once
+
+#include "task_table.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace orchestrator {
+
+// Binary execution trace file layout:
+//
+//   TraceFileHeader
+//   task id table   (task_count NUL-terminated ids, padded to 8 bytes)
+//   TraceRecord[record_count]
+//
+// Records are fixed-size and appended through a memory mapping, so writing
+// one is a plain memcpy (the file only grows, in TRACE_GROW_BYTES chunks).
+// record_count in the header is updated after every append, so a trace from a
+// process that died is still readable up to the last complete record.
+
+constexpr char TRACE_MAGIC[8] = {'O', 'R', 'C', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t TRACE_VERSION = 1;
+constexpr size_t TRACE_GROW_BYTES = 1 << 20;
+
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    int64_t start_time_us;       // Wall clock (unix epoch) at orchestrator start
+    uint32_t task_count;
+    uint32_t id_table_size;      // Bytes, including padding
+    uint64_t data_offset;        // Offset of the first record
+    uint64_t record_count;
+};
+
+// One finished execution (times relative to orchestrator start)
+struct TraceRecord {
+    uint64_t sequence;
+    uint32_t handle;
+    uint8_t state;
+    uint8_t result;
+    uint16_t reserved;
+    int64_t scheduled_time_us;
+    int64_t actual_start_time_us;
+    int64_t end_time_us;
+};
+
+static_assert(sizeof(TraceFileHeader) == 48, "TraceFileHeader layout changed");
+static_assert(sizeof(TraceRecord) == 40, "TraceRecord layout changed");
+
+// Append-only writer of a trace file
+class TraceWriter {
+public:
+    TraceWriter();
+    ~TraceWriter();
+    
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+    
+    // Create (truncate) the file and write the header and task id table
+    bool open(const std::string& path, const TaskTable& tasks, int64_t start_time_us);
+    
+    // Append one record (callers serialize appends)
+    void append(const ExecutionRecord& record);
+    
+    // Trim the file to its used size and unmap it
+    void close();
+    
+    bool is_open() const { return map_ != nullptr; }
+    uint64_t record_count() const { return record_count_; }
+
+private:
+    // Extend the file and the mapping to at least `min_size` bytes
+    bool grow(size_t min_size);
+    
+    int fd_;
+    uint8_t* map_;
+    size_t mapped_size_;
+    size_t write_offset_;
+    uint64_t record_count_;
+};
+
+// Reads a whole trace file into memory (used by tools)
+class TraceReader {
+public:
+    bool open(const std::string& path);
+    
+    const TraceFileHeader& header() const { return header_; }
+    const std::vector<std::string>& task_ids() const { return task_ids_; }
+    const std::vector<TraceRecord>& records() const { return records_; }
+    
+    // Task id of a handle ("?" if the handle is not in the id table)
+    const std::string& task_id(uint32_t handle) const;
+
+private:
+    TraceFileHeader header_{};
+    std::vector<std::string> task_ids_;
+    std::vector<TraceRecord> records_;
+};
+
+} // namespace orchestrator
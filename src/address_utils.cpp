@@ -0,0 +1,124 @@
+#include "address_utils.h"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace orchestrator {
+
+bool AddressUtils::is_shm(const std::string& address) {
+    return address.compare(0, std::strlen(SHM_SCHEME), SHM_SCHEME) == 0;
+}
+
+std::string AddressUtils::strip_shm(const std::string& address) {
+    return is_shm(address) ? address.substr(std::strlen(SHM_SCHEME)) : address;
+}
+
+bool AddressUtils::is_unix(const std::string& address) {
+    return address.compare(0, std::strlen(UNIX_SCHEME), UNIX_SCHEME) == 0;
+}
+
+std::string AddressUtils::unix_path(const std::string& address) {
+    if (!is_unix(address)) {
+        return "";
+    }
+    
+    // "unix:///abs/path" and "unix:/abs/path" name the same socket
+    std::string path = address.substr(std::strlen(UNIX_SCHEME));
+    if (path.compare(0, 2, "//") == 0) {
+        path = path.substr(2);
+    }
+    return path;
+}
+
+bool AddressUtils::is_loopback(const std::string& address) {
+    if (is_unix(address)) {
+        return false;
+    }
+    
+    size_t colon = address.rfind(':');
+    std::string host = colon == std::string::npos ? address : address.substr(0, colon);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    return host == "localhost" || host == "::1" || host.compare(0, 4, "127.") == 0;
+}
+
+bool AddressUtils::is_local(const std::string& address) {
+    std::string grpc_address = strip_shm(address);
+    return is_unix(grpc_address) || is_loopback(grpc_address);
+}
+
+bool AddressUtils::is_valid(const std::string& address) {
+    if (is_unix(address)) {
+        return !unix_path(address).empty();
+    }
+    
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == address.size()) {
+        return false;
+    }
+    return address.find_first_not_of("0123456789", colon + 1) == std::string::npos;
+}
+
+bool AddressUtils::unix_socket_exists(const std::string& address) {
+    std::string path = unix_path(address);
+    struct stat st;
+    return !path.empty() && stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode);
+}
+
+bool AddressUtils::prepare_listen(const std::string& address) {
+    std::string path = unix_path(address);
+    if (path.empty()) {
+        return true;
+    }
+    
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0) {
+        return true;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        std::cerr << "[AddressUtils] " << path << " exists and is not a socket" << std::endl;
+        return false;
+    }
+    
+    // A socket nobody accepts on is left over from a previous run
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[AddressUtils] Socket path too long: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size());
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    bool in_use = connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+    close(fd);
+    
+    if (in_use) {
+        std::cerr << "[AddressUtils] " << path << " is in use by another process" << std::endl;
+        return false;
+    }
+    if (unlink(path.c_str()) != 0) {
+        std::cerr << "[AddressUtils] Cannot remove stale socket " << path << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void AddressUtils::remove_socket(const std::string& address) {
+    std::string path = unix_path(address);
+    if (!path.empty()) {
+        unlink(path.c_str());
+    }
+}
+
+} // namespace orchestrator
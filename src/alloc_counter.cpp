@@ -0,0 +1,58 @@
+#include "alloc_counter.h"
+#include <atomic>
+#include <cstddef>
+
+namespace orchestrator {
+
+namespace {
+// initial-exec TLS: reading the counter must never allocate (it runs inside malloc)
+__attribute__((tls_model("initial-exec"))) thread_local uint64_t t_allocations = 0;
+std::atomic<uint64_t> g_allocations{0};
+}
+
+#ifdef ORCHESTRATOR_COUNT_ALLOCATIONS
+bool AllocCounter::enabled() { return true; }
+#else
+bool AllocCounter::enabled() { return false; }
+#endif
+
+uint64_t AllocCounter::thread_allocations() {
+    return t_allocations;
+}
+
+uint64_t AllocCounter::total_allocations() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+#ifdef ORCHESTRATOR_COUNT_ALLOCATIONS
+static inline void count_allocation() {
+    t_allocations++;
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+} // namespace orchestrator
+
+#ifdef ORCHESTRATOR_COUNT_ALLOCATIONS
+// Interpose the glibc allocator entry points (operator new ends up here too)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+    orchestrator::count_allocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    orchestrator::count_allocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    orchestrator::count_allocation();
+    return __libc_realloc(ptr, size);
+}
+}
+#endif
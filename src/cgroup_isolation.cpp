@@ -0,0 +1,383 @@
+#include "cgroup_isolation.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace orchestrator {
+
+namespace {
+
+// True if a space-separated controller list contains `name`
+bool has_controller(const std::string& list, const char* name) {
+    std::istringstream stream(list);
+    std::string controller;
+    while (stream >> controller) {
+        if (controller == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Mount point of the cgroup v2 hierarchy ("" if none)
+std::string cgroup2_mount() {
+    std::ifstream mountinfo("/proc/self/mountinfo");
+    std::string line;
+    while (std::getline(mountinfo, line)) {
+        size_t separator = line.find(" - ");
+        if (separator == std::string::npos || line.compare(separator + 3, 8, "cgroup2 ") != 0) {
+            continue;
+        }
+        // Fields: id parent major:minor root mount_point ...
+        std::istringstream fields(line.substr(0, separator));
+        std::string field;
+        for (int i = 0; i < 5 && fields >> field; i++) {
+        }
+        return field;
+    }
+    return "";
+}
+
+} // namespace
+
+CgroupIsolation::CgroupIsolation()
+    : enabled_(false)
+    , has_cpuset_(false)
+    , has_memory_(false)
+    , exec_threads_fd_(-1)
+    , wrapper_threads_fd_(-1)
+    , cpu_max_fd_(-1)
+    , cpuset_fd_(-1)
+    , memory_max_fd_(-1)
+    , memory_current_fd_(-1)
+    , cpu_stat_fd_(-1) {}
+
+CgroupIsolation::~CgroupIsolation() {
+    release();
+    for (int fd : {exec_threads_fd_, wrapper_threads_fd_, cpu_max_fd_, cpuset_fd_, memory_max_fd_,
+                   memory_current_fd_, cpu_stat_fd_}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void CgroupIsolation::release() {
+    if (!enabled_) {
+        return;
+    }
+    enabled_ = false;
+    
+    // Bottom-up: a controller can only be disabled once no child uses it,
+    // and the process can only return to a cgroup without controllers
+    // enabled below it ("no internal processes" rule)
+    if (rmdir(exec_path_.c_str()) != 0) {
+        std::cerr << "[Cgroup] Cannot remove " << exec_path_ << ": " << strerror(errno) << std::endl;
+        return;
+    }
+    write_file(wrapper_path_ + "/cgroup.subtree_control", has_cpuset_ ? "-cpuset -cpu" : "-cpu");
+    if (origin_path_ == base_path_) {
+        for (auto it = base_controllers_.rbegin(); it != base_controllers_.rend(); ++it) {
+            write_file(base_path_ + "/cgroup.subtree_control", std::string("-") + *it);
+        }
+    }
+    
+    if (!write_file(origin_path_ + "/cgroup.procs", std::to_string(getpid()))) {
+        std::cerr << "[Cgroup] Cannot move the wrapper back to " << origin_path_ << " (" << strerror(errno)
+                  << "), leaving " << wrapper_path_ << " in place" << std::endl;
+        return;
+    }
+    if (rmdir(wrapper_path_.c_str()) != 0) {
+        std::cerr << "[Cgroup] Cannot remove " << wrapper_path_ << ": " << strerror(errno) << std::endl;
+        return;
+    }
+    std::cout << "[Cgroup] Removed " << wrapper_path_ << std::endl;
+}
+
+std::string CgroupIsolation::own_cgroup() {
+    std::ifstream cgroup("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(cgroup, line)) {
+        if (line.compare(0, 3, "0::") == 0) {
+            return line.substr(3);
+        }
+    }
+    return "";
+}
+
+bool CgroupIsolation::write_file(const std::string& path, const std::string& value) {
+    int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool written = write(fd, value.data(), value.size()) == static_cast<ssize_t>(value.size());
+    int error = errno;
+    close(fd);
+    errno = error;
+    return written;
+}
+
+std::string CgroupIsolation::read_file(const std::string& path) {
+    std::ifstream file(path);
+    std::string content;
+    std::getline(file, content);
+    return content;
+}
+
+bool CgroupIsolation::init(const std::string& name, const std::string& default_cpus, const std::string& root) {
+    enabled_ = setup(name, default_cpus, root);
+    if (enabled_) {
+        std::cout << "[Cgroup] Executions isolated in " << exec_path_ << " (cpu"
+                  << (has_cpuset_ ? ", cpuset" : "") << (has_memory_ ? ", memory" : "") << ")" << std::endl;
+    } else {
+        std::cerr << "[Cgroup] Running without cgroup isolation" << std::endl;
+    }
+    return enabled_;
+}
+
+bool CgroupIsolation::setup(const std::string& name, const std::string& default_cpus, const std::string& root) {
+    std::string mount = cgroup2_mount();
+    if (mount.empty()) {
+        std::cerr << "[Cgroup] No cgroup v2 hierarchy mounted" << std::endl;
+        return false;
+    }
+    origin_path_ = mount + own_cgroup();
+    while (origin_path_.size() > 1 && origin_path_.back() == '/') {
+        origin_path_.pop_back();
+    }
+    std::string base = root.empty() ? origin_path_ : mount + root;
+    while (base.size() > 1 && base.back() == '/') {
+        base.pop_back();
+    }
+    base_path_ = base;
+    base_controllers_.clear();
+    
+    std::string available = read_file(base + "/cgroup.controllers");
+    if (!has_controller(available, "cpu")) {
+        std::cerr << "[Cgroup] cpu controller not delegated to " << base
+                  << " (available: " << (available.empty() ? "none" : available) << ")" << std::endl;
+        return false;
+    }
+    has_cpuset_ = has_controller(available, "cpuset");
+    has_memory_ = has_controller(available, "memory");
+    
+    // The process leaves `base`, so controllers can be enabled below it
+    // ("no internal processes" rule for domain cgroups)
+    wrapper_path_ = base + "/" + name;
+    if (mkdir(wrapper_path_.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "[Cgroup] Cannot create " << wrapper_path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (!write_file(wrapper_path_ + "/cgroup.procs", std::to_string(getpid()))) {
+        std::cerr << "[Cgroup] Cannot move the wrapper into " << wrapper_path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    std::string enabled = read_file(base + "/cgroup.subtree_control");
+    if (!enable_controller(enabled, "cpu")) {
+        std::cerr << "[Cgroup] Cannot enable cpu below " << base << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (has_cpuset_ && !enable_controller(enabled, "cpuset")) {
+        has_cpuset_ = false;
+    }
+    if (has_memory_ && !enable_controller(enabled, "memory")) {
+        has_memory_ = false;
+    }
+    
+    // Threaded child: single threads of the process can be moved into it
+    exec_path_ = wrapper_path_ + "/exec";
+    if (mkdir(exec_path_.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "[Cgroup] Cannot create " << exec_path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (read_file(exec_path_ + "/cgroup.type") != "threaded" &&
+        !write_file(exec_path_ + "/cgroup.type", "threaded")) {
+        std::cerr << "[Cgroup] Cannot make " << exec_path_ << " threaded: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (!write_file(wrapper_path_ + "/cgroup.subtree_control", "+cpu")) {
+        std::cerr << "[Cgroup] Cannot enable cpu in " << wrapper_path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (has_cpuset_ && !write_file(wrapper_path_ + "/cgroup.subtree_control", "+cpuset")) {
+        has_cpuset_ = false;
+    }
+    
+    exec_threads_fd_ = open((exec_path_ + "/cgroup.threads").c_str(), O_WRONLY | O_CLOEXEC);
+    wrapper_threads_fd_ = open((wrapper_path_ + "/cgroup.threads").c_str(), O_WRONLY | O_CLOEXEC);
+    cpu_max_fd_ = open((exec_path_ + "/cpu.max").c_str(), O_WRONLY | O_CLOEXEC);
+    cpu_stat_fd_ = open((exec_path_ + "/cpu.stat").c_str(), O_RDONLY | O_CLOEXEC);
+    if (has_cpuset_) {
+        cpuset_fd_ = open((exec_path_ + "/cpuset.cpus").c_str(), O_WRONLY | O_CLOEXEC);
+    }
+    if (has_memory_) {
+        memory_max_fd_ = open((wrapper_path_ + "/memory.max").c_str(), O_WRONLY | O_CLOEXEC);
+        memory_current_fd_ = open((wrapper_path_ + "/memory.current").c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    if (exec_threads_fd_ < 0 || wrapper_threads_fd_ < 0 || cpu_max_fd_ < 0 || cpu_stat_fd_ < 0) {
+        std::cerr << "[Cgroup] Cannot open the control files of " << exec_path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    default_cpus_ = default_cpus;
+    if (!default_cpus_.empty() && !has_cpuset_) {
+        std::cerr << "[Cgroup] cpuset controller not available, ignoring CPUs " << default_cpus_ << std::endl;
+    }
+    return true;
+}
+
+bool CgroupIsolation::enable_controller(const std::string& enabled, const char* name) {
+    if (has_controller(enabled, name)) {
+        return true;
+    }
+    if (!write_file(base_path_ + "/cgroup.subtree_control", std::string("+") + name)) {
+        return false;
+    }
+    base_controllers_.push_back(name);
+    return true;
+}
+
+void CgroupIsolation::bandwidth_to_max(double cpu_bandwidth, int64_t estimated_duration_us,
+                                       int64_t& quota_us, int64_t& period_us) {
+    period_us = std::clamp(estimated_duration_us / PERIODS_PER_EXECUTION, MIN_PERIOD_US, MAX_PERIOD_US);
+    // The quota has the same 1 ms floor as the period
+    if (cpu_bandwidth * period_us < MIN_PERIOD_US) {
+        period_us = std::min(static_cast<int64_t>(MIN_PERIOD_US / cpu_bandwidth) + 1, MAX_PERIOD_US);
+    }
+    quota_us = std::max(static_cast<int64_t>(cpu_bandwidth * period_us), MIN_PERIOD_US);
+}
+
+bool CgroupIsolation::write_cached(int fd, std::string& cache, const char* value, const char* file) {
+    if (fd < 0 || cache == value) {
+        return true;
+    }
+    size_t length = strlen(value);
+    if (pwrite(fd, value, length, 0) != static_cast<ssize_t>(length)) {
+        std::cerr << "[Cgroup] Cannot write '" << value << "' to " << file << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    cache.assign(value);
+    return true;
+}
+
+bool CgroupIsolation::move_thread(int threads_fd) const {
+    char tid[24];
+    int length = snprintf(tid, sizeof(tid), "%ld", static_cast<long>(syscall(SYS_gettid)));
+    return pwrite(threads_fd, tid, length, 0) == length;
+}
+
+int64_t CgroupIsolation::read_memory_current() const {
+    char buffer[32];
+    ssize_t length = memory_current_fd_ >= 0 ? pread(memory_current_fd_, buffer, sizeof(buffer) - 1, 0) : -1;
+    if (length <= 0) {
+        return -1;
+    }
+    buffer[length] = '\0';
+    return strtoll(buffer, nullptr, 10);
+}
+
+bool CgroupIsolation::read_cpu_stat(CpuStat& stat) const {
+    char buffer[1024];
+    ssize_t length = pread(cpu_stat_fd_, buffer, sizeof(buffer) - 1, 0);
+    if (length <= 0) {
+        return false;
+    }
+    buffer[length] = '\0';
+    
+    // "key value" lines
+    for (char* line = buffer; line && *line; ) {
+        char* next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+        char* value = strchr(line, ' ');
+        if (value) {
+            *value++ = '\0';
+            unsigned long long number = strtoull(value, nullptr, 10);
+            if (strcmp(line, "usage_usec") == 0) {
+                stat.usage_us = static_cast<int64_t>(number);
+            } else if (strcmp(line, "nr_periods") == 0) {
+                stat.nr_periods = number;
+            } else if (strcmp(line, "nr_throttled") == 0) {
+                stat.nr_throttled = number;
+            } else if (strcmp(line, "throttled_usec") == 0) {
+                stat.throttled_us = static_cast<int64_t>(number);
+            }
+        }
+        line = next;
+    }
+    return true;
+}
+
+bool CgroupIsolation::enter(const Limits& limits, CpuStat& before) {
+    if (!enabled_) {
+        return false;
+    }
+    
+    // A limit that cannot be written is reported, the execution still runs
+    char value[64];
+    if (limits.cpu_bandwidth > 0) {
+        int64_t quota_us;
+        int64_t period_us;
+        bandwidth_to_max(limits.cpu_bandwidth, limits.estimated_duration_us, quota_us, period_us);
+        snprintf(value, sizeof(value), "%lld %lld", static_cast<long long>(quota_us), static_cast<long long>(period_us));
+    } else {
+        snprintf(value, sizeof(value), "max");
+    }
+    write_cached(cpu_max_fd_, cpu_max_, value, "cpu.max");
+    
+    // An empty cpuset.cpus inherits the wrapper's CPUs
+    const std::string& cpus = limits.cpus.empty() ? default_cpus_ : limits.cpus;
+    write_cached(cpuset_fd_, cpuset_, cpus.empty() ? "\n" : cpus.c_str(), "cpuset.cpus");
+    
+    // memory.max caps the whole wrapper: a limit it already exceeds would
+    // have the kernel reclaim or OOM-kill it, so it is refused
+    snprintf(value, sizeof(value), "max");
+    if (limits.memory_limit_bytes > 0 && memory_max_fd_ >= 0) {
+        int64_t current = read_memory_current();
+        if (current >= limits.memory_limit_bytes) {
+            std::cerr << "[Cgroup] Refusing memory limit of " << limits.memory_limit_bytes
+                      << " bytes: the wrapper already uses " << current << std::endl;
+        } else {
+            snprintf(value, sizeof(value), "%lld", static_cast<long long>(limits.memory_limit_bytes));
+        }
+    }
+    write_cached(memory_max_fd_, memory_max_, value, "memory.max");
+    
+    read_cpu_stat(before);
+    if (!move_thread(exec_threads_fd_)) {
+        std::cerr << "[Cgroup] Cannot move thread into " << exec_path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void CgroupIsolation::leave(const CpuStat& before, CpuStat& usage) {
+    if (!enabled_) {
+        return;
+    }
+    
+    CpuStat after;
+    read_cpu_stat(after);
+    if (!move_thread(wrapper_threads_fd_)) {
+        std::cerr << "[Cgroup] Cannot move thread back to " << wrapper_path_ << ": " << strerror(errno) << std::endl;
+    }
+    // The memory limit only holds for the execution
+    write_cached(memory_max_fd_, memory_max_, "max", "memory.max");
+    
+    usage.usage_us = after.usage_us - before.usage_us;
+    usage.nr_periods = after.nr_periods - before.nr_periods;
+    usage.nr_throttled = after.nr_throttled - before.nr_throttled;
+    usage.throttled_us = after.throttled_us - before.throttled_us;
+}
+
+} // namespace orchestrator
@@ -0,0 +1,198 @@
+#include "critical_path.h"
+#include "orchestrator.h"
+#include "timeline_export.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace orchestrator {
+
+void CriticalPath::build(const TaskTable& tasks, const std::vector<int64_t>& duration_us) {
+    size_t count = tasks.size();
+    duration_us_.assign(count, 0);
+    for (size_t h = 0; h < count && h < duration_us.size(); h++) {
+        duration_us_[h] = std::max<int64_t>(duration_us[h], 0);
+    }
+    bottom_level_us_.assign(count, 0);
+    dependents_.assign(count, {});
+    dependencies_.assign(count, {});
+    in_cycle_.assign(count, 1);
+    order_.assign(count, 0);
+    queued_.assign(count, 0);
+    stack_.clear();
+    stack_.reserve(count);
+    
+    for (TaskHandle h = 0; h < count; h++) {
+        dependents_[h] = tasks.dependents(h);
+        for (TaskHandle dependent : dependents_[h]) {
+            dependencies_[dependent].push_back(h);
+        }
+    }
+    
+    // Sinks first: a task's bottom level is known once all its dependents' are
+    std::vector<size_t> remaining(count);
+    std::vector<TaskHandle> ready;
+    for (TaskHandle h = 0; h < count; h++) {
+        remaining[h] = dependents_[h].size();
+        if (remaining[h] == 0) {
+            ready.push_back(h);
+        }
+    }
+    uint32_t position = 0;
+    while (!ready.empty()) {
+        TaskHandle h = ready.back();
+        ready.pop_back();
+        in_cycle_[h] = 0;
+        order_[h] = position++;
+        bottom_level_us_[h] = compute(h);
+        for (TaskHandle dependency : dependencies_[h]) {
+            if (--remaining[dependency] == 0) {
+                ready.push_back(dependency);
+            }
+        }
+    }
+    
+    // Whatever is left sits on (or behind) a cycle
+    for (TaskHandle h = 0; h < count; h++) {
+        if (in_cycle_[h]) {
+            bottom_level_us_[h] = duration_us_[h];
+        }
+    }
+}
+
+int64_t CriticalPath::compute(TaskHandle handle) const {
+    int64_t longest = 0;
+    for (TaskHandle dependent : dependents_[handle]) {
+        longest = std::max(longest, bottom_level_us_[dependent]);
+    }
+    return duration_us_[handle] + longest;
+}
+
+void CriticalPath::update_duration(TaskHandle handle, int64_t duration_us) {
+    if (handle >= duration_us_.size()) {
+        return;
+    }
+    duration_us_[handle] = std::max<int64_t>(duration_us, 0);
+    if (in_cycle_[handle]) {
+        bottom_level_us_[handle] = duration_us_[handle];
+        return;
+    }
+    
+    // Visit the affected tasks in topological order (dependents before their
+    // dependencies), so each is recomputed once
+    auto later = [this](TaskHandle a, TaskHandle b) { return order_[a] > order_[b]; };
+    stack_.clear();
+    stack_.push_back(handle);
+    queued_[handle] = 1;
+    while (!stack_.empty()) {
+        std::pop_heap(stack_.begin(), stack_.end(), later);
+        TaskHandle h = stack_.back();
+        stack_.pop_back();
+        queued_[h] = 0;
+        
+        int64_t level = compute(h);
+        if (level == bottom_level_us_[h]) {
+            continue;
+        }
+        bottom_level_us_[h] = level;
+        for (TaskHandle dependency : dependencies_[h]) {
+            if (!queued_[dependency] && !in_cycle_[dependency]) {
+                queued_[dependency] = 1;
+                stack_.push_back(dependency);
+                std::push_heap(stack_.begin(), stack_.end(), later);
+            }
+        }
+    }
+}
+
+int64_t CriticalPath::length_us() const {
+    int64_t longest = 0;
+    for (int64_t level : bottom_level_us_) {
+        longest = std::max(longest, level);
+    }
+    return longest;
+}
+
+std::vector<TaskHandle> CriticalPath::path() const {
+    std::vector<TaskHandle> path;
+    if (bottom_level_us_.empty()) {
+        return path;
+    }
+    
+    // The largest bottom level starts the path; follow the heaviest dependent
+    TaskHandle h = static_cast<TaskHandle>(std::max_element(bottom_level_us_.begin(), bottom_level_us_.end()) -
+                                           bottom_level_us_.begin());
+    while (path.size() < bottom_level_us_.size()) {
+        path.push_back(h);
+        if (in_cycle_[h] || dependents_[h].empty()) {
+            break;
+        }
+        h = *std::max_element(dependents_[h].begin(), dependents_[h].end(), [this](TaskHandle a, TaskHandle b) {
+            return bottom_level_us_[a] < bottom_level_us_[b];
+        });
+    }
+    return path;
+}
+
+std::vector<CriticalPathStep> CriticalPath::from_history(const std::vector<TaskExecution>& history,
+                                                         const std::vector<TimelineDependency>& dependencies) {
+    std::vector<CriticalPathStep> steps;
+    if (history.empty()) {
+        return steps;
+    }
+    
+    std::unordered_map<std::string, std::vector<size_t>> executions;
+    for (size_t i = 0; i < history.size(); i++) {
+        executions[history[i].task_id].push_back(i);
+    }
+    std::unordered_map<std::string, std::vector<std::string>> depends_on;
+    for (const TimelineDependency& dependency : dependencies) {
+        depends_on[dependency.task_id].push_back(dependency.depends_on);
+    }
+    
+    // The execution that ended last, then the dependency end that released each step
+    size_t current = 0;
+    for (size_t i = 1; i < history.size(); i++) {
+        if (history[i].end_time_us > history[current].end_time_us) {
+            current = i;
+        }
+    }
+    std::vector<size_t> chain;
+    while (chain.size() < history.size()) {
+        chain.push_back(current);
+        const TaskExecution& exec = history[current];
+        
+        size_t previous = history.size();
+        auto deps = depends_on.find(exec.task_id);
+        if (deps != depends_on.end()) {
+            for (const std::string& dependency : deps->second) {
+                auto runs = executions.find(dependency);
+                if (runs == executions.end()) {
+                    continue;
+                }
+                for (size_t run : runs->second) {
+                    if (run != current && history[run].end_time_us <= exec.actual_start_time_us &&
+                        (previous == history.size() || history[run].end_time_us > history[previous].end_time_us)) {
+                        previous = run;
+                    }
+                }
+            }
+        }
+        if (previous == history.size()) {
+            break;
+        }
+        current = previous;
+    }
+    
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        const TaskExecution& exec = history[*it];
+        CriticalPathStep step;
+        step.task_id = exec.task_id;
+        step.start_us = exec.actual_start_time_us;
+        step.end_us = exec.end_time_us;
+        step.wait_us = steps.empty() ? 0 : exec.actual_start_time_us - steps.back().end_us;
+        steps.push_back(step);
+    }
+    return steps;
+}
+
+} // namespace orchestrator
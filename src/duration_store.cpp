@@ -0,0 +1,132 @@
+#include "duration_store.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <yaml-cpp/yaml.h>
+
+namespace orchestrator {
+
+void TaskDurationStats::add(int64_t duration_us) {
+    duration_us = std::max<int64_t>(duration_us, 0);
+    if (executions == 0) {
+        ewma_us = duration_us;
+        min_us = duration_us;
+    } else {
+        ewma_us += (duration_us - ewma_us) >> EWMA_SHIFT;
+        min_us = std::min(min_us, duration_us);
+    }
+    wcet_us = std::max(wcet_us, duration_us);
+    executions++;
+    
+    if (recent_us.size() < RECENT_SAMPLES) {
+        recent_us.reserve(RECENT_SAMPLES);
+        recent_us.push_back(duration_us);
+        next = recent_us.size() % RECENT_SAMPLES;
+    } else {
+        recent_us[next] = duration_us;
+        next = (next + 1) % RECENT_SAMPLES;
+    }
+}
+
+int64_t TaskDurationStats::percentile(double p) const {
+    if (recent_us.empty()) {
+        return 0;
+    }
+    std::vector<int64_t> sorted = recent_us;
+    size_t rank = static_cast<size_t>(std::clamp(p, 0.0, 100.0) / 100.0 * (sorted.size() - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+std::vector<int64_t> TaskDurationStats::samples() const {
+    if (recent_us.size() < RECENT_SAMPLES) {
+        return recent_us;
+    }
+    std::vector<int64_t> ordered(recent_us.begin() + next, recent_us.end());
+    ordered.insert(ordered.end(), recent_us.begin(), recent_us.begin() + next);
+    return ordered;
+}
+
+const TaskDurationStats* DurationStore::find(const std::string& task_id) const {
+    auto it = tasks_.find(task_id);
+    return it != tasks_.end() ? &it->second : nullptr;
+}
+
+bool DurationStore::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "[DurationStore] No statistics at " << path << " yet, starting empty" << std::endl;
+        return true;
+    }
+    
+    try {
+        YAML::Node root = YAML::Load(file);
+        YAML::Node tasks = root["tasks"];
+        for (YAML::const_iterator it = tasks.begin(); it != tasks.end(); ++it) {
+            const YAML::Node& node = it->second;
+            TaskDurationStats& stats = tasks_[it->first.as<std::string>()];
+            stats = TaskDurationStats();
+            stats.executions = node["executions"].as<uint64_t>(0);
+            stats.ewma_us = node["ewma_us"].as<int64_t>(0);
+            stats.min_us = node["min_us"].as<int64_t>(0);
+            stats.wcet_us = node["wcet_us"].as<int64_t>(0);
+            if (node["recent_us"]) {
+                for (size_t i = 0; i < node["recent_us"].size() && i < TaskDurationStats::RECENT_SAMPLES; i++) {
+                    stats.recent_us.push_back(node["recent_us"][i].as<int64_t>());
+                }
+            }
+            stats.next = stats.recent_us.size() % TaskDurationStats::RECENT_SAMPLES;
+        }
+    } catch (const YAML::Exception& e) {
+        std::cerr << "[DurationStore] Error reading " << path << ": " << e.what() << std::endl;
+        tasks_.clear();
+        return false;
+    }
+    
+    std::cout << "[DurationStore] Loaded statistics of " << tasks_.size() << " tasks from " << path << std::endl;
+    return true;
+}
+
+bool DurationStore::save(const std::string& path) const {
+    // Stable output: task ids in order
+    std::vector<const std::pair<const std::string, TaskDurationStats>*> entries;
+    for (const auto& entry : tasks_) {
+        if (entry.second.executions > 0) {
+            entries.push_back(&entry);
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+    
+    YAML::Emitter out;
+    out << YAML::BeginMap << YAML::Key << "tasks" << YAML::Value << YAML::BeginMap;
+    for (const auto* entry : entries) {
+        const TaskDurationStats& stats = entry->second;
+        out << YAML::Key << entry->first << YAML::Value << YAML::Flow << YAML::BeginMap
+            << YAML::Key << "executions" << YAML::Value << stats.executions
+            << YAML::Key << "ewma_us" << YAML::Value << stats.ewma_us
+            << YAML::Key << "min_us" << YAML::Value << stats.min_us
+            << YAML::Key << "wcet_us" << YAML::Value << stats.wcet_us
+            << YAML::Key << "recent_us" << YAML::Value << YAML::Flow << stats.samples()
+            << YAML::EndMap;
+    }
+    out << YAML::EndMap << YAML::EndMap;
+    
+    // A crash while writing leaves the previous store intact
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file || !(file << out.c_str() << "\n")) {
+            std::cerr << "[DurationStore] Cannot write " << temporary << std::endl;
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "[DurationStore] Cannot replace " << path << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace orchestrator
@@ -0,0 +1,179 @@
+#include "endpoint_pool.h"
+#include "address_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace orchestrator {
+
+EndpointId EndpointPool::add(const std::string& address) {
+    auto it = index_.find(address);
+    if (it != index_.end()) {
+        return it->second;
+    }
+    
+    auto endpoint = std::make_unique<Endpoint>();
+    endpoint->address = address;
+    
+    // shm://<host:port>: gRPC stays available at <host:port>
+    endpoint->grpc_address = AddressUtils::strip_shm(address);
+    endpoint->shm_requested = AddressUtils::is_shm(address);
+    endpoint->channel = make_channel(endpoint->grpc_address);
+    endpoint->stub = TaskService::NewStub(endpoint->channel);
+    
+    EndpointId id = static_cast<EndpointId>(endpoints_.size());
+    endpoints_.push_back(std::move(endpoint));
+    index_.emplace(address, id);
+    return id;
+}
+
+void EndpointPool::clear() {
+    disconnect_shm();
+    endpoints_.clear();
+    index_.clear();
+}
+
+std::shared_ptr<grpc::Channel> EndpointPool::make_channel(const std::string& address) {
+    grpc::ChannelArguments args;
+    args.SetInt(GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS, RECONNECT_BACKOFF_MS);
+    args.SetInt(GRPC_ARG_MIN_RECONNECT_BACKOFF_MS, RECONNECT_BACKOFF_MS);
+    args.SetInt(GRPC_ARG_MAX_RECONNECT_BACKOFF_MS, MAX_RECONNECT_BACKOFF_MS);
+    return grpc::CreateCustomChannel(address, grpc::InsecureChannelCredentials(), args);
+}
+
+size_t EndpointPool::wait_ready(int64_t timeout_us) {
+    bool wait = timeout_us > 0;
+    auto deadline = std::chrono::system_clock::now() +
+        (wait ? std::chrono::microseconds(timeout_us) : std::chrono::microseconds(DISCOVERY_TIMEOUT_MS * 1000));
+    
+    // One prober per endpoint: the barrier lasts as long as the slowest wrapper
+    std::vector<std::thread> probers;
+    probers.reserve(endpoints_.size());
+    for (auto& endpoint : endpoints_) {
+        probers.emplace_back(&EndpointPool::probe, this, std::ref(*endpoint), deadline, wait);
+    }
+    for (std::thread& prober : probers) {
+        prober.join();
+    }
+    
+    size_t ready = 0;
+    for (auto& endpoint : endpoints_) {
+        const EndpointReadiness& readiness = endpoint->readiness;
+        if (readiness.ready) {
+            ready++;
+            std::cout << "[EndpointPool] " << endpoint->address << " ready after "
+                      << readiness.ready_us / 1000.0 << " ms (" << readiness.transport << ")" << std::endl;
+        } else {
+            std::cerr << "[EndpointPool] " << endpoint->address << " not ready: "
+                      << readiness.error << std::endl;
+        }
+    }
+    return ready;
+}
+
+void EndpointPool::probe(Endpoint& endpoint, std::chrono::system_clock::time_point deadline, bool wait) {
+    EndpointReadiness& readiness = endpoint.readiness;
+    readiness = EndpointReadiness();
+    readiness.transport = AddressUtils::is_unix(endpoint.grpc_address) ? "unix" : "tcp";
+    auto begin = std::chrono::steady_clock::now();
+    
+    TaskStatusRequest request;
+    TaskStatusResponse response;
+    grpc::ClientContext context;
+    context.set_deadline(deadline);
+    context.set_wait_for_ready(wait);
+    grpc::Status status = endpoint.stub->GetTaskStatus(&context, request, &response);
+    if (!status.ok()) {
+        readiness.error = status.error_message();
+        return;
+    }
+    
+    // Same host: the advertised socket file is visible here
+    if (AddressUtils::is_loopback(endpoint.grpc_address) &&
+        AddressUtils::unix_socket_exists(response.uds_address())) {
+        std::shared_ptr<grpc::Channel> channel = make_channel(response.uds_address());
+        if (channel->WaitForConnected(deadline)) {
+            endpoint.channel = channel;
+            endpoint.stub = TaskService::NewStub(channel);
+            readiness.transport = "uds";
+        }
+    }
+    
+    if (endpoint.shm_requested) {
+        if (response.shm_name().empty()) {
+            std::cerr << "[EndpointPool] " << endpoint.address
+                      << ": no shared-memory channel advertised, using gRPC" << std::endl;
+        } else {
+            auto client = std::make_unique<ShmClient>(end_handler_);
+            if (client->connect(response.shm_name())) {
+                endpoint.shm = std::move(client);
+                readiness.transport = "shm";
+            } else {
+                std::cerr << "[EndpointPool] " << endpoint.address << ": cannot attach to channel '"
+                          << response.shm_name() << "', using gRPC" << std::endl;
+            }
+        }
+    }
+    
+    readiness.ready = true;
+    readiness.ready_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+}
+
+void EndpointPool::disconnect_shm() {
+    for (auto& endpoint : endpoints_) {
+        if (endpoint->shm) {
+            endpoint->shm->disconnect();
+        }
+    }
+}
+
+size_t EndpointPool::select(const std::vector<EndpointId>& replicas, uint64_t tried_mask,
+                            int64_t now_us) const {
+    size_t best = replicas.size();
+    bool best_healthy = false;
+    int64_t best_load = 0;
+    
+    size_t count = std::min(replicas.size(), MAX_TASK_REPLICAS);
+    for (size_t i = 0; i < count; i++) {
+        EndpointId id = replicas[i];
+        if ((tried_mask & (uint64_t(1) << i)) || quarantined(id)) {
+            continue;
+        }
+        const Endpoint& endpoint = *endpoints_[id];
+        
+        // Endpoints without a latency sample count as 1 us, so they get tried early
+        int64_t latency = std::max<int64_t>(endpoint.latency_ewma_us.load(std::memory_order_relaxed), 1);
+        int64_t load = (endpoint.in_flight.load(std::memory_order_relaxed) + 1) * latency;
+        bool is_healthy = healthy(id, now_us);
+        
+        if (best == replicas.size() ||
+            (is_healthy && !best_healthy) ||
+            (is_healthy == best_healthy && load < best_load)) {
+            best = i;
+            best_healthy = is_healthy;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+void EndpointPool::record_success(EndpointId id, int64_t latency_us) {
+    Endpoint& endpoint = *endpoints_[id];
+    endpoint.unavailable_until_us.store(0, std::memory_order_relaxed);
+    
+    int64_t ewma = endpoint.latency_ewma_us.load(std::memory_order_relaxed);
+    if (ewma == 0) {
+        ewma = latency_us;
+    } else {
+        ewma += (latency_us - ewma) >> EWMA_SHIFT;
+    }
+    endpoint.latency_ewma_us.store(std::max<int64_t>(ewma, 1), std::memory_order_relaxed);
+}
+
+void EndpointPool::record_unavailable(EndpointId id, int64_t now_us) {
+    endpoints_[id]->unavailable_until_us.store(now_us + UNAVAILABLE_COOLDOWN_US, std::memory_order_relaxed);
+}
+
+} // namespace orchestrator
@@ -0,0 +1,65 @@
+#include "execution_history.h"
+#include <algorithm>
+#include <cstring>
+
+namespace orchestrator {
+
+ExecutionHistory::ExecutionHistory(size_t capacity)
+    : capacity_(0)
+    , head_(0) {
+    reset(capacity);
+}
+
+void ExecutionHistory::reset(size_t capacity) {
+    capacity_ = std::max<size_t>(capacity, 1);
+    slots_.reset(new Slot[capacity_]);
+    for (size_t i = 0; i < capacity_; i++) {
+        slots_[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    head_.store(0, std::memory_order_release);
+}
+
+void ExecutionHistory::push(const ExecutionRecord& record) {
+    uint64_t pos = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[pos % capacity_];
+    
+    slot.sequence.store(2 * pos + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.record, &record, sizeof(ExecutionRecord));
+    slot.sequence.store(2 * pos + 2, std::memory_order_release);
+    
+    head_.store(pos + 1, std::memory_order_release);
+}
+
+void ExecutionHistory::snapshot(std::vector<ExecutionRecord>& out) const {
+    out.clear();
+    
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t first = head > capacity_ ? head - capacity_ : 0;
+    out.reserve(static_cast<size_t>(head - first));
+    
+    for (uint64_t pos = first; pos < head; pos++) {
+        const Slot& slot = slots_[pos % capacity_];
+        
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != 2 * pos + 2) {
+            continue;  // Already overwritten by a newer record
+        }
+        
+        ExecutionRecord record;
+        std::memcpy(&record, &slot.record, sizeof(ExecutionRecord));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        
+        if (slot.sequence.load(std::memory_order_relaxed) != before) {
+            continue;  // Overwritten while copying
+        }
+        out.push_back(record);
+    }
+}
+
+size_t ExecutionHistory::size() const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    return static_cast<size_t>(std::min<uint64_t>(head, capacity_));
+}
+
+} // namespace orchestrator
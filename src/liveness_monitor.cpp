@@ -0,0 +1,180 @@
+#include "liveness_monitor.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace orchestrator {
+
+LivenessMonitor::LivenessMonitor(EndpointPool& pool, StateHandler on_change)
+    : pool_(pool)
+    , on_change_(std::move(on_change))
+    , running_(false)
+    , interval_us_(0)
+    , window_us_(0) {}
+
+LivenessMonitor::~LivenessMonitor() {
+    stop();
+}
+
+int64_t LivenessMonitor::now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LivenessMonitor::start(int64_t interval_us, int missed_beats) {
+    if (running_.exchange(true)) {
+        return;
+    }
+    
+    interval_us_ = std::max<int64_t>(interval_us, 1000);
+    window_us_ = interval_us_ * std::max(missed_beats, 1);
+    
+    peers_.clear();
+    for (size_t i = 0; i < pool_.size(); i++) {
+        peers_.push_back(std::make_unique<Peer>());
+    }
+    for (size_t i = 0; i < peers_.size(); i++) {
+        peers_[i]->reader = std::thread(&LivenessMonitor::reader_loop, this, static_cast<EndpointId>(i));
+    }
+    watchdog_ = std::thread(&LivenessMonitor::watchdog_loop, this);
+    
+    std::cout << "[Liveness] Monitoring " << peers_.size() << " endpoints (beat every "
+              << interval_us_ / 1000.0 << " ms, down after " << window_us_ / 1000.0 << " ms)" << std::endl;
+}
+
+void LivenessMonitor::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    
+    // Break every open stream, then wake the threads sleeping between retries
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& peer : peers_) {
+            if (peer->stream) {
+                peer->stream->TryCancel();
+            }
+        }
+        stop_cv_.notify_all();
+    }
+    
+    for (auto& peer : peers_) {
+        if (peer->reader.joinable()) {
+            peer->reader.join();
+        }
+    }
+    if (watchdog_.joinable()) {
+        watchdog_.join();
+    }
+}
+
+void LivenessMonitor::wait(int64_t timeout_us) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_cv_.wait_for(lock, std::chrono::microseconds(timeout_us), [this]() { return !running_; });
+}
+
+void LivenessMonitor::reader_loop(EndpointId id) {
+    Peer& peer = *peers_[id];
+    HeartbeatRequest request;
+    request.set_interval_us(interval_us_);
+    HeartbeatBeat beat;
+    
+    while (running_) {
+        grpc::ClientContext context;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                break;
+            }
+            peer.stream = &context;
+        }
+        
+        std::unique_ptr<grpc::ClientReader<HeartbeatBeat>> reader = pool_.stub(id)->Heartbeat(&context, request);
+        while (reader->Read(&beat)) {
+            peer.rt_execution.store(beat.rt_execution(), std::memory_order_relaxed);
+            peer.last_beat_us.store(now_us(), std::memory_order_relaxed);
+            if (peer.beats.fetch_add(1, std::memory_order_relaxed) == 0 || pool_.quarantined(id)) {
+                set_state(id, PEER_ALIVE, "heartbeat received");
+            }
+        }
+        grpc::Status status = reader->Finish();
+        peer.rt_execution.store(false, std::memory_order_relaxed);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            peer.stream = nullptr;
+        }
+        if (!running_) {
+            break;
+        }
+        
+        if (status.error_code() == grpc::StatusCode::UNIMPLEMENTED) {
+            std::cerr << "[Liveness] " << pool_.address(id)
+                      << " does not support heartbeats, not monitored" << std::endl;
+            break;
+        }
+        
+        // Stream broken or never opened: unreachable until beats resume
+        set_state(id, PEER_DOWN, status.ok() ? "heartbeat stream closed" : status.error_message().c_str());
+        wait(interval_us_);
+    }
+}
+
+void LivenessMonitor::watchdog_loop() {
+    while (running_) {
+        wait(interval_us_ / 2);
+        
+        int64_t now = now_us();
+        for (size_t i = 0; i < peers_.size(); i++) {
+            Peer& peer = *peers_[i];
+            int64_t last_beat_us = peer.last_beat_us.load(std::memory_order_relaxed);
+            if (last_beat_us == 0 || now - last_beat_us <= window_us_ ||
+                pool_.rt_in_flight(static_cast<EndpointId>(i)) > 0 ||
+                peer.rt_execution.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            
+            bool alive;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                alive = peer.state == PEER_ALIVE;
+            }
+            if (!alive) {
+                continue;
+            }
+            
+            // Silent but connected (hung or starved process): drop the
+            // stream so the reader reconnects once the wrapper answers again
+            set_state(static_cast<EndpointId>(i), PEER_DOWN, "no heartbeat within the window");
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (peer.stream) {
+                peer.stream->TryCancel();
+            }
+        }
+    }
+}
+
+void LivenessMonitor::set_state(EndpointId id, PeerState state, const char* reason) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Peer& peer = *peers_[id];
+        if (peer.state == state) {
+            return;
+        }
+        peer.state = state;
+        pool_.set_quarantined(id, state == PEER_DOWN);
+    }
+    
+    if (state == PEER_DOWN) {
+        std::cerr << "[Liveness] " << pool_.address(id) << " is down (" << reason
+                  << "), quarantined" << std::endl;
+    } else {
+        std::cout << "[Liveness] " << pool_.address(id) << " is alive (" << reason << ")" << std::endl;
+    }
+    
+    if (on_change_) {
+        on_change_(id, state == PEER_ALIVE);
+    }
+}
+
+} // namespace orchestrator
@@ -1,8 +1,12 @@
 #include "orchestrator.h"
+#include "alloc_counter.h"
+#include "timeline_export.h"
+#include "address_utils.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
 #include <algorithm>
+#include <future>
 #include <pthread.h>
 
 namespace orchestrator {
@@ -35,6 +39,29 @@ grpc::Status OrchestratorServiceImpl::NotifyTaskEnd(
     return grpc::Status::OK;
 }
 
+grpc::Status OrchestratorServiceImpl::NotifyTaskEnds(
+    grpc::ServerContext* context,
+    const TaskEndBatch* request,
+    TaskEndResponse* response) {
+    
+    int64_t absolute_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (const TaskEndNotification& notification : request->notifications()) {
+        std::cout << "[" << std::setw(13) << absolute_time_ms << " ms] "
+                  << "← Task " << notification.task_id() 
+                  << " completed (result: " << notification.result() 
+                  << ", duration: " << notification.execution_duration_us() / 1000.0 << " ms, batched)" 
+                  << std::endl;
+        
+        orchestrator_->on_task_end(notification);
+    }
+    
+    response->set_acknowledged(true);
+    response->set_message("Task end notifications received");
+    
+    return grpc::Status::OK;
+}
+
 grpc::Status OrchestratorServiceImpl::HealthCheck(
     grpc::ServerContext* context,
     const HealthCheckRequest* request,
@@ -57,10 +84,36 @@ Orchestrator::Orchestrator(const std::string& listen_address)
     : listen_address_(listen_address)
     , next_task_index_(0)
     , start_time_us_(0)
+    , start_system_time_us_(0)
     , running_(false)
+    , history_capacity_(ExecutionHistory::DEFAULT_CAPACITY)
+    , critical_path_priority_(true)
+    , budget_margin_(DEFAULT_BUDGET_MARGIN)
+    , dispatch_allocations_(0)
+    , dispatch_count_(0)
+    , liveness_(endpoints_, [this](EndpointId endpoint, bool alive) { on_endpoint_state(endpoint, alive); })
+    , heartbeat_interval_us_(0)
+    , heartbeat_missed_beats_(LivenessMonitor::DEFAULT_MISSED_BEATS)
+    , ready_timeout_us_(DEFAULT_READY_TIMEOUT_US)
+    , max_inflight_dispatches_(DEFAULT_MAX_INFLIGHT_DISPATCHES)
+    , max_start_batch_(1)
+    , prearm_lead_us_(0)
     , pending_tasks_(0) {
     
     service_ = std::make_unique<OrchestratorServiceImpl>(this);
+    
+    // Task ends of starts sent over shared memory
+    endpoints_.set_end_handler([this](const TaskEndNotification& notification) {
+        int64_t absolute_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        std::cout << "[" << std::setw(13) << absolute_time_ms << " ms] "
+                  << "← Task " << notification.task_id() 
+                  << " completed (result: " << notification.result() 
+                  << ", duration: " << notification.execution_duration_us() / 1000.0 << " ms, shm)" 
+                  << std::endl;
+        
+        on_task_end(notification);
+    });
 }
 
 Orchestrator::~Orchestrator() {
@@ -73,8 +126,227 @@ void Orchestrator::load_schedule(const TaskSchedule& schedule) {
     schedule_.sort_by_time();
     next_task_index_ = 0;
     
+    // Intern task ids into dense handles
+    tasks_.clear();
+    schedule_handles_.clear();
+    schedule_handles_.reserve(schedule_.tasks.size());
+    for (const ScheduledTask& task : schedule_.tasks) {
+        TaskHandle handle = tasks_.intern(task.task_id);
+        tasks_.scheduled_time_us[handle] = task.scheduled_time_us;
+        schedule_handles_.push_back(handle);
+    }
+    
+    // Resolve dependencies to handles
+    for (size_t i = 0; i < schedule_.tasks.size(); i++) {
+        const ScheduledTask& task = schedule_.tasks[i];
+        for (const std::string& dependency : task.dependencies()) {
+            if (tasks_.find(dependency) == INVALID_TASK_HANDLE) {
+                std::cerr << "[Orchestrator] Warning: task " << task.task_id
+                          << " depends on unknown task " << dependency << std::endl;
+            }
+            tasks_.add_dependency(schedule_handles_[i], tasks_.intern(dependency));
+        }
+    }
+    
+    // Declared estimates (an id listed several times counts its longest) and
+    // the statistics learned in previous runs
+    declared_duration_us_.assign(tasks_.size(), 0);
+    duration_declared_.assign(tasks_.size(), 0);
+    for (size_t i = 0; i < schedule_.tasks.size(); i++) {
+        TaskHandle handle = schedule_handles_[i];
+        declared_duration_us_[handle] = std::max(declared_duration_us_[handle], schedule_.tasks[i].estimated_duration_us);
+        duration_declared_[handle] |= schedule_.tasks[i].estimate_declared;
+    }
+    duration_stats_.assign(tasks_.size(), nullptr);
+    budget_us_.assign(tasks_.size(), 0);
+    over_budget_.assign(tasks_.size(), 0);
+    watched_.clear();
+    watched_.reserve(tasks_.size());
+    is_watched_.assign(tasks_.size(), 0);
+    overruns_.assign(tasks_.size(), 0);
+    if (!duration_store_path_.empty()) {
+        for (TaskHandle handle = 0; handle < tasks_.size(); handle++) {
+            TaskDurationStats& stats = durations_.get(tasks_.id(handle));
+            duration_stats_[handle] = &stats;
+            if (stats.executions >= MIN_BUDGET_SAMPLES) {
+                budget_us_[handle] = static_cast<int64_t>(stats.wcet_us * budget_margin_);
+            }
+        }
+    }
+    
+    // Bottom levels from the expected durations
+    std::vector<int64_t> durations(tasks_.size(), 0);
+    for (TaskHandle handle = 0; handle < tasks_.size(); handle++) {
+        durations[handle] = expected_duration_us(handle);
+    }
+    critical_path_.build(tasks_, durations);
+    
+    // Outputs of a previous schedule are not passed on
+    release_all_outputs();
+    task_outputs_.assign(tasks_.size(), {});
+    waiting_consumers_.assign(tasks_.size(), {});
+    held_inputs_.assign(tasks_.size(), {});
+    
+    // No output read yet: every dependency passes the digest of no outputs
+    output_digest_.assign(tasks_.size(), ResultCache::digest(google::protobuf::RepeatedPtrField<TaskOutput>()));
+    feeds_cacheable_.assign(tasks_.size(), 0);
+    cache_key_.assign(tasks_.size(), 0);
+    for (size_t i = 0; i < schedule_.tasks.size() && result_cache_.is_open(); i++) {
+        if (schedule_.tasks[i].cacheable) {
+            for (TaskHandle producer : tasks_.dependencies(schedule_handles_[i])) {
+                feeds_cacheable_[producer] = 1;
+            }
+        }
+    }
+    
+    tasks_.reset_runtime();
+    history_.reset(history_capacity_);
+    release_queue_.clear();
+    release_queue_.reserve(schedule_.tasks.size());
+    
+    build_dispatch_cache();
+    
     std::cout << "[Orchestrator] Loaded schedule with " 
               << schedule_.tasks.size() << " tasks" << std::endl;
+    std::vector<TaskHandle> path = critical_path_.path();
+    if (path.size() > 1) {
+        std::cout << "[Orchestrator] Estimated critical path: " << critical_path_.length_us() / 1000.0
+                  << " ms through " << path.size() << " tasks (" << tasks_.id(path.front())
+                  << " → " << tasks_.id(path.back()) << ")" << std::endl;
+    }
+}
+
+void Orchestrator::build_dispatch_cache() {
+    // Start requests are built once here; dispatch only patches the timing fields
+    start_requests_.clear();
+    arm_requests_.clear();
+    request_arena_ = std::make_unique<google::protobuf::Arena>();
+    start_requests_.reserve(schedule_.tasks.size());
+    arm_requests_.reserve(schedule_.tasks.size());
+    
+    for (size_t i = 0; i < schedule_.tasks.size(); i++) {
+        const ScheduledTask& task = schedule_.tasks[i];
+        
+        // Timed tasks may be pre-armed: their start request lives inside the arm request
+        StartTaskRequest* request;
+        if (task.execution_mode == TASK_MODE_TIMED) {
+            ArmTaskRequest* arm_request =
+                google::protobuf::Arena::CreateMessage<ArmTaskRequest>(request_arena_.get());
+            arm_requests_.push_back(arm_request);
+            request = arm_request->mutable_start();
+        } else {
+            arm_requests_.push_back(nullptr);
+            request = google::protobuf::Arena::CreateMessage<StartTaskRequest>(request_arena_.get());
+        }
+        request->set_task_id(task.task_id);
+        request->set_scheduled_time_us(task.scheduled_time_us);
+        request->set_deadline_us(task.deadline_us);
+        request->set_priority(task.priority);
+        request->set_rt_policy(task.rt_policy);
+        request->set_rt_priority(task.rt_priority);
+        request->set_cpu_affinity(task.cpu_affinity);
+        request->set_cpu_list(task.cpu_list);
+        request->set_estimated_duration_us(expected_duration_us(schedule_handles_[i]));
+        request->set_cpu_bandwidth(task.cpu_bandwidth);
+        request->set_memory_limit_bytes(task.memory_limit_bytes);
+        request->set_task_handle(schedule_handles_[i]);
+        
+        for (const auto& param : task.parameters) {
+            (*request->mutable_parameters())[param.first] = param.second;
+        }
+        start_requests_.push_back(request);
+    }
+    
+    // One channel/stub per distinct address, reused by every dispatch
+    endpoints_.clear();
+    task_endpoints_.clear();
+    task_endpoints_.reserve(schedule_.tasks.size());
+    remote_replicas_.assign(schedule_.tasks.size(), 0);
+    for (const ScheduledTask& task : schedule_.tasks) {
+        std::vector<EndpointId> replicas;
+        if (task.task_addresses.empty()) {
+            replicas.push_back(endpoints_.add(task.task_address));
+        }
+        for (const std::string& address : task.task_addresses) {
+            replicas.push_back(endpoints_.add(address));
+        }
+        for (EndpointId replica : replicas) {
+            if (!AddressUtils::is_local(endpoints_.address(replica))) {
+                remote_replicas_[task_endpoints_.size()] = 1;
+            }
+        }
+        if (replicas.size() > MAX_TASK_REPLICAS) {
+            std::cerr << "[Orchestrator] Warning: task " << task.task_id << " has more than "
+                      << MAX_TASK_REPLICAS << " replicas, extra ones are ignored" << std::endl;
+        }
+        task_endpoints_.push_back(std::move(replicas));
+    }
+    
+    // Real-time tasks may starve their wrapper's heartbeats (see LivenessMonitor)
+    rt_task_.assign(tasks_.size(), 0);
+    for (size_t i = 0; i < schedule_.tasks.size(); i++) {
+        const std::string& rt_policy = schedule_.tasks[i].rt_policy;
+        rt_task_[schedule_handles_[i]] = !rt_policy.empty() && rt_policy != "none";
+    }
+}
+
+void Orchestrator::set_history_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    history_capacity_ = capacity;
+    history_.reset(history_capacity_);
+}
+
+void Orchestrator::set_trace_file(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    trace_path_ = path;
+}
+
+bool Orchestrator::set_duration_store(const std::string& path, double budget_margin) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    duration_store_path_ = path;
+    budget_margin_ = budget_margin;
+    return durations_.load(path);
+}
+
+bool Orchestrator::set_result_cache(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return result_cache_.open(directory);
+}
+
+void Orchestrator::set_dispatch_order(DispatchOrder order) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    release_queue_.set_order(order);
+}
+
+void Orchestrator::set_max_inflight_dispatches(size_t max_inflight) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_inflight_dispatches_ = std::max<size_t>(max_inflight, 1);
+}
+
+void Orchestrator::set_start_batching(size_t max_batch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_start_batch_ = std::max<size_t>(max_batch, 1);
+}
+
+void Orchestrator::set_prearm_lead(int64_t lead_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    prearm_lead_us_ = std::max<int64_t>(lead_us, 0);
+}
+
+void Orchestrator::set_uds_path(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uds_address_ = path.empty() ? "" : AddressUtils::UNIX_SCHEME + path;
+}
+
+void Orchestrator::set_heartbeat(int64_t interval_us, int missed_beats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    heartbeat_interval_us_ = std::max<int64_t>(interval_us, 0);
+    heartbeat_missed_beats_ = std::max(missed_beats, 1);
+}
+
+void Orchestrator::set_ready_timeout(int64_t timeout_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_timeout_us_ = std::max<int64_t>(timeout_us, 0);
 }
 
 void Orchestrator::set_rt_config(const RTConfig& config) {
@@ -84,20 +356,28 @@ void Orchestrator::set_rt_config(const RTConfig& config) {
     std::cout << "[Orchestrator] Real-time configuration set:" << std::endl;
     std::cout << "  Policy: " << RTUtils::policy_to_string(config.policy) << std::endl;
     std::cout << "  Priority: " << config.priority << std::endl;
-    std::cout << "  CPU Affinity: " << (config.cpu_affinity >= 0 ? std::to_string(config.cpu_affinity) : "none") << std::endl;
+    std::cout << "  CPU Affinity: " << (config.cpus().empty() ? "none" : config.cpus()) << std::endl;
+    if (config.numa_policy != NUMA_POLICY_NONE) {
+        std::cout << "  NUMA Policy: " << RTUtils::numa_policy_to_string(config.numa_policy) << std::endl;
+    }
 }
 
-void Orchestrator::start() {
+bool Orchestrator::start() {
     if (running_.exchange(true)) {
         std::cout << "[Orchestrator] Already running" << std::endl;
-        return;
+        return true;
     }
     
     std::cout << "[Orchestrator] Starting orchestrator on " 
               << listen_address_ << std::endl;
     
-    // Start gRPC server in separate thread
-    server_thread_ = std::thread([this]() {
+    // RT memory profile (no-op when main() already applied it)
+    RTUtils::apply_memory_profile(rt_config_);
+    
+    // Start gRPC server in separate thread; it reports whether it listens
+    std::promise<bool> server_started;
+    std::future<bool> server_listening = server_started.get_future();
+    server_thread_ = std::thread([this, &server_started]() {
         // Apply real-time configuration to server thread if requested
         if (rt_config_.policy != RT_POLICY_NONE) {
             RTConfig server_config = rt_config_;
@@ -108,38 +388,141 @@ void Orchestrator::start() {
             RTUtils::apply_rt_config(server_config);
         }
         
+        // Socket files left by a previous run are removed first
         grpc::ServerBuilder builder;
+        AddressUtils::prepare_listen(listen_address_);
         builder.AddListeningPort(listen_address_, grpc::InsecureServerCredentials());
+        if (!uds_address_.empty()) {
+            if (AddressUtils::prepare_listen(uds_address_)) {
+                builder.AddListeningPort(uds_address_, grpc::InsecureServerCredentials());
+            } else {
+                uds_address_.clear();
+            }
+        }
         builder.RegisterService(service_.get());
         
-        server_ = builder.BuildAndStart();
+        server_ = RTUtils::build_grpc_server(builder, rt_config_);
+        server_started.set_value(server_ != nullptr);
+        if (!server_) {
+            std::cerr << "[Orchestrator] Failed to listen on " << listen_address_ << std::endl;
+            return;
+        }
         std::cout << "[Orchestrator] gRPC server listening on " 
                   << listen_address_ << std::endl;
+        if (!uds_address_.empty()) {
+            std::cout << "[Orchestrator] Also listening on " << uds_address_ << std::endl;
+        }
         
         server_->Wait();
     });
     
-    // Give server time to start
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // End notifications can only be accepted once the server is up
+    if (!server_listening.get()) {
+        server_thread_.join();
+        running_ = false;
+        return false;
+    }
+    
+    // Readiness barrier: every wrapper answers before t=0 (co-located ones
+    // are switched to their Unix domain socket / shared-memory channel)
+    std::cout << "[Orchestrator] Waiting for " << endpoints_.size() << " wrappers (timeout "
+              << ready_timeout_us_ / 1000.0 << " ms)" << std::endl;
+    int64_t barrier_start_us = get_current_time_us();
+    size_t ready = endpoints_.wait_ready(ready_timeout_us_);
+    std::cout << "[Orchestrator] " << ready << "/" << endpoints_.size() << " wrappers ready after "
+              << (get_current_time_us() - barrier_start_us) / 1000.0 << " ms" << std::endl;
+    if (ready < endpoints_.size()) {
+        std::cerr << "[Orchestrator] Starting without " << endpoints_.size() - ready
+                  << " wrappers, their tasks will be retried on dispatch" << std::endl;
+    }
+    
+    // Heartbeat streams use the final stubs
+    if (heartbeat_interval_us_ > 0) {
+        liveness_.start(heartbeat_interval_us_, heartbeat_missed_beats_);
+    }
     
     // Start scheduler thread
     start_time_us_ = get_current_time_us();
+    start_system_time_us_ = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    if (!trace_path_.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        trace_.open(trace_path_, tasks_, start_system_time_us_);
+    }
+    
+    // Dispatch workers: their number caps the StartTask RPCs in flight
+    active_dispatches_.reserve(max_inflight_dispatches_);
+    for (size_t i = 0; i < max_inflight_dispatches_; i++) {
+        dispatch_threads_.emplace_back(&Orchestrator::dispatch_loop, this);
+    }
+    
     scheduler_thread_ = std::thread(&Orchestrator::scheduler_loop, this);
+    if (!duration_store_path_.empty()) {
+        watchdog_thread_ = std::thread(&Orchestrator::watchdog_loop, this);
+    }
     
-    std::cout << "[Orchestrator] Scheduler started" << std::endl;
+    std::cout << "[Orchestrator] Scheduler started (dispatch order: "
+              << ReleaseQueue::order_to_string(release_queue_.order())
+              << ", max in-flight dispatches: " << max_inflight_dispatches_ << ")" << std::endl;
+    if (max_start_batch_ > 1) {
+        std::cout << "[Orchestrator] Starts for the same wrapper are batched (up to "
+                  << max_start_batch_ << " per StartTasks)" << std::endl;
+    }
+    if (prearm_lead_us_ > 0) {
+        std::cout << "[Orchestrator] Timed tasks are pre-armed " << prearm_lead_us_ / 1000.0
+                  << " ms ahead of their release" << std::endl;
+    }
+    
+    return true;
 }
 
 void Orchestrator::stop() {
+    // A concurrent caller (e.g. a signal thread) waits until shutdown is complete
+    std::lock_guard<std::mutex> stop_lock(stop_mutex_);
     if (!running_.exchange(false)) {
         return;
     }
     
     std::cout << "[Orchestrator] Stopping orchestrator..." << std::endl;
     
-    // Stop scheduler thread
+    // No liveness transitions during shutdown
+    liveness_.stop();
+    
+    // Wake every thread waiting on the orchestrator state and cancel the
+    // StartTask RPCs in flight (a busy wrapper may hold them until the deadline)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const ActiveDispatch& dispatch : active_dispatches_) {
+            dispatch.context->TryCancel();
+        }
+        release_cv_.notify_all();
+        dispatch_cv_.notify_all();
+        task_end_cv_.notify_all();
+        completion_cv_.notify_all();
+        watchdog_cv_.notify_all();
+    }
+    
+    // Stop scheduler, release, dispatch and watchdog threads
     if (scheduler_thread_.joinable()) {
         scheduler_thread_.join();
     }
+    if (release_thread_.joinable()) {
+        release_thread_.join();
+    }
+    for (std::thread& worker : dispatch_threads_) {
+        worker.join();
+    }
+    dispatch_threads_.clear();
+    if (watchdog_thread_.joinable()) {
+        watchdog_thread_.join();
+    }
+    
+    // Wrappers must not release tasks of a stopped orchestrator
+    disarm_pending_tasks();
+    
+    // No start is in flight any more: detach from shared-memory channels
+    endpoints_.disconnect_shm();
     
     // Stop gRPC server
     if (server_) {
@@ -149,6 +532,34 @@ void Orchestrator::stop() {
     if (server_thread_.joinable()) {
         server_thread_.join();
     }
+    if (server_) {
+        AddressUtils::remove_socket(listen_address_);
+        AddressUtils::remove_socket(uds_address_);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (trace_.is_open()) {
+            std::cout << "[Orchestrator] Trace file closed (" << trace_.record_count()
+                      << " records)" << std::endl;
+            trace_.close();
+        }
+        
+        // Nobody will read the outputs still in shared memory
+        release_all_outputs();
+        
+        if (result_cache_.is_open()) {
+            std::cout << "[Orchestrator] Result cache: " << result_cache_.hits() << " hits, "
+                      << result_cache_.misses() << " misses, " << result_cache_.stores()
+                      << " results stored" << std::endl;
+        }
+        
+        // Learned execution times for the next run
+        if (!duration_store_path_.empty() && durations_.save(duration_store_path_)) {
+            std::cout << "[Orchestrator] Execution time statistics of " << durations_.size()
+                      << " tasks saved to " << duration_store_path_ << std::endl;
+        }
+    }
     
     std::cout << "[Orchestrator] Orchestrator stopped" << std::endl;
 }
@@ -156,41 +567,321 @@ void Orchestrator::stop() {
 void Orchestrator::wait_for_completion() {
     std::unique_lock<std::mutex> lock(mutex_);
     completion_cv_.wait(lock, [this]() {
-        return pending_tasks_ == 0 && next_task_index_ >= schedule_.tasks.size();
+        return (pending_tasks_ == 0 && next_task_index_ >= schedule_.tasks.size()) || !running_;
     });
     
     std::cout << "[Orchestrator] All tasks completed" << std::endl;
 }
 
-std::vector<TaskExecution> Orchestrator::get_execution_history() const {
+void Orchestrator::record_perf_metrics(TaskHandle handle, const TaskEndNotification& notification) {
+    bool measured = false;
+    PerfCounter counter;
+    for (const auto& metric : notification.metrics()) {
+        if (!PerfCounters::parse_metric(metric.first, counter)) {
+            continue;
+        }
+        if (handle >= perf_stats_.size()) {
+            perf_stats_.resize(handle + 1);
+        }
+        perf_stats_[handle].counters[counter].add(strtoll(metric.second.c_str(), nullptr, 10));
+        measured = true;
+    }
+    if (measured) {
+        perf_stats_[handle].executions++;
+    }
+}
+
+std::vector<TaskPerfStats> Orchestrator::get_perf_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TaskPerfStats> stats;
+    for (size_t handle = 0; handle < perf_stats_.size(); handle++) {
+        if (perf_stats_[handle].executions == 0) {
+            continue;
+        }
+        stats.push_back(perf_stats_[handle]);
+        stats.back().task_id = tasks_.id(static_cast<TaskHandle>(handle));
+    }
+    return stats;
+}
+
+std::vector<TaskDurationReport> Orchestrator::get_duration_report() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return completed_tasks_;
+    std::vector<TaskDurationReport> report;
+    for (TaskHandle handle = 0; handle < duration_stats_.size(); handle++) {
+        const TaskDurationStats* stats = duration_stats_[handle];
+        if (!stats || stats->executions == 0) {
+            continue;
+        }
+        TaskDurationReport task;
+        task.task_id = tasks_.id(handle);
+        task.declared_us = declared_duration_us_[handle];
+        task.declared = duration_declared_[handle];
+        task.stats = *stats;
+        task.overruns = overruns_[handle];
+        
+        // Compared with the median, so a few outliers do not flag a good estimate
+        int64_t median_us = stats->percentile(50);
+        task.misestimated = median_us > 0 &&
+            (task.declared_us > median_us * TaskDurationReport::MISESTIMATE_FACTOR ||
+             task.declared_us * TaskDurationReport::MISESTIMATE_FACTOR < median_us);
+        report.push_back(std::move(task));
+    }
+    return report;
+}
+
+int64_t Orchestrator::expected_duration_us(TaskHandle handle, int64_t measured_us) const {
+    const TaskDurationStats* stats = duration_stats_[handle];
+    if (stats && stats->executions > 0) {
+        return stats->ewma_us;
+    }
+    return measured_us > 0 ? measured_us : declared_duration_us_[handle];
+}
+
+void Orchestrator::learn_duration(TaskHandle handle, int64_t duration_us) {
+    // An overrun the watchdog did not see (it ended between two checks)
+    if (budget_us_[handle] > 0 && duration_us > budget_us_[handle] && !over_budget_[handle]) {
+        over_budget_[handle] = 1;
+        overruns_[handle]++;
+        std::cerr << "[Orchestrator] Task " << tasks_.id(handle) << " ran " << duration_us / 1000.0
+                  << " ms, over its budget of " << budget_us_[handle] / 1000.0 << " ms" << std::endl;
+    }
+    
+    TaskDurationStats& stats = *duration_stats_[handle];
+    stats.add(duration_us);
+    if (stats.executions >= MIN_BUDGET_SAMPLES) {
+        budget_us_[handle] = static_cast<int64_t>(stats.wcet_us * budget_margin_);
+    }
+}
+
+void Orchestrator::watchdog_loop() {
+    struct Overrun {
+        TaskHandle handle;
+        int64_t running_us;
+        int64_t budget_us;
+        int64_t wcet_us;
+    };
+    std::vector<Overrun> overruns;
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!watchdog_cv_.wait_for(lock, std::chrono::milliseconds(WATCHDOG_INTERVAL_MS),
+                                  [this]() { return !running_.load(); })) {
+        int64_t now_us = get_current_time_us() - start_time_us_;
+        for (size_t i = 0; i < watched_.size();) {
+            TaskHandle handle = watched_[i];
+            // Ended (or abandoned) since the last check: stop watching it
+            if (!tasks_.is_active(handle)) {
+                is_watched_[handle] = 0;
+                watched_[i] = watched_.back();
+                watched_.pop_back();
+                continue;
+            }
+            i++;
+            if (over_budget_[handle] || tasks_.state[handle] != TASK_STATE_RUNNING) {
+                continue;
+            }
+            int64_t running_us = now_us - tasks_.actual_start_time_us[handle];
+            if (running_us > budget_us_[handle]) {
+                over_budget_[handle] = 1;
+                overruns_[handle]++;
+                overruns.push_back({handle, running_us, budget_us_[handle], duration_stats_[handle]->wcet_us});
+            }
+        }
+        if (overruns.empty()) {
+            continue;
+        }
+        
+        lock.unlock();
+        for (const Overrun& overrun : overruns) {
+            std::cerr << "[Orchestrator] Watchdog: task " << tasks_.id(overrun.handle) << " running for "
+                      << overrun.running_us / 1000.0 << " ms, over its budget of "
+                      << overrun.budget_us / 1000.0 << " ms (WCET so far "
+                      << overrun.wcet_us / 1000.0 << " ms)" << std::endl;
+        }
+        overruns.clear();
+        lock.lock();
+    }
+}
+
+std::vector<TaskExecution> Orchestrator::get_execution_history() const {
+    // Copy the ring without taking mutex_ (task ids are immutable once loaded)
+    std::vector<ExecutionRecord> records;
+    history_.snapshot(records);
+    
+    std::vector<TaskExecution> history;
+    history.reserve(records.size());
+    for (const ExecutionRecord& rec : records) {
+        TaskExecution exec;
+        exec.task_id = tasks_.id(rec.handle);
+        exec.scheduled_time_us = rec.scheduled_time_us;
+        exec.actual_start_time_us = rec.actual_start_time_us;
+        exec.end_time_us = rec.end_time_us;
+        exec.state = rec.state;
+        exec.result = rec.result;
+        exec.task_address = rec.endpoint < endpoints_.size() ? endpoints_.address(rec.endpoint) : "";
+        exec.timeline = rec.timeline;
+        history.push_back(std::move(exec));
+    }
+    
+    // Error messages are mutable strings; lock only for the (rare) failures
+    bool has_failures = std::any_of(records.begin(), records.end(), [](const ExecutionRecord& rec) {
+        return rec.result != TASK_RESULT_SUCCESS;
+    });
+    if (has_failures) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < records.size(); i++) {
+            if (records[i].result != TASK_RESULT_SUCCESS) {
+                history[i].error_message = tasks_.error_message[records[i].handle];
+            }
+        }
+    }
+    return history;
+}
+
+std::vector<TimelineDependency> Orchestrator::schedule_dependencies() const {
+    std::vector<TimelineDependency> dependencies;
+    for (const ScheduledTask& task : schedule_.tasks) {
+        for (const std::string& dependency : task.dependencies()) {
+            dependencies.push_back({task.task_id, dependency});
+        }
+    }
+    return dependencies;
+}
+
+bool Orchestrator::export_timeline(const std::string& path) const {
+    if (!TimelineExporter::write_chrome_trace(path, get_execution_history(), schedule_dependencies())) {
+        return false;
+    }
+    std::cout << "[Orchestrator] Timeline written to " << path << std::endl;
+    return true;
+}
+
+std::vector<CriticalPathStep> Orchestrator::get_critical_path() const {
+    return CriticalPath::from_history(get_execution_history(), schedule_dependencies());
+}
+
+void Orchestrator::record_execution(TaskHandle handle) {
+    ExecutionRecord rec = tasks_.record(handle);
+    history_.push(rec);
+    trace_.append(rec);
 }
 
 void Orchestrator::on_task_end(const TaskEndNotification& notification) {
+    // Hashing and copying the outputs for the result cache read every
+    // shared-memory value (and store writes a file): done before taking
+    // mutex_ for the completion. The segments belong to this notification
+    // until store_outputs registers them, so nothing reclaims them meanwhile.
+    uint64_t cache_key = 0;
+    bool digest_outputs = false;
+    bool keep = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        TaskHandle handle = tasks_.resolve(notification.task_handle(), notification.task_id());
+        if (handle != INVALID_TASK_HANDLE && tasks_.is_active(handle)) {
+            if (notification.result() == TASK_RESULT_SUCCESS) {
+                cache_key = cache_key_[handle];
+            }
+            digest_outputs = feeds_cacheable_[handle];
+            keep = keeps_outputs(handle, notification.result());
+        }
+    }
+    
+    // A successful cacheable execution is recorded before its outputs can
+    // be reclaimed
+    if (cache_key != 0) {
+        result_cache_.store(cache_key, notification.task_id(), notification.execution_duration_us(),
+                            notification.outputs());
+    }
+    uint64_t digest = 0;
+    if (digest_outputs) {
+        digest = ResultCache::digest(keep ? notification.outputs() :
+                                     google::protobuf::RepeatedPtrField<TaskOutput>());
+    }
+    
     std::lock_guard<std::mutex> lock(mutex_);
     
-    auto it = active_tasks_.find(notification.task_id());
-    if (it == active_tasks_.end()) {
+    TaskHandle handle = tasks_.resolve(notification.task_handle(), notification.task_id());
+    if (handle == INVALID_TASK_HANDLE || !tasks_.is_active(handle)) {
         std::cerr << "[Orchestrator] Warning: received end notification for unknown task: "
                   << notification.task_id() << std::endl;
+        // Nobody will read its outputs
+        for (const TaskOutput& output : notification.outputs()) {
+            if (!output.shm_segment().empty()) {
+                ShmOutputBuffer::unlink(output.shm_segment());
+            }
+        }
         return;
     }
     
-    TaskExecution& exec = it->second;
-    exec.end_time_us = notification.end_time_us() - start_time_us_;  // Relative to start
-    exec.state = TASK_STATE_COMPLETED;
-    exec.result = notification.result();
-    exec.error_message = notification.error_message();
-    
     // Log already printed in NotifyTaskEnd
     
-    // Move to completed tasks
-    completed_tasks_.push_back(exec);
-    active_tasks_.erase(it);
+    TaskTimeline& timeline = tasks_.timeline[handle];
+    if (notification.accept_time_us() > 0) {
+        timeline.wrapper_start_us = notification.accept_time_us() - start_time_us_;
+    }
+    timeline.callback_start_us = notification.start_time_us() - start_time_us_;
+    timeline.callback_end_us = notification.end_time_us() - start_time_us_;
+    timeline.notify_received_us = get_current_time_us() - start_time_us_;
+    timeline.cpu_core = notification.cpu_core();
     
-    // Mark task as completed for dependency tracking
-    task_completed_[notification.task_id()] = true;
+    // A task exceeding its cgroup CPU bandwidth was held back by the wrapper
+    if (notification.cpu_throttled_periods() > 0) {
+        std::cerr << "[Orchestrator] Task " << notification.task_id() << " was throttled in "
+                  << notification.cpu_throttled_periods() << " bandwidth periods ("
+                  << notification.cpu_throttled_us() / 1000.0 << " ms, CPU time "
+                  << notification.cpu_usage_us() / 1000.0 << " ms)" << std::endl;
+    }
+    if (notification.numa_remote_pages() > 0) {
+        std::cerr << "[Orchestrator] Task " << notification.task_id() << " placed "
+                  << notification.numa_remote_pages() << " pages off its NUMA nodes ("
+                  << notification.numa_local_pages() << " local)" << std::endl;
+    }
+    // perf counters measured by the wrapper around the callback
+    if (!notification.metrics().empty()) {
+        record_perf_metrics(handle, notification);
+    }
+    if (notification.major_page_faults() > 0) {
+        std::cerr << "[Orchestrator] Task " << notification.task_id() << " took "
+                  << notification.major_page_faults() << " major page faults ("
+                  << notification.minor_page_faults() << " minor)" << std::endl;
+    }
+    
+    // Pre-armed start: the actual start is the scheduled time plus the
+    // wrapper's local wakeup lateness (no network or dispatch delay)
+    if (notification.armed()) {
+        tasks_.actual_start_time_us[handle] = tasks_.scheduled_time_us[handle] + notification.release_lateness_us();
+        auto armed = std::find_if(armed_tasks_.begin(), armed_tasks_.end(), [this, handle](size_t index) {
+            return schedule_handles_[index] == handle;
+        });
+        if (armed != armed_tasks_.end()) {
+            *armed = armed_tasks_.back();
+            armed_tasks_.pop_back();
+        }
+    }
+    
+    // Bottom levels of the tasks still to run follow the measured duration
+    // (the learned one with a duration store)
+    if (notification.end_time_us() > notification.start_time_us()) {
+        int64_t duration_us = notification.end_time_us() - notification.start_time_us();
+        if (duration_stats_[handle]) {
+            learn_duration(handle, duration_us);
+        }
+        if (critical_path_priority_) {
+            critical_path_.update_duration(handle, expected_duration_us(handle, duration_us));
+        }
+    }
+    
+    // The replica is free again
+    endpoints_.end(tasks_.endpoint[handle], rt_task_[handle]);
+    
+    // Mark task as completed (also releases dependents)
+    tasks_.mark_completed(handle, TASK_STATE_COMPLETED, notification.result(),
+                          notification.end_time_us() - start_time_us_);  // Relative to start
+    tasks_.error_message[handle] = notification.error_message();
+    record_execution(handle);
+    
+    // Its inputs are consumed, its outputs wait for its dependents
+    release_inputs(handle);
+    store_outputs(handle, notification, digest);
     
     // Decrement pending tasks counter
     --pending_tasks_;
@@ -213,9 +904,10 @@ void Orchestrator::scheduler_loop() {
         RTUtils::apply_rt_config(rt_config_);
     }
     
-    // PHASE 1: Launch all TIMED tasks immediately (they will wait internally for their scheduled time)
+    // PHASE 1: Register all TIMED tasks; the release thread queues them at their scheduled time
     std::cout << "\n[Orchestrator] === PHASE 1: Launching TIMED tasks ===\n" << std::endl;
-    for (const ScheduledTask& task : schedule_.tasks) {
+    for (size_t i = 0; i < schedule_.tasks.size(); i++) {
+        const ScheduledTask& task = schedule_.tasks[i];
         if (task.execution_mode == TASK_MODE_TIMED) {
             int64_t absolute_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::system_clock::now().time_since_epoch()).count();
@@ -223,31 +915,18 @@ void Orchestrator::scheduler_loop() {
                       << "→ Launching TIMED task: " << task.task_id 
                       << " (scheduled at " << task.scheduled_time_us / 1000 << " ms)" << std::endl;
             
-            // Launch task on separate thread
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                pending_tasks_++;
-                next_task_index_++;
-            }
-            
-            // Capture task by value and start_time_us for timing
-            std::thread([this, task]() {
-                // Wait until scheduled time
-                int64_t current_time = get_current_time_us() - start_time_us_;
-                int64_t wait_time_us = task.scheduled_time_us - current_time;
-                
-                if (wait_time_us > 0) {
-                    std::this_thread::sleep_for(std::chrono::microseconds(wait_time_us));
-                }
-                execute_task(task);
-            }).detach();
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_tasks_++;
+            next_task_index_++;
         }
     }
+    release_thread_ = std::thread(&Orchestrator::release_loop, this);
     
     // PHASE 2: Process SEQUENTIAL tasks in order
     std::cout << "\n[Orchestrator] === PHASE 2: Processing SEQUENTIAL tasks ===\n" << std::endl;
     for (size_t i = 0; i < schedule_.tasks.size() && running_; i++) {
         const ScheduledTask& task = schedule_.tasks[i];
+        TaskHandle handle = schedule_handles_[i];
         
         if (task.execution_mode == TASK_MODE_SEQUENTIAL) {
             
@@ -256,17 +935,23 @@ void Orchestrator::scheduler_loop() {
                 int64_t wait_start_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                     std::chrono::system_clock::now().time_since_epoch()).count();
                 std::cout << "[" << std::setw(13) << wait_start_ms << " ms] "
-                          << "⏸ Waiting for " << task.wait_for_task_id << " to complete..." << std::endl;
+                          << "⏸ Waiting for " << task.wait_for_task_id;
+                if (task.depends_on.size() > 1) {
+                    std::cout << " and " << task.depends_on.size() - 1 << " more";
+                }
+                std::cout << " to complete..." << std::endl;
                 
                 std::unique_lock<std::mutex> lock(mutex_);
-                task_end_cv_.wait(lock, [this, &task]() {
-                    return task_completed_[task.wait_for_task_id] || !running_;
+                tasks_.timeline[handle].wait_start_us = get_current_time_us() - start_time_us_;
+                task_end_cv_.wait(lock, [this, handle]() {
+                    return tasks_.dependencies_satisfied(handle) || !running_;
                 });
                 
                 if (!running_) {
                     std::cout << "[Orchestrator] Scheduler interrupted" << std::endl;
                     break;
                 }
+                tasks_.timeline[handle].release_us = get_current_time_us() - start_time_us_;
                 
                 int64_t wait_end_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                     std::chrono::system_clock::now().time_since_epoch()).count();
@@ -284,30 +969,22 @@ void Orchestrator::scheduler_loop() {
             }
             std::cout << std::endl;
             
-            // Launch task on separate thread
+            // Register task as active before launching, so the completion
+            // wait below cannot miss it
             {
                 std::lock_guard<std::mutex> lock(mutex_);
                 pending_tasks_++;
                 next_task_index_++;
-            }
-            
-            std::thread([this, task]() {
-                execute_task(task);
-            }).detach();
-            
-            // Wait for task to be registered in active_tasks first
-            {
-                std::unique_lock<std::mutex> lock(mutex_);
-                task_end_cv_.wait_for(lock, std::chrono::milliseconds(100), [this, &task]() {
-                    return active_tasks_.find(task.task_id) != active_tasks_.end() || !running_;
-                });
+                int64_t now_us = get_current_time_us() - start_time_us_;
+                tasks_.mark_started(handle, now_us);
+                release_task(i, now_us);
             }
             
             // Wait for completion
             {
                 std::unique_lock<std::mutex> lock(mutex_);
-                task_end_cv_.wait(lock, [this, &task]() {
-                    return active_tasks_.find(task.task_id) == active_tasks_.end() || !running_;
+                task_end_cv_.wait(lock, [this, handle]() {
+                    return !tasks_.is_active(handle) || !running_;
                 });
                 
                 if (!running_) {
@@ -330,80 +1007,410 @@ void Orchestrator::scheduler_loop() {
     completion_cv_.notify_all();
 }
 
-void Orchestrator::execute_task(const ScheduledTask& task) {
-    // Register task BEFORE sending start command to avoid race condition
+// Pause between two rounds over a task's replicas
+static constexpr int DISPATCH_RETRY_BACKOFF_MS = 10;
+
+// Same budget as the StartTask deadline (the wrapper answers without blocking)
+static constexpr int64_t SHM_START_TIMEOUT_US = 5000000;
+
+void Orchestrator::release_loop() {
+    // Apply real-time configuration to the release thread (it keeps the timed releases on time)
+    if (rt_config_.policy != RT_POLICY_NONE) {
+        RTUtils::apply_rt_config(rt_config_);
+    }
+    
+    // schedule_ is sorted by time, so timed tasks are released in index order
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t next = 0;
+    while (running_) {
+        while (next < schedule_.tasks.size() &&
+               schedule_.tasks[next].execution_mode != TASK_MODE_TIMED) {
+            next++;
+        }
+        if (next >= schedule_.tasks.size()) {
+            break;
+        }
+        
+        // Sleep until the next release instant (stop() interrupts the wait);
+        // pre-armed tasks are released to the dispatch workers ahead of time
+        int64_t due_us = schedule_.tasks[next].scheduled_time_us - prearm_lead_us_;
+        auto due = std::chrono::steady_clock::time_point(std::chrono::microseconds(start_time_us_ + due_us));
+        if (release_cv_.wait_until(lock, due, [this]() { return !running_.load(); })) {
+            break;
+        }
+        
+        // Release every timed task due by now as one batch, so the dispatch
+        // order among them is decided by the release queue
+        int64_t now_us = get_current_time_us() - start_time_us_;
+        for (; next < schedule_.tasks.size(); next++) {
+            const ScheduledTask& task = schedule_.tasks[next];
+            if (task.execution_mode != TASK_MODE_TIMED) {
+                continue;
+            }
+            if (task.scheduled_time_us - prearm_lead_us_ > now_us) {
+                break;
+            }
+            release_task(next, task.scheduled_time_us);
+        }
+    }
+}
+
+void Orchestrator::release_task(size_t task_index, int64_t release_time_us) {
+    const ScheduledTask& task = schedule_.tasks[task_index];
+    
+    ReleasedTask released;
+    released.task_index = task_index;
+    released.release_time_us = release_time_us;
+    released.absolute_deadline_us = release_time_us + task.deadline_us;
+    released.priority = task.priority;
+    released.bottom_level_us = critical_path_priority_ ? critical_path_.bottom_level(schedule_handles_[task_index]) : 0;
+    released.sequence = 0;
+    release_queue_.push(released);
+    
+    TaskTimeline& timeline = tasks_.timeline[schedule_handles_[task_index]];
+    timeline.release_us = get_current_time_us() - start_time_us_;
+    if (task.execution_mode == TASK_MODE_TIMED || task.wait_for_task_id.empty()) {
+        timeline.wait_start_us = timeline.release_us;
+    }
+    
+    dispatch_cv_.notify_one();
+}
+
+void Orchestrator::dispatch_loop() {
+    // Dispatch workers send StartTask RPCs, so they run at scheduler priority
+    if (rt_config_.policy != RT_POLICY_NONE) {
+        RTUtils::apply_rt_config(rt_config_);
+    }
+    
+    std::vector<size_t> batch;
+    batch.reserve(max_start_batch_);
+    while (true) {
+        batch.clear();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            dispatch_cv_.wait(lock, [this]() {
+                return !release_queue_.empty() || !running_;
+            });
+            if (!running_) {
+                break;
+            }
+            batch.push_back(release_queue_.pop().task_index);
+            
+            // Queued tasks for the same wrapper join the batch (queue order is kept)
+            while (batch.size() < max_start_batch_ && !release_queue_.empty() &&
+                   batchable(batch[0], release_queue_.top().task_index)) {
+                batch.push_back(release_queue_.pop().task_index);
+            }
+        }
+        
+        if (batch.size() == 1) {
+            execute_task(batch[0]);
+        } else {
+            execute_task_batch(batch);
+        }
+    }
+}
+
+bool Orchestrator::batchable(size_t first, size_t next) const {
+    // Cacheable tasks may not need a start at all
+    if (result_cache_.is_open() && (schedule_.tasks[first].cacheable || schedule_.tasks[next].cacheable)) {
+        return false;
+    }
+    // Only tasks with a single replica: replica selection stays per task
+    const std::vector<EndpointId>& a = task_endpoints_[first];
+    const std::vector<EndpointId>& b = task_endpoints_[next];
+    if (a.size() != 1 || b.size() != 1 || a[0] != b[0]) {
+        return false;
+    }
+    // Pre-armed tasks are armed one by one
+    return prearm_lead_us_ == 0 || (!arm_requests_[first] && !arm_requests_[next]);
+}
+
+void Orchestrator::begin_dispatch(TaskHandle handle, int64_t dispatch_time_us) {
+    tasks_.mark_started(handle, dispatch_time_us);
+    
+    TaskTimeline& timeline = tasks_.timeline[handle];
+    timeline.dispatch_us = dispatch_time_us;
+    timeline.dispatch_done_us = 0;
+    timeline.wrapper_start_us = 0;
+    timeline.callback_start_us = 0;
+    timeline.callback_end_us = 0;
+    timeline.notify_received_us = 0;
+    timeline.cpu_core = -1;
+    over_budget_[handle] = 0;
+    if (budget_us_[handle] > 0 && !is_watched_[handle]) {
+        is_watched_[handle] = 1;
+        watched_.push_back(handle);
+    }
+}
+
+void Orchestrator::execute_task_batch(const std::vector<size_t>& batch) {
+    EndpointId endpoint = task_endpoints_[batch[0]][0];
+    int64_t dispatch_time_us = get_current_time_us() - start_time_us_;  // Relative to start
+    
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        TaskExecution exec;
-        exec.task_id = task.task_id;
-        exec.scheduled_time_us = task.scheduled_time_us;
-        exec.actual_start_time_us = get_current_time_us() - start_time_us_;  // Relative to start
-        exec.state = TASK_STATE_STARTING;
-        exec.result = TASK_RESULT_UNKNOWN;
+        for (size_t task_index : batch) {
+            TaskHandle handle = schedule_handles_[task_index];
+            begin_dispatch(handle, dispatch_time_us);
+            attach_inputs(handle, *start_requests_[task_index]);
+            tasks_.endpoint[handle] = endpoint;
+        }
+    }
+    if (remote_replicas_[batch[0]]) {
+        for (size_t task_index : batch) {
+            inline_inputs(*start_requests_[task_index]);
+        }
+    }
+    
+    // The batch borrows the pre-built requests (they stay owned by
+    // request_arena_ and are released back once the call returns)
+    StartTasksRequest request;
+    StartTasksResponse response;
+    for (size_t task_index : batch) {
+        StartTaskRequest* start = start_requests_[task_index];
+        start->set_dispatch_time_us(dispatch_time_us);
+        request.mutable_starts()->UnsafeArenaAddAllocated(start);
+        endpoints_.begin(endpoint, rt_task_[schedule_handles_[task_index]]);
+    }
+    dispatch_count_ += batch.size();
+    
+    std::cout << "[Orchestrator] Starting " << batch.size() << " tasks on "
+              << endpoints_.address(endpoint) << " with one StartTasks" << std::endl;
+    
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(5));
+    
+    grpc::Status status(grpc::StatusCode::CANCELLED, "Orchestrator stopping");
+    bool registered = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            active_dispatches_.push_back({&context, endpoint});
+            registered = true;
+        }
+    }
+    if (registered) {
+        int64_t sent_us = get_current_time_us();
+        status = endpoints_.stub(endpoint)->StartTasks(&context, request, &response);
+        int64_t now_us = get_current_time_us();
         
-        active_tasks_[task.task_id] = exec;
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(active_dispatches_.begin(), active_dispatches_.end(),
+                               [&context](const ActiveDispatch& dispatch) { return dispatch.context == &context; });
+        *it = active_dispatches_.back();
+        active_dispatches_.pop_back();
         
-        // Notify that task has been registered
-        task_end_cv_.notify_one();
+        if (status.ok()) {
+            endpoints_.record_success(endpoint, now_us - sent_us);
+        } else if (status.error_code() == grpc::StatusCode::UNAVAILABLE) {
+            endpoints_.record_unavailable(endpoint, now_us);
+        }
+    }
+    while (!request.starts().empty()) {
+        request.mutable_starts()->UnsafeArenaReleaseLast();
     }
     
-    // Create gRPC stub for task
-    auto channel = grpc::CreateChannel(task.task_address, grpc::InsecureChannelCredentials());
-    auto stub = TaskService::NewStub(channel);
+    for (size_t k = 0; k < batch.size(); k++) {
+        TaskHandle handle = schedule_handles_[batch[k]];
+        bool started = status.ok() && static_cast<int>(k) < response.responses_size() &&
+                       response.responses(static_cast<int>(k)).success();
+        if (started) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.timeline[handle].dispatch_done_us = get_current_time_us() - start_time_us_;
+            if (tasks_.is_active(handle) && endpoints_.quarantined(endpoint)) {
+                endpoints_.end(endpoint, rt_task_[handle]);
+                abandon_task(handle, "Wrapper lost (heartbeat)");
+            } else if (tasks_.state[handle] == TASK_STATE_STARTING) {
+                int64_t actual_start_time_us = response.responses(static_cast<int>(k)).actual_start_time_us();
+                if (actual_start_time_us > 0) {
+                    tasks_.actual_start_time_us[handle] = actual_start_time_us - start_time_us_;
+                }
+                tasks_.state[handle] = TASK_STATE_RUNNING;
+            }
+        } else {
+            // Rejected by the wrapper: dispatch it alone (with its retries)
+            endpoints_.end(endpoint, rt_task_[handle]);
+            execute_task(batch[k]);
+        }
+    }
+}
+
+void Orchestrator::execute_task(size_t task_index) {
+    ScopedAllocCounter allocations;
+    const ScheduledTask& task = schedule_.tasks[task_index];
+    TaskHandle handle = schedule_handles_[task_index];
+    int64_t dispatch_time_us = get_current_time_us() - start_time_us_;  // Relative to start
     
-    // Prepare start request
-    StartTaskRequest request;
-    request.set_task_id(task.task_id);
-    request.set_scheduled_time_us(task.scheduled_time_us);
-    request.set_deadline_us(task.deadline_us);
-    request.set_priority(task.priority);
-    request.set_rt_policy(task.rt_policy);
-    request.set_rt_priority(task.rt_priority);
-    request.set_cpu_affinity(task.cpu_affinity);
+    // Pre-built request and cached stubs: only the timing fields (and the
+    // dependencies' outputs) change
+    StartTaskRequest& request = *start_requests_[task_index];
+    request.set_dispatch_time_us(dispatch_time_us);
     
-    for (const auto& param : task.parameters) {
-        (*request.mutable_parameters())[param.first] = param.second;
+    // Register task BEFORE sending start command to avoid race condition
+    uint64_t cache_key = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        begin_dispatch(handle, dispatch_time_us);
+        attach_inputs(handle, request);
+        if (task.cacheable && result_cache_.is_open()) {
+            cache_key = result_cache_key(task_index);
+        }
+        cache_key_[handle] = cache_key;
     }
     
-    StartTaskResponse response;
-    grpc::ClientContext context;
+    // Another host cannot map the producers' segments
+    if (remote_replicas_[task_index]) {
+        inline_inputs(request);
+    }
     
-    // Set timeout for gRPC call
-    auto deadline = std::chrono::system_clock::now() + std::chrono::seconds(5);
-    context.set_deadline(deadline);
+    // Same parameters and inputs as an earlier successful run: no execution
+    if (cache_key != 0) {
+        CachedResult cached;
+        if (result_cache_.lookup(cache_key, task.task_id, cached) &&
+            result_cache_.restore_outputs(*cached.mutable_outputs())) {
+            complete_from_cache(task_index, cached);
+            return;
+        }
+    }
+    const std::vector<EndpointId>& replicas = task_endpoints_[task_index];
     
-    // Send start command
-    grpc::Status status = stub->StartTask(&context, request, &response);
+    // Pre-armed timed task: the wrapper releases it at the scheduled time
+    ArmTaskRequest* arm_request = prearm_lead_us_ > 0 ? arm_requests_[task_index] : nullptr;
+    if (arm_request) {
+        arm_request->set_release_time_us(start_system_time_us_ + task.scheduled_time_us);
+    }
     
-    if (status.ok() && response.success()) {
+    dispatch_allocations_ += allocations.count();
+    dispatch_count_++;
+    
+    // Try the least-loaded replica first. A failed attempt (UNAVAILABLE or a
+    // busy wrapper) fails over to the next replica; only a round in which
+    // every replica failed consumes one of the task's retries.
+    StartTaskResponse response;
+    ArmTaskResponse arm_response;
+    grpc::Status status;
+    uint64_t tried_mask = 0;
+    int32_t retries_left = task.max_retries;
+    bool started = false;
+    
+    while (running_) {
+        size_t replica = endpoints_.select(replicas, tried_mask, get_current_time_us());
+        if (replica == replicas.size()) {
+            if (tried_mask == 0) {
+                status = grpc::Status(grpc::StatusCode::UNAVAILABLE, "Every replica is quarantined");
+            }
+            if (retries_left-- <= 0) {
+                break;
+            }
+            std::cout << "[Orchestrator] Retrying start of " << task.task_id
+                      << " (" << retries_left << " retries left)" << std::endl;
+            std::this_thread::sleep_for(std::chrono::milliseconds(DISPATCH_RETRY_BACKOFF_MS));
+            tried_mask = 0;
+            continue;
+        }
+        tried_mask |= uint64_t(1) << replica;
+        EndpointId endpoint = replicas[replica];
+        
+        response.Clear();
+        arm_response.Clear();
+        grpc::ClientContext context;
+        
+        // Set timeout for gRPC call
+        auto deadline = std::chrono::system_clock::now() + std::chrono::seconds(5);
+        context.set_deadline(deadline);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                break;
+            }
+            tasks_.endpoint[handle] = endpoint;
+            active_dispatches_.push_back({&context, endpoint});
+        }
+        endpoints_.begin(endpoint, rt_task_[handle]);
+        
+        // Send start (or arm) command
+        ShmClient* shm = arm_request ? nullptr : endpoints_.shm(endpoint);
+        if (shm && request.ByteSizeLong() > SHM_MAX_MESSAGE_SIZE) {
+            shm = nullptr;  // Request (parameters, inline inputs) too large for a slot: gRPC
+        }
+        int64_t sent_us = get_current_time_us();
+        if (arm_request) {
+            status = endpoints_.stub(endpoint)->ArmTask(&context, *arm_request, &arm_response);
+            response.set_success(arm_response.success());
+            response.set_message(arm_response.message());
+        } else if (shm) {
+            status = shm->start_task(request, &response, SHM_START_TIMEOUT_US);
+        } else {
+            status = endpoints_.stub(endpoint)->StartTask(&context, request, &response);
+        }
+        int64_t now_us = get_current_time_us();
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(active_dispatches_.begin(), active_dispatches_.end(),
+                                   [&context](const ActiveDispatch& dispatch) { return dispatch.context == &context; });
+            *it = active_dispatches_.back();
+            active_dispatches_.pop_back();
+        }
+        
+        if (status.ok()) {
+            endpoints_.record_success(endpoint, now_us - sent_us);
+            if (response.success()) {
+                started = true;
+                break;
+            }
+        } else if (status.error_code() == grpc::StatusCode::UNAVAILABLE) {
+            endpoints_.record_unavailable(endpoint, now_us);
+        }
+        endpoints_.end(endpoint, rt_task_[handle]);
+        
+        if (replicas.size() > 1) {
+            std::cout << "[Orchestrator] Replica " << endpoints_.address(endpoint) << " did not start "
+                      << task.task_id << " (" << (status.ok() ? response.message() : status.error_message())
+                      << "), failing over" << std::endl;
+        }
+    }
+    
+    if (started) {
         // Task started successfully - no log needed here, launch log already printed
         
         // Update task execution state
         std::lock_guard<std::mutex> lock(mutex_);
-        auto it = active_tasks_.find(task.task_id);
-        if (it != active_tasks_.end()) {
+        tasks_.timeline[handle].dispatch_done_us = get_current_time_us() - start_time_us_;
+        if (tasks_.is_active(handle) && endpoints_.quarantined(tasks_.endpoint[handle])) {
+            // The wrapper was lost while the start was being acknowledged
+            endpoints_.end(tasks_.endpoint[handle], rt_task_[handle]);
+            abandon_task(handle, "Wrapper lost (heartbeat)");
+        } else if (arm_request) {
+            // Stays STARTING until the wrapper releases it; the actual start
+            // time comes with the end notification
+            if (tasks_.state[handle] == TASK_STATE_STARTING) {
+                armed_tasks_.push_back(task_index);
+            }
+        } else if (tasks_.state[handle] == TASK_STATE_STARTING) {
             // Use the response time if available, otherwise keep the registered time
             if (response.actual_start_time_us() > 0) {
-                it->second.actual_start_time_us = response.actual_start_time_us() - start_time_us_;
+                tasks_.actual_start_time_us[handle] = response.actual_start_time_us() - start_time_us_;
             }
-            it->second.state = TASK_STATE_RUNNING;
+            tasks_.state[handle] = TASK_STATE_RUNNING;
         }
     } else {
         std::cerr << "[Orchestrator] Failed to start task " << task.task_id 
-                  << ": " << status.error_message() << std::endl;
+                  << ": " << (status.ok() ? response.message() : status.error_message()) << std::endl;
         
-        // Mark task as failed
+        // Mark task as failed (the replica counter was already released)
         std::lock_guard<std::mutex> lock(mutex_);
-        TaskExecution exec;
-        exec.task_id = task.task_id;
-        exec.scheduled_time_us = task.scheduled_time_us;
-        exec.actual_start_time_us = get_current_time_us() - start_time_us_;  // Relative to start
-        exec.end_time_us = exec.actual_start_time_us;
-        exec.state = TASK_STATE_FAILED;
-        exec.result = TASK_RESULT_FAILURE;
-        exec.error_message = status.error_message();
+        int64_t now_us = get_current_time_us() - start_time_us_;  // Relative to start
+        tasks_.actual_start_time_us[handle] = now_us;
+        tasks_.timeline[handle].dispatch_done_us = now_us;
+        tasks_.mark_completed(handle, TASK_STATE_FAILED, TASK_RESULT_FAILURE, now_us);
+        tasks_.error_message[handle] = status.ok() ? response.message() : status.error_message();
+        record_execution(handle);
+        release_inputs(handle);
         
-        completed_tasks_.push_back(exec);
+        task_end_cv_.notify_all();
         
         if (--pending_tasks_ == 0 && next_task_index_ >= schedule_.tasks.size()) {
             completion_cv_.notify_all();
@@ -411,6 +1418,260 @@ void Orchestrator::execute_task(const ScheduledTask& task) {
     }
 }
 
+void Orchestrator::on_endpoint_state(EndpointId endpoint, bool alive) {
+    if (alive || !running_) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // Starts in flight fail over to another replica (quarantined ones are skipped)
+    for (const ActiveDispatch& dispatch : active_dispatches_) {
+        if (dispatch.endpoint == endpoint) {
+            dispatch.context->TryCancel();
+        }
+    }
+    
+    // Tasks started (or armed) there will never report their end. Those
+    // still being dispatched (dispatch not done) are left to their worker.
+    for (size_t i = 0; i < schedule_handles_.size(); i++) {
+        TaskHandle handle = schedule_handles_[i];
+        if (!tasks_.is_active(handle) || tasks_.endpoint[handle] != endpoint ||
+            tasks_.timeline[handle].dispatch_done_us == 0) {
+            continue;
+        }
+        std::cerr << "[Orchestrator] Task " << tasks_.id(handle) << " lost with "
+                  << endpoints_.address(endpoint) << ", marked FAILED" << std::endl;
+        endpoints_.end(endpoint, rt_task_[handle]);
+        abandon_task(handle, "Wrapper lost (heartbeat)");
+    }
+}
+
+void Orchestrator::abandon_task(TaskHandle handle, const std::string& reason) {
+    auto armed = std::find_if(armed_tasks_.begin(), armed_tasks_.end(), [this, handle](size_t index) {
+        return schedule_handles_[index] == handle;
+    });
+    if (armed != armed_tasks_.end()) {
+        *armed = armed_tasks_.back();
+        armed_tasks_.pop_back();
+    }
+    
+    tasks_.mark_completed(handle, TASK_STATE_FAILED, TASK_RESULT_FAILURE, get_current_time_us() - start_time_us_);
+    tasks_.error_message[handle] = reason;
+    record_execution(handle);
+    release_inputs(handle);
+    
+    task_end_cv_.notify_all();
+    if (--pending_tasks_ == 0 && next_task_index_ >= schedule_.tasks.size()) {
+        completion_cv_.notify_all();
+    }
+}
+
+void Orchestrator::attach_inputs(TaskHandle handle, StartTaskRequest& request) {
+    // A new dispatch of the task: references of the previous one are dropped
+    // after taking the new ones, so a buffer shared by both survives
+    std::vector<std::string> previous;
+    previous.swap(held_inputs_[handle]);
+    request.clear_inputs();
+    
+    for (TaskHandle producer : tasks_.dependencies(handle)) {
+        for (const TaskOutput& output : task_outputs_[producer]) {
+            if (!output.shm_segment().empty()) {
+                auto ref = output_refs_.find(output.shm_segment());
+                if (ref == output_refs_.end()) {
+                    continue;  // Already reclaimed
+                }
+                ref->second++;
+                held_inputs_[handle].push_back(output.shm_segment());
+            }
+            TaskOutput* input = request.add_inputs();
+            *input = output;
+            input->set_producer(tasks_.id(producer));
+        }
+        
+        // The last dependent to take the outputs releases the producer's reference
+        std::vector<TaskHandle>& waiting = waiting_consumers_[producer];
+        auto it = std::find(waiting.begin(), waiting.end(), handle);
+        if (it != waiting.end()) {
+            *it = waiting.back();
+            waiting.pop_back();
+            if (waiting.empty()) {
+                release_producer_outputs(producer);
+            }
+        }
+    }
+    
+    for (const std::string& segment : previous) {
+        release_output(segment);
+    }
+}
+
+void Orchestrator::inline_inputs(StartTaskRequest& request) {
+    ShmOutputBuffer buffer;
+    for (TaskOutput& input : *request.mutable_inputs()) {
+        if (input.shm_segment().empty() || !buffer.open(input.shm_segment(), input.size())) {
+            continue;  // A segment already gone is reported by the wrapper
+        }
+        input.set_data(buffer.data(), buffer.size());
+        input.clear_shm_segment();
+        input.clear_size();
+        buffer.close();
+    }
+}
+
+void Orchestrator::release_inputs(TaskHandle handle) {
+    for (const std::string& segment : held_inputs_[handle]) {
+        release_output(segment);
+    }
+    held_inputs_[handle].clear();
+}
+
+bool Orchestrator::keeps_outputs(TaskHandle handle, TaskResult result) const {
+    return result == TASK_RESULT_SUCCESS && !tasks_.dependents(handle).empty();
+}
+
+void Orchestrator::store_outputs(TaskHandle handle, const TaskEndNotification& notification, uint64_t digest) {
+    // Dependents that did not take the previous outputs never will
+    if (!waiting_consumers_[handle].empty()) {
+        waiting_consumers_[handle].clear();
+        release_producer_outputs(handle);
+    }
+    task_outputs_[handle].clear();
+    
+    // Outputs of a failed execution, or without a dependent, are dropped
+    const std::vector<TaskHandle>& dependents = tasks_.dependents(handle);
+    bool keep = keeps_outputs(handle, notification.result());
+    
+    // Cacheable dependents are keyed on what they will read
+    if (feeds_cacheable_[handle]) {
+        output_digest_[handle] = digest;
+    }
+    for (const TaskOutput& output : notification.outputs()) {
+        if (!keep) {
+            if (!output.shm_segment().empty()) {
+                ShmOutputBuffer::unlink(output.shm_segment());
+            }
+            continue;
+        }
+        if (!output.shm_segment().empty()) {
+            output_refs_[output.shm_segment()]++;
+        }
+        task_outputs_[handle].push_back(output);
+    }
+    if (keep && !task_outputs_[handle].empty()) {
+        waiting_consumers_[handle] = dependents;
+    }
+}
+
+uint64_t Orchestrator::result_cache_key(size_t task_index) const {
+    const ScheduledTask& task = schedule_.tasks[task_index];
+    std::vector<std::pair<std::string, uint64_t>> inputs;
+    for (TaskHandle producer : tasks_.dependencies(schedule_handles_[task_index])) {
+        inputs.emplace_back(tasks_.id(producer), output_digest_[producer]);
+    }
+    // 0 means "not cached"
+    return std::max<uint64_t>(ResultCache::key(task.task_id, task.parameters, inputs), 1);
+}
+
+void Orchestrator::complete_from_cache(size_t task_index, CachedResult& result) {
+    // The restored outputs are hashed before taking mutex_ (the schedule
+    // does not change during a run)
+    TaskHandle handle = schedule_handles_[task_index];
+    uint64_t digest = 0;
+    if (feeds_cacheable_[handle]) {
+        digest = ResultCache::digest(keeps_outputs(handle, TASK_RESULT_SUCCESS) ? result.outputs() :
+                                     google::protobuf::RepeatedPtrField<TaskOutput>());
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now_us = get_current_time_us() - start_time_us_;  // Relative to start
+    
+    std::cout << "[Orchestrator] Task " << tasks_.id(handle) << " completed from the result cache (saved "
+              << result.execution_duration_us() / 1000.0 << " ms)" << std::endl;
+    
+    TaskTimeline& timeline = tasks_.timeline[handle];
+    timeline.dispatch_done_us = now_us;
+    timeline.callback_start_us = now_us;
+    timeline.callback_end_us = now_us;
+    tasks_.actual_start_time_us[handle] = now_us;
+    tasks_.mark_completed(handle, TASK_STATE_COMPLETED, TASK_RESULT_SUCCESS, now_us);
+    tasks_.error_message[handle].clear();
+    record_execution(handle);
+    
+    // Nothing to store again; the outputs go to the dependents as usual
+    cache_key_[handle] = 0;
+    release_inputs(handle);
+    TaskEndNotification notification;
+    notification.set_result(TASK_RESULT_SUCCESS);
+    notification.mutable_outputs()->Swap(result.mutable_outputs());
+    store_outputs(handle, notification, digest);
+    
+    task_end_cv_.notify_all();
+    if (--pending_tasks_ == 0 && next_task_index_ >= schedule_.tasks.size()) {
+        completion_cv_.notify_all();
+    }
+}
+
+void Orchestrator::release_producer_outputs(TaskHandle producer) {
+    for (const TaskOutput& output : task_outputs_[producer]) {
+        if (!output.shm_segment().empty()) {
+            release_output(output.shm_segment());
+        }
+    }
+}
+
+void Orchestrator::release_output(const std::string& segment) {
+    auto ref = output_refs_.find(segment);
+    if (ref == output_refs_.end() || --ref->second > 0) {
+        return;
+    }
+    ShmOutputBuffer::unlink(segment);
+    output_refs_.erase(ref);
+}
+
+void Orchestrator::release_all_outputs() {
+    for (const auto& ref : output_refs_) {
+        ShmOutputBuffer::unlink(ref.first);
+    }
+    if (!output_refs_.empty()) {
+        std::cout << "[Orchestrator] Reclaimed " << output_refs_.size()
+                  << " shared-memory outputs" << std::endl;
+    }
+    output_refs_.clear();
+    for (size_t handle = 0; handle < task_outputs_.size(); handle++) {
+        task_outputs_[handle].clear();
+        waiting_consumers_[handle].clear();
+        held_inputs_[handle].clear();
+    }
+}
+
+void Orchestrator::disarm_pending_tasks() {
+    std::vector<size_t> armed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        armed.swap(armed_tasks_);
+    }
+    
+    for (size_t task_index : armed) {
+        const ScheduledTask& task = schedule_.tasks[task_index];
+        TaskHandle handle = schedule_handles_[task_index];
+        
+        DisarmTaskRequest request;
+        DisarmTaskResponse response;
+        request.set_task_id(task.task_id);
+        
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(1));
+        grpc::Status status = endpoints_.stub(tasks_.endpoint[handle])->DisarmTask(&context, request, &response);
+        
+        // Not disarmed: the task was already released (its end is just late)
+        if (status.ok() && response.success()) {
+            std::cout << "[Orchestrator] Disarmed " << task.task_id << " on "
+                      << endpoints_.address(tasks_.endpoint[handle]) << std::endl;
+        }
+    }
+}
+
 int64_t Orchestrator::get_current_time_us() const {
     return std::chrono::duration_cast<std::chrono::microseconds>(
         std::chrono::steady_clock::now().time_since_epoch()).count();
@@ -0,0 +1,198 @@
+#include "perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace orchestrator {
+
+namespace {
+
+const char* const METRIC_NAMES[PERF_COUNTER_COUNT] = {
+    "perf.task_clock_ns",
+    "perf.context_switches",
+    "perf.cpu_migrations",
+    "perf.page_faults",
+    "perf.cycles",
+    "perf.instructions",
+    "perf.cache_misses",
+    "perf.branch_misses",
+};
+
+const uint64_t SOFTWARE_CONFIGS[] = {
+    PERF_COUNT_SW_TASK_CLOCK,
+    PERF_COUNT_SW_CONTEXT_SWITCHES,
+    PERF_COUNT_SW_CPU_MIGRATIONS,
+    PERF_COUNT_SW_PAGE_FAULTS,
+};
+
+const uint64_t HARDWARE_CONFIGS[] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+thread_local pid_t t_tid = 0;
+
+pid_t current_tid() {
+    if (t_tid == 0) {
+        t_tid = static_cast<pid_t>(syscall(SYS_gettid));
+    }
+    return t_tid;
+}
+
+int perf_event_open(struct perf_event_attr* attr, pid_t tid, int group_fd) {
+    return static_cast<int>(syscall(SYS_perf_event_open, attr, tid, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters()
+    : tid_(0)
+    , warned_(false) {}
+
+PerfCounters::~PerfCounters() {
+    close_all();
+}
+
+const char* PerfCounters::metric_name(PerfCounter counter) {
+    return METRIC_NAMES[counter];
+}
+
+bool PerfCounters::parse_metric(const std::string& key, PerfCounter& counter) {
+    if (key.compare(0, 5, "perf.") != 0) {
+        return false;
+    }
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (key == METRIC_NAMES[i]) {
+            counter = static_cast<PerfCounter>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::open(pid_t tid) {
+    close_all();
+    tid_ = tid;
+    
+    open_group(groups_[0], PERF_TYPE_SOFTWARE, SOFTWARE_CONFIGS, PERF_TASK_CLOCK_NS, 4);
+    int software_errno = errno;
+    open_group(groups_[1], PERF_TYPE_HARDWARE, HARDWARE_CONFIGS, PERF_CYCLES, 4);
+    
+    if (!warned_) {
+        warned_ = true;
+        if (!software_available()) {
+            std::cerr << "[PerfCounters] perf_event_open unavailable (" << strerror(software_errno)
+                      << "), executions are not measured" << std::endl;
+        } else if (!hardware_available()) {
+            std::cout << "[PerfCounters] No hardware counters, measuring software counters only" << std::endl;
+        } else {
+            std::cout << "[PerfCounters] Measuring software and hardware counters" << std::endl;
+        }
+    }
+}
+
+void PerfCounters::open_group(Group& group, uint32_t type, const uint64_t* configs, int first, int count) {
+    group.first = first;
+    group.count = 0;
+    
+    for (int i = 0; i < count; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = configs[i];
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_hv = 1;
+        
+        // perf_event_paranoid >= 2 only allows user-space counting
+        int fd = perf_event_open(&attr, tid_, group.leader);
+        if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+            attr.exclude_kernel = 1;
+            fd = perf_event_open(&attr, tid_, group.leader);
+        }
+        
+        if (fd < 0) {
+            // Without a leader the group does not exist; a member is skipped
+            if (group.leader < 0) {
+                return;
+            }
+            continue;
+        }
+        if (group.leader < 0) {
+            group.leader = fd;
+        }
+        group.fds[group.count] = fd;
+        group.counters[group.count] = first + i;
+        group.count++;
+    }
+}
+
+void PerfCounters::close_all() {
+    for (Group& group : groups_) {
+        for (int i = 0; i < group.count; i++) {
+            close(group.fds[i]);
+        }
+        group.leader = -1;
+        group.count = 0;
+    }
+    tid_ = 0;
+}
+
+bool PerfCounters::read_group(const Group& group, GroupValues& values) {
+    if (group.leader < 0) {
+        return false;
+    }
+    ssize_t expected = static_cast<ssize_t>(3 + group.count) * sizeof(uint64_t);
+    return read(group.leader, &values, sizeof(values)) == expected &&
+           values.nr == static_cast<uint64_t>(group.count);
+}
+
+bool PerfCounters::begin() {
+    pid_t tid = current_tid();
+    if (tid != tid_) {
+        open(tid);
+    }
+    
+    bool any = false;
+    for (Group& group : groups_) {
+        any = read_group(group, group.before) || any;
+    }
+    return any;
+}
+
+void PerfCounters::end(PerfSample& sample) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        sample.values[i] = 0;
+        sample.valid[i] = false;
+    }
+    
+    for (const Group& group : groups_) {
+        GroupValues after;
+        if (!read_group(group, after)) {
+            continue;
+        }
+        
+        // Scale for the time the PMU multiplexed the group out
+        uint64_t enabled = after.time_enabled - group.before.time_enabled;
+        uint64_t running = after.time_running - group.before.time_running;
+        if (running == 0) {
+            continue;
+        }
+        double scale = enabled > running ? static_cast<double>(enabled) / running : 1.0;
+        
+        for (int i = 0; i < group.count; i++) {
+            int counter = group.counters[i];
+            uint64_t delta = after.values[i] - group.before.values[i];
+            sample.values[counter] = static_cast<int64_t>(delta * scale);
+            sample.valid[counter] = true;
+        }
+    }
+}
+
+} // namespace orchestrator
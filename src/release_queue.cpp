@@ -0,0 +1,71 @@
+#include "release_queue.h"
+#include <algorithm>
+#include <iostream>
+
+namespace orchestrator {
+
+ReleaseQueue::ReleaseQueue(DispatchOrder order)
+    : order_(order)
+    , next_sequence_(0) {}
+
+void ReleaseQueue::push(ReleasedTask task) {
+    task.sequence = next_sequence_++;
+    heap_.push_back(task);
+    std::push_heap(heap_.begin(), heap_.end(),
+        [this](const ReleasedTask& a, const ReleasedTask& b) { return after(a, b); });
+}
+
+ReleasedTask ReleaseQueue::pop() {
+    std::pop_heap(heap_.begin(), heap_.end(),
+        [this](const ReleasedTask& a, const ReleasedTask& b) { return after(a, b); });
+    ReleasedTask task = heap_.back();
+    heap_.pop_back();
+    return task;
+}
+
+void ReleaseQueue::clear() {
+    heap_.clear();
+    next_sequence_ = 0;
+}
+
+bool ReleaseQueue::after(const ReleasedTask& a, const ReleasedTask& b) const {
+    switch (order_) {
+        case DISPATCH_ORDER_PRIORITY:
+            if (a.priority != b.priority) {
+                return a.priority < b.priority;
+            }
+            break;
+        case DISPATCH_ORDER_EDF:
+            if (a.absolute_deadline_us != b.absolute_deadline_us) {
+                return a.absolute_deadline_us > b.absolute_deadline_us;
+            }
+            break;
+        case DISPATCH_ORDER_FIFO:
+            return a.sequence > b.sequence;
+    }
+    if (a.bottom_level_us != b.bottom_level_us) {
+        return a.bottom_level_us < b.bottom_level_us;
+    }
+    return a.sequence > b.sequence;
+}
+
+DispatchOrder ReleaseQueue::string_to_order(const std::string& name) {
+    if (name == "fifo") return DISPATCH_ORDER_FIFO;
+    if (name == "priority") return DISPATCH_ORDER_PRIORITY;
+    if (name == "edf") return DISPATCH_ORDER_EDF;
+    
+    std::cerr << "[ReleaseQueue] Unknown dispatch order '" << name
+              << "', using priority" << std::endl;
+    return DISPATCH_ORDER_PRIORITY;
+}
+
+std::string ReleaseQueue::order_to_string(DispatchOrder order) {
+    switch (order) {
+        case DISPATCH_ORDER_FIFO: return "fifo";
+        case DISPATCH_ORDER_PRIORITY: return "priority";
+        case DISPATCH_ORDER_EDF: return "edf";
+        default: return "unknown";
+    }
+}
+
+} // namespace orchestrator
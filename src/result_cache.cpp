@@ -0,0 +1,198 @@
+#include "result_cache.h"
+#include "shm_transport.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace orchestrator {
+
+namespace {
+
+// 64-bit FNV-1a; every field is length-prefixed so ("ab", "c") and
+// ("a", "bc") hash differently
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+void hash_bytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+void hash_field(uint64_t& hash, const char* data, size_t size) {
+    uint64_t length = size;
+    hash_bytes(hash, &length, sizeof(length));
+    hash_bytes(hash, data, size);
+}
+
+void hash_field(uint64_t& hash, const std::string& value) {
+    hash_field(hash, value.data(), value.size());
+}
+
+void hash_field(uint64_t& hash, uint64_t value) {
+    hash_bytes(hash, &value, sizeof(value));
+}
+
+// Bumped when the key or entry layout changes
+constexpr uint64_t CACHE_FORMAT = 1;
+
+} // namespace
+
+ResultCache::ResultCache()
+    : output_sequence_(0)
+    , hits_(0)
+    , misses_(0)
+    , stores_(0) {}
+
+bool ResultCache::open(const std::string& directory) {
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "[ResultCache] Cannot create " << directory << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    directory_ = directory;
+    std::cout << "[ResultCache] Caching results of cacheable tasks in " << directory_ << std::endl;
+    return true;
+}
+
+uint64_t ResultCache::key(const std::string& task_id, const std::map<std::string, std::string>& parameters,
+                          const std::vector<std::pair<std::string, uint64_t>>& inputs) {
+    uint64_t hash = FNV_OFFSET;
+    hash_field(hash, CACHE_FORMAT);
+    hash_field(hash, task_id);
+    hash_field(hash, parameters.size());
+    for (const auto& param : parameters) {
+        hash_field(hash, param.first);
+        hash_field(hash, param.second);
+    }
+    hash_field(hash, inputs.size());
+    for (const auto& input : inputs) {
+        hash_field(hash, input.first);
+        hash_field(hash, input.second);
+    }
+    return hash;
+}
+
+uint64_t ResultCache::digest(const google::protobuf::RepeatedPtrField<TaskOutput>& outputs) {
+    // One hash per output, combined in name order
+    std::vector<std::pair<std::string, uint64_t>> hashes;
+    hashes.reserve(outputs.size());
+    for (const TaskOutput& output : outputs) {
+        uint64_t hash = FNV_OFFSET;
+        if (output.shm_segment().empty()) {
+            hash_field(hash, output.data());
+        } else {
+            ShmOutputBuffer buffer;
+            if (buffer.open(output.shm_segment(), output.size())) {
+                hash_field(hash, buffer.data(), buffer.size());
+            } else {
+                // Unreadable: a digest no other run will produce
+                hash_field(hash, output.shm_segment());
+            }
+        }
+        hashes.emplace_back(output.name(), hash);
+    }
+    std::sort(hashes.begin(), hashes.end());
+    
+    uint64_t hash = FNV_OFFSET;
+    hash_field(hash, hashes.size());
+    for (const auto& entry : hashes) {
+        hash_field(hash, entry.first);
+        hash_field(hash, entry.second);
+    }
+    return hash;
+}
+
+std::string ResultCache::entry_path(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.result", static_cast<unsigned long long>(key));
+    return directory_ + name;
+}
+
+bool ResultCache::lookup(uint64_t key, const std::string& task_id, CachedResult& result) {
+    std::ifstream file(entry_path(key), std::ios::binary);
+    if (!file || !result.ParseFromIstream(&file) || result.key() != key || result.task_id() != task_id) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    return true;
+}
+
+bool ResultCache::store(uint64_t key, const std::string& task_id, int64_t execution_duration_us,
+                        const google::protobuf::RepeatedPtrField<TaskOutput>& outputs) {
+    CachedResult result;
+    result.set_task_id(task_id);
+    result.set_key(key);
+    result.set_execution_duration_us(execution_duration_us);
+    result.set_created_time_us(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    for (const TaskOutput& output : outputs) {
+        TaskOutput* stored = result.add_outputs();
+        stored->set_name(output.name());
+        if (output.shm_segment().empty()) {
+            stored->set_data(output.data());
+            continue;
+        }
+        ShmOutputBuffer buffer;
+        if (!buffer.open(output.shm_segment(), output.size())) {
+            std::cerr << "[ResultCache] Output " << output.name() << " of " << task_id
+                      << " is no longer readable, not cached" << std::endl;
+            return false;
+        }
+        stored->set_data(buffer.data(), buffer.size());
+    }
+    
+    // Written aside and renamed, so a concurrent or interrupted run never
+    // reads a partial entry
+    std::string path = entry_path(key);
+    std::string temporary = path + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file || !result.SerializeToOstream(&file)) {
+            std::cerr << "[ResultCache] Cannot write " << temporary << std::endl;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "[ResultCache] Cannot replace " << path << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    stores_++;
+    return true;
+}
+
+bool ResultCache::restore_outputs(google::protobuf::RepeatedPtrField<TaskOutput>& outputs) {
+    size_t inline_bytes = 0;
+    for (TaskOutput& output : outputs) {
+        if (inline_bytes + output.data().size() <= INLINE_OUTPUT_BYTES) {
+            inline_bytes += output.data().size();
+            continue;
+        }
+        std::string segment = "out_cache_" + std::to_string(getpid()) + "_" + std::to_string(output_sequence_++);
+        ShmOutputBuffer buffer;
+        if (!buffer.create(segment, output.data().size())) {
+            for (const TaskOutput& restored : outputs) {
+                if (!restored.shm_segment().empty()) {
+                    ShmOutputBuffer::unlink(restored.shm_segment());
+                }
+            }
+            return false;
+        }
+        memcpy(buffer.data(), output.data().data(), output.data().size());
+        output.set_shm_segment(segment);
+        output.set_size(output.data().size());
+        output.clear_data();
+    }
+    return true;
+}
+
+} // namespace orchestrator
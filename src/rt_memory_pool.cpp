@@ -0,0 +1,86 @@
+#include "rt_memory_pool.h"
+#include <cstdlib>
+#include <iostream>
+#include <sys/mman.h>
+
+namespace orchestrator {
+
+namespace {
+thread_local RTMemoryPool* t_current_pool = nullptr;
+}
+
+RTMemoryPool::RTMemoryPool(size_t capacity, HugePageMode huge_pages)
+    : base_(nullptr)
+    , capacity_(0)
+    , offset_(0)
+    , high_water_(0)
+    , overflows_(0)
+    , huge_(false) {
+    
+    if (capacity == 0) {
+        return;
+    }
+    
+    size_t mapped_bytes = 0;
+    base_ = static_cast<char*>(RTUtils::map_prefaulted(capacity, huge_pages, mapped_bytes, huge_));
+    if (!base_) {
+        std::cerr << "[RTMemoryPool] Failed to map the pool, allocations use the heap" << std::endl;
+        return;
+    }
+    capacity_ = mapped_bytes;
+    
+    std::cout << "[RTMemoryPool] " << capacity_ / 1024 << " KB pre-faulted"
+              << (huge_ ? " (huge pages)" : "") << std::endl;
+}
+
+RTMemoryPool::~RTMemoryPool() {
+    if (base_) {
+        munmap(base_, capacity_);
+    }
+}
+
+void* RTMemoryPool::allocate(size_t size, size_t alignment) {
+    size_t start = (offset_ + alignment - 1) & ~(alignment - 1);
+    if (base_ && start + size <= capacity_) {
+        offset_ = start + size;
+        if (offset_ > high_water_) {
+            high_water_ = offset_;
+        }
+        return base_ + start;
+    }
+    
+    // Exhausted: the execution still runs, at the cost of page faults
+    overflows_++;
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) != 0) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void RTMemoryPool::deallocate(void* ptr, size_t size) {
+    if (!owns(ptr)) {
+        free(ptr);
+        return;
+    }
+    
+    // Rewind only the most recent block (stack-like release)
+    if (static_cast<char*>(ptr) + size == base_ + offset_) {
+        offset_ = static_cast<char*>(ptr) - base_;
+    }
+}
+
+void RTMemoryPool::reset() {
+    offset_ = 0;
+    overflows_ = 0;
+}
+
+RTMemoryPool* RTMemoryPool::current() {
+    return t_current_pool;
+}
+
+void RTMemoryPool::set_current(RTMemoryPool* pool) {
+    t_current_pool = pool;
+}
+
+} // namespace orchestrator
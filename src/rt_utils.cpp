@@ -7,6 +7,19 @@
 #include <sched.h>
 #include <errno.h>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <cstdio>
+#include <vector>
+#include <sys/syscall.h>
+#include <malloc.h>
+#include <mutex>
+#include <linux/mempolicy.h>
+#include <grpcpp/resource_quota.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
 
 namespace orchestrator {
 
@@ -51,6 +64,146 @@ void RTUtils::prefault_stack(size_t size) {
     std::cout << "[RTUtils] Pre-faulted " << size << " bytes of stack" << std::endl;
 }
 
+bool RTUtils::apply_memory_profile(const RTConfig& config) {
+    static std::once_flag applied;
+    bool success = true;
+    std::call_once(applied, [&config, &success]() {
+        if (config.tune_malloc && !tune_malloc()) {
+            success = false;
+        }
+        if (config.heap_reserve_bytes > 0) {
+            if (!config.tune_malloc) {
+                std::cerr << "[RTUtils] Heap reserve without malloc tuning may be trimmed away" << std::endl;
+            }
+            reserve_heap(config.heap_reserve_bytes, config.huge_pages);
+        }
+    });
+    return success;
+}
+
+bool RTUtils::tune_malloc() {
+    // mallopt() returns 1 on success
+    bool success = mallopt(M_TRIM_THRESHOLD, -1) == 1 &&
+                   mallopt(M_MMAP_MAX, 0) == 1 &&
+                   mallopt(M_ARENA_MAX, 1) == 1;
+    if (!success) {
+        std::cerr << "[RTUtils] Failed to tune malloc" << std::endl;
+        return false;
+    }
+    
+    std::cout << "[RTUtils] malloc tuned: no trimming, no mmap allocations, single arena" << std::endl;
+    return true;
+}
+
+void RTUtils::reserve_heap(size_t bytes, HugePageMode huge_pages) {
+    int64_t minor_before;
+    int64_t major_before;
+    thread_page_faults(minor_before, major_before);
+    
+    char* reserve = static_cast<char*>(malloc(bytes));
+    if (!reserve) {
+        std::cerr << "[RTUtils] Failed to reserve " << bytes << " bytes of heap" << std::endl;
+        return;
+    }
+    
+    // THP for the aligned part of the reserve (best effort)
+    if (huge_pages != HUGE_PAGES_NONE) {
+        const uintptr_t HUGE_PAGE = 2 * 1024 * 1024;
+        uintptr_t begin = (reinterpret_cast<uintptr_t>(reserve) + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+        uintptr_t end = (reinterpret_cast<uintptr_t>(reserve) + bytes) & ~(HUGE_PAGE - 1);
+        if (end > begin) {
+            madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+        }
+    }
+    
+    long page_size = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < bytes; i += page_size) {
+        reinterpret_cast<volatile char*>(reserve)[i] = 0;
+    }
+    free(reserve);
+    
+    int64_t minor_after;
+    int64_t major_after;
+    thread_page_faults(minor_after, major_after);
+    std::cout << "[RTUtils] Pre-touched " << bytes << " bytes of heap ("
+              << minor_after - minor_before << " page faults taken now)" << std::endl;
+}
+
+void* RTUtils::map_prefaulted(size_t bytes, HugePageMode huge_pages, size_t& mapped_bytes, bool& huge) {
+    const size_t HUGE_PAGE = 2 * 1024 * 1024;
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    void* memory = MAP_FAILED;
+    huge = false;
+    
+    // hugetlbfs pages are reserved by the administrator (vm.nr_hugepages)
+    if (huge_pages == HUGE_PAGES_EXPLICIT) {
+        mapped_bytes = (bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+        memory = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+        if (memory != MAP_FAILED) {
+            huge = true;
+        } else {
+            std::cerr << "[RTUtils] No explicit huge pages (" << strerror(errno)
+                      << "), using transparent huge pages" << std::endl;
+        }
+    }
+    
+    if (memory == MAP_FAILED) {
+        mapped_bytes = (bytes + page_size - 1) & ~(page_size - 1);
+        memory = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            std::cerr << "[RTUtils] Failed to map " << mapped_bytes << " bytes: " << strerror(errno) << std::endl;
+            return nullptr;
+        }
+        if (huge_pages != HUGE_PAGES_NONE) {
+            huge = madvise(memory, mapped_bytes, MADV_HUGEPAGE) == 0;
+        }
+    }
+    
+    // Fault every page in now (MAP_POPULATE is only a hint for THP)
+    for (size_t i = 0; i < mapped_bytes; i += page_size) {
+        static_cast<volatile char*>(memory)[i] = 0;
+    }
+    return memory;
+}
+
+void RTUtils::thread_page_faults(int64_t& minor, int64_t& major) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        minor = 0;
+        major = 0;
+        return;
+    }
+    minor = usage.ru_minflt;
+    major = usage.ru_majflt;
+}
+
+std::string RTUtils::huge_pages_to_string(HugePageMode mode) {
+    switch (mode) {
+        case HUGE_PAGES_NONE:
+            return "none";
+        case HUGE_PAGES_TRANSPARENT:
+            return "thp";
+        case HUGE_PAGES_EXPLICIT:
+            return "explicit";
+        default:
+            return "unknown";
+    }
+}
+
+HugePageMode RTUtils::string_to_huge_pages(const std::string& mode_str) {
+    if (mode_str == "thp") {
+        return HUGE_PAGES_TRANSPARENT;
+    } else if (mode_str == "explicit") {
+        return HUGE_PAGES_EXPLICIT;
+    } else if (mode_str == "none") {
+        return HUGE_PAGES_NONE;
+    }
+    
+    std::cerr << "[RTUtils] Unknown huge page mode: " << mode_str << std::endl;
+    return HUGE_PAGES_NONE;
+}
+
 bool RTUtils::set_thread_realtime(RTSchedulingPolicy policy, int priority) {
     return set_thread_realtime(pthread_self(), policy, priority);
 }
@@ -93,6 +246,23 @@ bool RTUtils::set_thread_realtime(pthread_t thread, RTSchedulingPolicy policy, i
     return true;
 }
 
+bool RTUtils::set_thread_normal(pthread_t thread) {
+    int sched_policy;
+    struct sched_param param;
+    if (pthread_getschedparam(thread, &sched_policy, &param) == 0 && sched_policy == SCHED_OTHER) {
+        return true;
+    }
+    
+    memset(&param, 0, sizeof(param));
+    int error = pthread_setschedparam(thread, SCHED_OTHER, &param);
+    if (error != 0) {
+        std::cerr << "[RTUtils] Failed to reset scheduling policy: " << strerror(error) << std::endl;
+        return false;
+    }
+    std::cout << "[RTUtils] Set thread to SCHED_OTHER" << std::endl;
+    return true;
+}
+
 bool RTUtils::set_cpu_affinity(int cpu_id) {
     return set_cpu_affinity(pthread_self(), cpu_id);
 }
@@ -117,6 +287,196 @@ bool RTUtils::set_cpu_affinity(pthread_t thread, int cpu_id) {
     return true;
 }
 
+bool RTUtils::set_cpu_affinity(pthread_t thread, const std::string& cpu_list) {
+    cpu_set_t cpuset;
+    if (!parse_cpu_list(cpu_list, cpuset)) {
+        std::cerr << "[RTUtils] Invalid CPU list: " << cpu_list << std::endl;
+        return false;
+    }
+    
+    // pthread_setaffinity_np returns the error instead of setting errno
+    int result = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+    if (result != 0) {
+        std::cerr << "[RTUtils] Failed to set CPU affinity to CPUs " << cpu_list
+                  << ": " << strerror(result) << std::endl;
+        return false;
+    }
+    
+    std::cout << "[RTUtils] Set CPU affinity to CPUs " << cpu_list << std::endl;
+    return true;
+}
+
+bool RTUtils::clear_cpu_affinity(pthread_t thread) {
+    // Every CPU; the kernel keeps the thread within its cpuset
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        CPU_SET(cpu, &cpuset);
+    }
+    int result = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+    if (result != 0) {
+        std::cerr << "[RTUtils] Failed to clear CPU affinity: " << strerror(result) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool RTUtils::parse_cpu_list(const std::string& cpu_list, cpu_set_t& cpus) {
+    CPU_ZERO(&cpus);
+    size_t pos = 0;
+    while (pos < cpu_list.size()) {
+        size_t end = cpu_list.find(',', pos);
+        if (end == std::string::npos) {
+            end = cpu_list.size();
+        }
+        
+        // "n" or "first-last"
+        std::string range = cpu_list.substr(pos, end - pos);
+        size_t dash = range.find('-');
+        char* rest = nullptr;
+        long first = strtol(range.c_str(), &rest, 10);
+        long last = first;
+        if (dash != std::string::npos) {
+            if (dash == 0 || rest != range.c_str() + dash) {
+                return false;
+            }
+            last = strtol(range.c_str() + dash + 1, &rest, 10);
+        }
+        if (range.empty() || *rest != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) {
+            return false;
+        }
+        for (long cpu = first; cpu <= last; cpu++) {
+            CPU_SET(cpu, &cpus);
+        }
+        pos = end + 1;
+    }
+    return CPU_COUNT(&cpus) > 0;
+}
+
+bool RTUtils::is_cpu_list(const std::string& value) {
+    return value.find_first_of(",-") != std::string::npos;
+}
+
+uint64_t RTUtils::numa_nodes_of_cpus(const cpu_set_t& cpus) {
+    // CPUs of each node, read once
+    static const std::vector<cpu_set_t> node_cpus = []() {
+        std::vector<cpu_set_t> nodes;
+        for (int node = 0; node < 64; node++) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            std::string list;
+            if (!std::getline(file, list)) {
+                break;
+            }
+            cpu_set_t set;
+            if (!parse_cpu_list(list, set)) {
+                CPU_ZERO(&set);  // Memory-only node
+            }
+            nodes.push_back(set);
+        }
+        return nodes;
+    }();
+    
+    uint64_t node_mask = 0;
+    for (size_t node = 0; node < node_cpus.size(); node++) {
+        cpu_set_t common;
+        CPU_AND(&common, &node_cpus[node], &cpus);
+        if (CPU_COUNT(&common) > 0) {
+            node_mask |= uint64_t(1) << node;
+        }
+    }
+    return node_mask;
+}
+
+bool RTUtils::set_numa_policy(NumaPolicy policy, uint64_t node_mask) {
+    int mode = MPOL_DEFAULT;
+    if (policy == NUMA_POLICY_PREFERRED) {
+        // MPOL_PREFERRED takes a single node: the first one
+        mode = MPOL_PREFERRED;
+        node_mask &= ~(node_mask - 1);
+    } else if (policy == NUMA_POLICY_BIND) {
+        mode = MPOL_BIND;
+    }
+    if (mode != MPOL_DEFAULT && node_mask == 0) {
+        std::cerr << "[RTUtils] No NUMA node for the memory policy" << std::endl;
+        return false;
+    }
+    
+    unsigned long mask = static_cast<unsigned long>(node_mask);
+    const unsigned long* nodes = mode == MPOL_DEFAULT ? nullptr : &mask;
+    if (syscall(SYS_set_mempolicy, mode, nodes, mode == MPOL_DEFAULT ? 0 : 64) != 0) {
+        std::cerr << "[RTUtils] Failed to set NUMA policy " << numa_policy_to_string(policy)
+                  << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    if (mode != MPOL_DEFAULT) {
+        std::cout << "[RTUtils] Memory " << (mode == MPOL_BIND ? "bound" : "preferred")
+                  << " to NUMA nodes 0x" << std::hex << node_mask << std::dec << std::endl;
+    }
+    return true;
+}
+
+bool RTUtils::numa_page_counts(uint64_t node_mask, int64_t& local_pages, int64_t& remote_pages) {
+    FILE* numa_maps = fopen("/proc/self/numa_maps", "r");
+    if (!numa_maps) {
+        return false;
+    }
+    
+    local_pages = 0;
+    remote_pages = 0;
+    char* line = nullptr;
+    size_t capacity = 0;
+    while (getline(&line, &capacity, numa_maps) > 0) {
+        // "... N<node>=<pages> ..."
+        for (const char* token = line; (token = strchr(token, 'N')) != nullptr; token++) {
+            if ((token != line && token[-1] != ' ') || !isdigit(static_cast<unsigned char>(token[1]))) {
+                continue;
+            }
+            char* rest = nullptr;
+            long node = strtol(token + 1, &rest, 10);
+            if (*rest != '=') {
+                continue;
+            }
+            int64_t pages = strtoll(rest + 1, &rest, 10);
+            if (node < 64 && (node_mask & (uint64_t(1) << node))) {
+                local_pages += pages;
+            } else {
+                remote_pages += pages;
+            }
+            token = rest - 1;
+        }
+    }
+    free(line);
+    fclose(numa_maps);
+    return true;
+}
+
+std::string RTUtils::numa_policy_to_string(NumaPolicy policy) {
+    switch (policy) {
+        case NUMA_POLICY_NONE:
+            return "none";
+        case NUMA_POLICY_PREFERRED:
+            return "preferred";
+        case NUMA_POLICY_BIND:
+            return "bind";
+        default:
+            return "unknown";
+    }
+}
+
+NumaPolicy RTUtils::string_to_numa_policy(const std::string& policy_str) {
+    if (policy_str == "bind") {
+        return NUMA_POLICY_BIND;
+    } else if (policy_str == "preferred") {
+        return NUMA_POLICY_PREFERRED;
+    } else if (policy_str == "none") {
+        return NUMA_POLICY_NONE;
+    }
+    
+    std::cerr << "[RTUtils] Unknown NUMA policy string: " << policy_str << std::endl;
+    return NUMA_POLICY_NONE;
+}
+
 bool RTUtils::apply_rt_config(const RTConfig& config) {
     return apply_rt_config(pthread_self(), config);
 }
@@ -125,7 +485,10 @@ bool RTUtils::apply_rt_config(pthread_t thread, const RTConfig& config) {
     std::cout << "[RTUtils] Applying real-time configuration:" << std::endl;
     std::cout << "  Policy: " << policy_to_string(config.policy) << std::endl;
     std::cout << "  Priority: " << config.priority << std::endl;
-    std::cout << "  CPU Affinity: " << (config.cpu_affinity >= 0 ? std::to_string(config.cpu_affinity) : "none") << std::endl;
+    std::cout << "  CPU Affinity: " << (config.cpus().empty() ? "none" : config.cpus()) << std::endl;
+    if (config.numa_policy != NUMA_POLICY_NONE) {
+        std::cout << "  NUMA Policy: " << numa_policy_to_string(config.numa_policy) << std::endl;
+    }
     std::cout << "  Lock Memory: " << (config.lock_memory ? "yes" : "no") << std::endl;
     std::cout << "  Prefault Stack: " << (config.prefault_stack ? "yes" : "no") << std::endl;
     
@@ -146,12 +509,28 @@ bool RTUtils::apply_rt_config(pthread_t thread, const RTConfig& config) {
     
     // Set CPU affinity BEFORE RT policy (important!)
     // Setting affinity after RT policy may fail on some systems
-    if (config.cpu_affinity >= 0) {
+    if (!config.cpu_list.empty()) {
+        if (!set_cpu_affinity(thread, config.cpu_list)) {
+            success = false;
+        }
+    } else if (config.cpu_affinity >= 0) {
         if (!set_cpu_affinity(thread, config.cpu_affinity)) {
             success = false;
         }
     }
     
+    // Memory of the thread on the nodes of its CPUs (set_mempolicy only
+    // applies to the calling thread)
+    cpu_set_t cpus;
+    if (config.numa_policy != NUMA_POLICY_NONE && parse_cpu_list(config.cpus(), cpus)) {
+        if (!pthread_equal(thread, pthread_self())) {
+            std::cerr << "[RTUtils] NUMA policy can only be applied to the calling thread" << std::endl;
+            success = false;
+        } else if (!set_numa_policy(config.numa_policy, numa_nodes_of_cpus(cpus))) {
+            success = false;
+        }
+    }
+    
     // Set real-time scheduling policy AFTER CPU affinity
     if (config.policy != RT_POLICY_NONE) {
         if (!set_thread_realtime(thread, config.policy, config.priority)) {
@@ -238,6 +617,188 @@ RTSchedulingPolicy RTUtils::string_to_policy(const std::string& policy_str) {
     return RT_POLICY_NONE;
 }
 
+std::unique_ptr<grpc::Server> RTUtils::build_grpc_server(grpc::ServerBuilder& builder, const RTConfig& config,
+                                                        int stream_threads) {
+    if (config.grpc_pollers > 0) {
+        // One completion queue, a fixed set of pollers
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::NUM_CQS, 1);
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MIN_POLLERS, config.grpc_pollers);
+        builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MAX_POLLERS, config.grpc_pollers);
+    }
+    if (config.grpc_max_threads > 0) {
+        grpc::ResourceQuota quota("rt_server_quota");
+        quota.SetMaxThreads(config.grpc_max_threads + stream_threads);
+        builder.SetResourceQuota(quota);
+    }
+    
+    if (!config.configures_grpc()) {
+        return builder.BuildAndStart();
+    }
+    
+    // The pollers are created by BuildAndStart() and inherit this thread's
+    // policy (thread names are set asynchronously, a later sweep may miss them)
+    int saved_policy = 0;
+    struct sched_param saved_param;
+    bool switched = false;
+    if (config.grpc_policy != RT_POLICY_NONE &&
+        pthread_getschedparam(pthread_self(), &saved_policy, &saved_param) == 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = config.grpc_priority;
+        int error = pthread_setschedparam(pthread_self(), policy_to_sched_policy(config.grpc_policy), &param);
+        if (error != 0) {
+            std::cerr << "[RTUtils] Failed to set policy of the gRPC server threads: "
+                      << strerror(error) << std::endl;
+        } else {
+            switched = true;
+        }
+    }
+    
+    std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+    
+    if (switched) {
+        pthread_setschedparam(pthread_self(), saved_policy, &saved_param);
+    }
+    if (server) {
+        configure_grpc_threads(config);
+    }
+    return server;
+}
+
+namespace {
+
+// Internal gRPC threads that never run application code
+const char* const GRPC_HOUSEKEEPING_THREAD_NAMES[] = {
+    "grpc_global_tim", "timer_manager", "default-executo", "resolver-execut", "event_engine"
+};
+
+bool name_matches(const std::string& name, const char* prefix) {
+    return name.compare(0, strlen(prefix), prefix) == 0;
+}
+
+} // namespace
+
+int RTUtils::configure_grpc_threads(const RTConfig& config) {
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) {
+        std::cerr << "[RTUtils] Cannot list threads: " << strerror(errno) << std::endl;
+        return -1;
+    }
+    
+    std::vector<pid_t> server_threads;
+    std::vector<pid_t> housekeeping_threads;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        std::ifstream comm(std::string("/proc/self/task/") + entry->d_name + "/comm");
+        std::string name;
+        if (!std::getline(comm, name)) {
+            continue;
+        }
+        
+        pid_t tid = static_cast<pid_t>(std::stol(entry->d_name));
+        if (name_matches(name, GRPC_SERVER_THREAD_NAME)) {
+            server_threads.push_back(tid);
+            continue;
+        }
+        for (const char* housekeeping : GRPC_HOUSEKEEPING_THREAD_NAMES) {
+            if (name_matches(name, housekeeping)) {
+                housekeeping_threads.push_back(tid);
+                break;
+            }
+        }
+    }
+    closedir(dir);
+    
+    int configured = 0;
+    bool success = true;
+    
+    // sched_setscheduler()/sched_setaffinity() act on a single thread when
+    // given a thread id
+    if (config.grpc_policy != RT_POLICY_NONE) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = config.grpc_priority;
+        for (pid_t tid : server_threads) {
+            if (sched_setscheduler(tid, policy_to_sched_policy(config.grpc_policy), &param) != 0) {
+                std::cerr << "[RTUtils] Failed to set policy of gRPC thread " << tid << ": "
+                          << strerror(errno) << std::endl;
+                success = false;
+            } else {
+                configured++;
+            }
+        }
+    }
+    
+    // Housekeeping threads inherit the policy of the thread that created
+    // them (the pollers, or an RT main thread): they go back to SCHED_OTHER
+    // so they never compete with the RT work
+    int demoted = 0;
+    for (pid_t tid : housekeeping_threads) {
+        int policy = sched_getscheduler(tid);
+        if (policy == SCHED_OTHER || policy < 0) {
+            continue;
+        }
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        if (sched_setscheduler(tid, SCHED_OTHER, &param) != 0) {
+            std::cerr << "[RTUtils] Failed to reset policy of gRPC thread " << tid << ": "
+                      << strerror(errno) << std::endl;
+            success = false;
+        } else {
+            demoted++;
+        }
+    }
+    configured += demoted;
+    
+    if (config.housekeeping_cpu_mask != 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for (int cpu = 0; cpu < 64; cpu++) {
+            if (config.housekeeping_cpu_mask & (uint64_t(1) << cpu)) {
+                CPU_SET(cpu, &cpuset);
+            }
+        }
+        for (pid_t tid : housekeeping_threads) {
+            if (sched_setaffinity(tid, sizeof(cpuset), &cpuset) != 0) {
+                std::cerr << "[RTUtils] Failed to set CPU mask of gRPC thread " << tid << ": "
+                          << strerror(errno) << std::endl;
+                success = false;
+            } else {
+                configured++;
+            }
+        }
+    }
+    
+    std::cout << "[RTUtils] gRPC threads: " << server_threads.size() << " server";
+    if (config.grpc_policy != RT_POLICY_NONE) {
+        std::cout << " (" << policy_to_string(config.grpc_policy) << " " << config.grpc_priority << ")";
+    }
+    std::cout << ", " << housekeeping_threads.size() << " housekeeping";
+    if (config.housekeeping_cpu_mask != 0) {
+        std::cout << " (CPU mask 0x" << std::hex << config.housekeeping_cpu_mask << std::dec << ")";
+    }
+    if (demoted > 0) {
+        std::cout << ", " << demoted << " moved to SCHED_OTHER";
+    }
+    std::cout << std::endl;
+    
+    return success ? configured : -1;
+}
+
+uint64_t RTUtils::string_to_cpu_mask(const std::string& mask_str) {
+    try {
+        if (mask_str.compare(0, 2, "0b") == 0) {
+            return std::stoull(mask_str.substr(2), nullptr, 2);
+        }
+        return std::stoull(mask_str, nullptr, 0);
+    } catch (...) {
+        std::cerr << "[RTUtils] Invalid CPU mask: " << mask_str << std::endl;
+        return 0;
+    }
+}
+
 int RTUtils::policy_to_sched_policy(RTSchedulingPolicy policy) {
     switch (policy) {
         case RT_POLICY_FIFO:
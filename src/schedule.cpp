@@ -1,4 +1,6 @@
 #include "schedule.h"
+#include "address_utils.h"
+#include "rt_utils.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -6,115 +8,207 @@
 
 namespace orchestrator {
 
-TaskSchedule ScheduleParser::parse_yaml(const std::string& yaml_path) {
-    std::cout << "[ScheduleParser] Parsing YAML file: " << yaml_path << std::endl;
+namespace {
+
+// cpu_affinity is a single CPU (3) or a CPU list ("2-5,8")
+void parse_cpu_affinity(const YAML::Node& node, int32_t& cpu_affinity, std::string& cpu_list) {
+    std::string value = node.as<std::string>();
+    if (RTUtils::is_cpu_list(value)) {
+        cpu_set_t cpus;
+        if (!RTUtils::parse_cpu_list(value, cpus)) {
+            std::cerr << "[ScheduleParser] Warning: invalid CPU list '" << value << "', ignored" << std::endl;
+            return;
+        }
+        cpu_affinity = -1;
+        cpu_list = value;
+    } else {
+        cpu_affinity = node.as<int>();
+        cpu_list.clear();
+    }
+}
+
+// Tasks logged individually while parsing
+constexpr size_t MAX_LISTED_TASKS = 50;
+
+// Schedule from a parsed document (YAML, or JSON which yaml-cpp reads as YAML)
+TaskSchedule parse_schedule(const YAML::Node& config) {
+    TaskSchedule schedule;
     
-    try {
-        YAML::Node config = YAML::LoadFile(yaml_path);
-        TaskSchedule schedule;
+    // Parse schedule metadata
+    if (config["schedule"]) {
+        YAML::Node sched = config["schedule"];
         
-        // Parse schedule metadata
-        if (config["schedule"]) {
-            YAML::Node sched = config["schedule"];
-            
-            if (sched["name"]) {
-                std::cout << "[ScheduleParser] Schedule name: " << sched["name"].as<std::string>() << std::endl;
-            }
-            
-            if (sched["description"]) {
-                std::cout << "[ScheduleParser] Description: " << sched["description"].as<std::string>() << std::endl;
-            }
-            
-            // Parse defaults
-            int default_priority = 50;
-            int default_max_retries = 3;
-            bool default_critical = false;
-            int64_t default_deadline_us = 1000000;
-            std::string default_rt_policy = "none";
-            int default_rt_priority = 50;
-            int default_cpu_affinity = -1;
-            
-            if (sched["defaults"]) {
-                YAML::Node defaults = sched["defaults"];
-                if (defaults["priority"]) default_priority = defaults["priority"].as<int>();
-                if (defaults["max_retries"]) default_max_retries = defaults["max_retries"].as<int>();
-                if (defaults["critical"]) default_critical = defaults["critical"].as<bool>();
-                if (defaults["deadline_us"]) default_deadline_us = defaults["deadline_us"].as<int64_t>();
-                if (defaults["rt_policy"]) default_rt_policy = defaults["rt_policy"].as<std::string>();
-                if (defaults["rt_priority"]) default_rt_priority = defaults["rt_priority"].as<int>();
-                if (defaults["cpu_affinity"]) default_cpu_affinity = defaults["cpu_affinity"].as<int>();
+        if (sched["name"]) {
+            std::cout << "[ScheduleParser] Schedule name: " << sched["name"].as<std::string>() << std::endl;
+        }
+        
+        if (sched["description"]) {
+            std::cout << "[ScheduleParser] Description: " << sched["description"].as<std::string>() << std::endl;
+        }
+        
+        // Parse defaults
+        int default_priority = 50;
+        int default_max_retries = 3;
+        bool default_critical = false;
+        bool default_cacheable = false;
+        int64_t default_deadline_us = 1000000;
+        int64_t default_estimated_duration_us = 1000000;
+        bool default_estimate_declared = false;
+        std::string default_rt_policy = "none";
+        int default_rt_priority = 50;
+        int default_cpu_affinity = -1;
+        std::string default_cpu_list;
+        double default_cpu_bandwidth = 0;
+        int64_t default_memory_limit_bytes = 0;
+        
+        if (sched["defaults"]) {
+            YAML::Node defaults = sched["defaults"];
+            if (defaults["priority"]) default_priority = defaults["priority"].as<int>();
+            if (defaults["max_retries"]) default_max_retries = defaults["max_retries"].as<int>();
+            if (defaults["critical"]) default_critical = defaults["critical"].as<bool>();
+            if (defaults["cacheable"]) default_cacheable = defaults["cacheable"].as<bool>();
+            if (defaults["deadline_us"]) default_deadline_us = defaults["deadline_us"].as<int64_t>();
+            if (defaults["estimated_duration_us"]) {
+                default_estimated_duration_us = defaults["estimated_duration_us"].as<int64_t>();
+                default_estimate_declared = true;
             }
+            if (defaults["rt_policy"]) default_rt_policy = defaults["rt_policy"].as<std::string>();
+            if (defaults["rt_priority"]) default_rt_priority = defaults["rt_priority"].as<int>();
+            if (defaults["cpu_affinity"]) parse_cpu_affinity(defaults["cpu_affinity"], default_cpu_affinity, default_cpu_list);
+            if (defaults["cpu_bandwidth"]) default_cpu_bandwidth = defaults["cpu_bandwidth"].as<double>();
+            if (defaults["memory_limit_bytes"]) default_memory_limit_bytes = defaults["memory_limit_bytes"].as<int64_t>();
+        }
+        
+        // Check if running in Docker
+        const char* docker_env = std::getenv("DOCKER_CONTAINER");
+        bool use_docker_hostnames = (docker_env != nullptr);
+        
+        // Parse tasks
+        if (sched["tasks"]) {
+            YAML::Node tasks = sched["tasks"];
             
-            // Check if running in Docker
-            const char* docker_env = std::getenv("DOCKER_CONTAINER");
-            bool use_docker_hostnames = (docker_env != nullptr);
-            
-            // Parse tasks
-            if (sched["tasks"]) {
-                YAML::Node tasks = sched["tasks"];
+            for (size_t i = 0; i < tasks.size(); i++) {
+                YAML::Node task_node = tasks[i];
+                ScheduledTask task;
+                
+                // Required fields
+                task.task_id = task_node["id"].as<std::string>();
                 
-                for (size_t i = 0; i < tasks.size(); i++) {
-                    YAML::Node task_node = tasks[i];
-                    ScheduledTask task;
-                    
-                    // Required fields
-                    task.task_id = task_node["id"].as<std::string>();
-                    
-                    // Address: use as-is from YAML (no conversion)
-                    task.task_address = task_node["address"].as<std::string>();
-                    
-                    // Execution mode
-                    std::string mode = task_node["mode"].as<std::string>();
-                    if (mode == "sequential") {
-                        task.execution_mode = TASK_MODE_SEQUENTIAL;
-                        task.scheduled_time_us = 0;
-                    } else if (mode == "timed") {
-                        task.execution_mode = TASK_MODE_TIMED;
-                        task.scheduled_time_us = task_node["scheduled_time_us"].as<int64_t>();
+                // Address: use as-is from YAML (no conversion).
+                // A list declares equivalent replicas of the same task.
+                YAML::Node address_node = task_node["address"];
+                if (address_node.IsSequence()) {
+                    for (size_t j = 0; j < address_node.size(); j++) {
+                        task.task_addresses.push_back(address_node[j].as<std::string>());
                     }
-                    
-                    // Dependencies
-                    if (task_node["depends_on"]) {
-                        task.wait_for_task_id = task_node["depends_on"].as<std::string>();
-                    } else {
-                        task.wait_for_task_id = "";
+                } else {
+                    task.task_addresses.push_back(address_node.as<std::string>());
+                }
+                if (task.task_addresses.empty()) {
+                    std::cerr << "[ScheduleParser] Task " << task.task_id
+                              << " has an empty address list, skipping" << std::endl;
+                    continue;
+                }
+                task.task_address = task.task_addresses.front();
+                
+                // host:port or unix:<path>, optionally behind shm://
+                for (const std::string& address : task.task_addresses) {
+                    if (!AddressUtils::is_valid(AddressUtils::strip_shm(address))) {
+                        std::cerr << "[ScheduleParser] Warning: task " << task.task_id
+                                  << " has malformed address '" << address
+                                  << "' (expected host:port or unix:<path>)" << std::endl;
                     }
-                    
-                    // Optional fields with defaults
-                    task.priority = task_node["priority"] ? task_node["priority"].as<int>() : default_priority;
-                    task.max_retries = task_node["max_retries"] ? task_node["max_retries"].as<int>() : default_max_retries;
-                    task.critical = task_node["critical"] ? task_node["critical"].as<bool>() : default_critical;
-                    task.deadline_us = task_node["deadline_us"] ? task_node["deadline_us"].as<int64_t>() : default_deadline_us;
-                    task.estimated_duration_us = task_node["estimated_duration_us"] ? task_node["estimated_duration_us"].as<int64_t>() : 1000000;
-                    
-                    // Real-time configuration
-                    task.rt_policy = task_node["rt_policy"] ? task_node["rt_policy"].as<std::string>() : default_rt_policy;
-                    task.rt_priority = task_node["rt_priority"] ? task_node["rt_priority"].as<int>() : default_rt_priority;
-                    task.cpu_affinity = task_node["cpu_affinity"] ? task_node["cpu_affinity"].as<int>() : default_cpu_affinity;
-                    
-                    // Parameters
-                    if (task_node["parameters"]) {
-                        YAML::Node params = task_node["parameters"];
-                        for (YAML::const_iterator it = params.begin(); it != params.end(); ++it) {
-                            task.parameters[it->first.as<std::string>()] = it->second.as<std::string>();
-                        }
+                }
+                
+                // Execution mode
+                std::string mode = task_node["mode"].as<std::string>();
+                if (mode == "sequential") {
+                    task.execution_mode = TASK_MODE_SEQUENTIAL;
+                    task.scheduled_time_us = 0;
+                } else if (mode == "timed") {
+                    task.execution_mode = TASK_MODE_TIMED;
+                    task.scheduled_time_us = task_node["scheduled_time_us"].as<int64_t>();
+                }
+                
+                // Dependencies: one task id or a list (the task waits for all)
+                YAML::Node depends_node = task_node["depends_on"];
+                if (depends_node.IsSequence()) {
+                    for (size_t j = 0; j < depends_node.size(); j++) {
+                        task.depends_on.push_back(depends_node[j].as<std::string>());
                     }
-                    
-                    // Add task_id to parameters
-                    task.parameters["task_id"] = task.task_id;
-                    
-                    schedule.tasks.push_back(task);
-                    
-                    std::cout << "[ScheduleParser] Loaded task: " << task.task_id 
-                              << " (" << mode << ")" << std::endl;
+                } else if (depends_node && !depends_node.as<std::string>().empty()) {
+                    task.depends_on.push_back(depends_node.as<std::string>());
                 }
+                task.wait_for_task_id = task.depends_on.empty() ? "" : task.depends_on.front();
+                
+                // Optional fields with defaults
+                task.priority = task_node["priority"] ? task_node["priority"].as<int>() : default_priority;
+                task.max_retries = task_node["max_retries"] ? task_node["max_retries"].as<int>() : default_max_retries;
+                task.critical = task_node["critical"] ? task_node["critical"].as<bool>() : default_critical;
+                task.cacheable = task_node["cacheable"] ? task_node["cacheable"].as<bool>() : default_cacheable;
+                task.deadline_us = task_node["deadline_us"] ? task_node["deadline_us"].as<int64_t>() : default_deadline_us;
+                task.estimated_duration_us = task_node["estimated_duration_us"] ? task_node["estimated_duration_us"].as<int64_t>() : default_estimated_duration_us;
+                task.estimate_declared = task_node["estimated_duration_us"] ? true : default_estimate_declared;
+                
+                // Real-time configuration
+                task.rt_policy = task_node["rt_policy"] ? task_node["rt_policy"].as<std::string>() : default_rt_policy;
+                task.rt_priority = task_node["rt_priority"] ? task_node["rt_priority"].as<int>() : default_rt_priority;
+                task.cpu_affinity = default_cpu_affinity;
+                task.cpu_list = default_cpu_list;
+                if (task_node["cpu_affinity"]) {
+                    parse_cpu_affinity(task_node["cpu_affinity"], task.cpu_affinity, task.cpu_list);
+                }
+                
+                // cgroup isolation
+                task.cpu_bandwidth = task_node["cpu_bandwidth"] ? task_node["cpu_bandwidth"].as<double>() : default_cpu_bandwidth;
+                task.memory_limit_bytes = task_node["memory_limit_bytes"] ? task_node["memory_limit_bytes"].as<int64_t>() : default_memory_limit_bytes;
+                
+                // Parameters
+                if (task_node["parameters"]) {
+                    YAML::Node params = task_node["parameters"];
+                    for (YAML::const_iterator it = params.begin(); it != params.end(); ++it) {
+                        task.parameters[it->first.as<std::string>()] = it->second.as<std::string>();
+                    }
+                }
+                
+                // Add task_id to parameters
+                task.parameters["task_id"] = task.task_id;
+                
+                schedule.tasks.push_back(task);
+                
+                // Large (generated) schedules: only the first tasks are listed
+                if (schedule.tasks.size() > MAX_LISTED_TASKS) {
+                    if (schedule.tasks.size() == MAX_LISTED_TASKS + 1) {
+                        std::cout << "[ScheduleParser] ... (further tasks not listed)" << std::endl;
+                    }
+                    continue;
+                }
+                
+                std::cout << "[ScheduleParser] Loaded task: " << task.task_id 
+                          << " (" << mode;
+                if (task.task_addresses.size() > 1) {
+                    std::cout << ", " << task.task_addresses.size() << " replicas";
+                }
+                std::cout << ")" << std::endl;
             }
         }
-        
-        // Set schedule time horizon
-        schedule.time_horizon_start_us = 0;
-        schedule.time_horizon_end_us = 3600000000;  // 1 hour default
-        schedule.tick_duration_us = 1000;  // 1ms
+    }
+    
+    // Set schedule time horizon
+    schedule.time_horizon_start_us = 0;
+    schedule.time_horizon_end_us = 3600000000;  // 1 hour default
+    schedule.tick_duration_us = 1000;  // 1ms
+    
+    return schedule;
+}
+
+} // namespace
+
+TaskSchedule ScheduleParser::parse_yaml(const std::string& yaml_path) {
+    std::cout << "[ScheduleParser] Parsing YAML file: " << yaml_path << std::endl;
+    
+    try {
+        TaskSchedule schedule = parse_schedule(YAML::LoadFile(yaml_path));
         
         std::cout << "[ScheduleParser] Successfully loaded " << schedule.tasks.size() 
                   << " tasks from YAML" << std::endl;
@@ -131,12 +225,38 @@ TaskSchedule ScheduleParser::parse_yaml(const std::string& yaml_path) {
 TaskSchedule ScheduleParser::parse_json(const std::string& json_str) {
     std::cout << "[ScheduleParser] Parsing JSON string" << std::endl;
     
-    // TODO: Implement JSON parsing
-    // For now, return a test schedule
-    std::cerr << "[ScheduleParser] Warning: JSON parsing not fully implemented, "
-              << "using test schedule" << std::endl;
+    // Same document structure as the YAML schedules
+    try {
+        TaskSchedule schedule = parse_schedule(YAML::Load(json_str));
+        
+        std::cout << "[ScheduleParser] Successfully loaded " << schedule.tasks.size() 
+                  << " tasks from JSON" << std::endl;
+        
+        return schedule;
+        
+    } catch (const YAML::Exception& e) {
+        std::cerr << "[ScheduleParser] JSON parsing error: " << e.what() << std::endl;
+        std::cerr << "[ScheduleParser] Falling back to test schedule" << std::endl;
+        return create_test_schedule();
+    }
+}
+
+TaskSchedule ScheduleParser::parse_file(const std::string& path) {
+    const std::string json_extension = ".json";
+    if (path.size() < json_extension.size() ||
+        path.compare(path.size() - json_extension.size(), json_extension.size(), json_extension) != 0) {
+        return parse_yaml(path);
+    }
     
-    return create_test_schedule();
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "[ScheduleParser] Cannot open " << path << ", falling back to test schedule" << std::endl;
+        return create_test_schedule();
+    }
+    std::cout << "[ScheduleParser] Reading JSON file: " << path << std::endl;
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return parse_json(contents.str());
 }
 
 TaskSchedule ScheduleParser::create_test_schedule() {
@@ -203,6 +323,7 @@ TaskSchedule ScheduleParser::create_test_schedule() {
     task3.critical = true;
     task3.execution_mode = TASK_MODE_SEQUENTIAL;  // Sequential
     task3.wait_for_task_id = "task_1";  // Wait for task_1 to complete
+    task3.depends_on.push_back("task_1");
     task3.rt_policy = "none";
     task3.rt_priority = 50;
     task3.cpu_affinity = -1;
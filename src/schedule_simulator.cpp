@@ -0,0 +1,748 @@
+#include "schedule_simulator.h"
+#include "timeline_export.h"
+#include "rt_utils.h"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+namespace orchestrator {
+
+// Same pause as the orchestrator's between two rounds over a task's replicas
+static constexpr int64_t RETRY_BACKOFF_US = 10000;
+
+// Level of SCHED_DEADLINE callbacks (above every RT priority)
+static constexpr int32_t DEADLINE_LEVEL = 100;
+
+// Work below this is done (rates make the remaining work fractional)
+static constexpr double WORK_EPSILON_US = 1e-6;
+
+static constexpr size_t NO_TASK = std::numeric_limits<size_t>::max();
+static constexpr int64_t NEVER = std::numeric_limits<int64_t>::max();
+
+ScheduleSimulator::ScheduleSimulator()
+    : duration_store_(nullptr)
+    , dispatch_order_(DISPATCH_ORDER_PRIORITY)
+    , max_inflight_dispatches_(8)
+    , history_capacity_(ExecutionHistory::DEFAULT_CAPACITY)
+    , duration_model_(DURATION_MODEL_FIXED)
+    , duration_spread_(0.1)
+    , seed_(1)
+    , start_latency_us_(0)
+    , end_latency_us_(0)
+    , critical_path_priority_(true)
+    , now_us_(0)
+    , next_sequence_(0)
+    , idle_workers_(0)
+    , next_sequential_(0)
+    , sequential_launched_(false)
+    , sequential_waiting_(false)
+    , next_arrival_(0) {}
+
+void ScheduleSimulator::load_schedule(const TaskSchedule& schedule) {
+    schedule_ = schedule;
+    schedule_.sort_by_time();
+    
+    // Intern task ids and resolve dependencies exactly like the orchestrator
+    tasks_.clear();
+    schedule_handles_.clear();
+    schedule_handles_.reserve(schedule_.tasks.size());
+    for (const ScheduledTask& task : schedule_.tasks) {
+        TaskHandle handle = tasks_.intern(task.task_id);
+        tasks_.scheduled_time_us[handle] = task.scheduled_time_us;
+        schedule_handles_.push_back(handle);
+    }
+    deadline_us_.assign(tasks_.size(), 0);
+    estimated_us_.assign(tasks_.size(), 0);
+    for (size_t i = 0; i < schedule_.tasks.size(); i++) {
+        const ScheduledTask& task = schedule_.tasks[i];
+        deadline_us_[schedule_handles_[i]] = task.deadline_us;
+        estimated_us_[schedule_handles_[i]] = std::max(estimated_us_[schedule_handles_[i]], task.estimated_duration_us);
+        for (const std::string& dependency : task.dependencies()) {
+            if (tasks_.find(dependency) == INVALID_TASK_HANDLE) {
+                std::cerr << "[Simulator] Warning: task " << task.task_id
+                          << " depends on unknown task " << dependency << std::endl;
+            }
+            tasks_.add_dependency(schedule_handles_[i], tasks_.intern(dependency));
+        }
+    }
+    
+    // Unknown dependencies were interned on the way
+    deadline_us_.resize(tasks_.size(), 0);
+    estimated_us_.resize(tasks_.size(), 0);
+    
+    // Learned execution times win over the declared estimates
+    learned_.assign(tasks_.size(), nullptr);
+    size_t learned = 0;
+    for (TaskHandle handle = 0; duration_store_ && handle < tasks_.size(); handle++) {
+        const TaskDurationStats* stats = duration_store_->find(tasks_.id(handle));
+        if (stats && stats->executions > 0) {
+            learned_[handle] = stats;
+            estimated_us_[handle] = stats->ewma_us;
+            learned++;
+        }
+    }
+    if (duration_store_) {
+        std::cout << "[Simulator] Learned execution times for " << learned << "/" << tasks_.size()
+                  << " tasks" << std::endl;
+    }
+    
+    // One wrapper per distinct address
+    addresses_.clear();
+    task_endpoints_.clear();
+    task_endpoints_.reserve(schedule_.tasks.size());
+    std::map<std::string, EndpointId> index;
+    auto add_endpoint = [this, &index](const std::string& address) {
+        auto it = index.find(address);
+        if (it != index.end()) {
+            return it->second;
+        }
+        EndpointId id = static_cast<EndpointId>(addresses_.size());
+        addresses_.push_back(address);
+        index[address] = id;
+        return id;
+    };
+    for (const ScheduledTask& task : schedule_.tasks) {
+        std::vector<EndpointId> replicas;
+        if (task.task_addresses.empty()) {
+            replicas.push_back(add_endpoint(task.task_address));
+        }
+        for (const std::string& address : task.task_addresses) {
+            replicas.push_back(add_endpoint(address));
+        }
+        if (replicas.size() > MAX_TASK_REPLICAS) {
+            replicas.resize(MAX_TASK_REPLICAS);
+        }
+        task_endpoints_.push_back(std::move(replicas));
+    }
+    
+    std::cout << "[Simulator] Loaded schedule with " << schedule_.tasks.size() << " tasks on "
+              << addresses_.size() << " wrappers" << std::endl;
+}
+
+void ScheduleSimulator::set_dispatch_order(DispatchOrder order) {
+    dispatch_order_ = order;
+}
+
+void ScheduleSimulator::set_max_inflight_dispatches(size_t max_inflight) {
+    max_inflight_dispatches_ = std::max<size_t>(max_inflight, 1);
+}
+
+void ScheduleSimulator::set_history_capacity(size_t capacity) {
+    history_capacity_ = capacity;
+}
+
+void ScheduleSimulator::set_trace_file(const std::string& path) {
+    trace_path_ = path;
+}
+
+void ScheduleSimulator::set_duration_model(DurationModel model, double spread) {
+    duration_model_ = model;
+    duration_spread_ = std::max(spread, 0.0);
+}
+
+void ScheduleSimulator::set_rpc_latency(int64_t start_latency_us, int64_t end_latency_us) {
+    start_latency_us_ = std::max<int64_t>(start_latency_us, 0);
+    end_latency_us_ = std::max<int64_t>(end_latency_us, 0);
+}
+
+bool ScheduleSimulator::run() {
+    auto wall_start = std::chrono::steady_clock::now();
+    
+    // Fresh runtime state (the schedule can be simulated again with another seed)
+    tasks_.reset_runtime();
+    history_.reset(history_capacity_);
+    report_ = SimulationReport();
+    critical_path_.build(tasks_, estimated_us_);
+    in_flight_.assign(addresses_.size(), 0);
+    wrapper_task_.assign(addresses_.size(), NO_TASK);
+    dispatches_.assign(schedule_.tasks.size(), Dispatch());
+    lateness_.clear();
+    lateness_.reserve(schedule_.tasks.size());
+    cores_.clear();
+    cores_.push_back({-1, {}});
+    events_ = decltype(events_)();
+    release_queue_.clear();
+    release_queue_.set_order(dispatch_order_);
+    release_queue_.reserve(schedule_.tasks.size());
+    idle_workers_ = max_inflight_dispatches_;
+    rng_.seed(seed_);
+    now_us_ = 0;
+    next_sequence_ = 0;
+    next_arrival_ = 0;
+    next_sequential_ = 0;
+    sequential_launched_ = false;
+    sequential_waiting_ = false;
+    
+    if (!trace_path_.empty()) {
+        int64_t start_system_time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        if (!trace_.open(trace_path_, tasks_, start_system_time_us)) {
+            std::cerr << "[Simulator] Failed to open trace file " << trace_path_ << std::endl;
+            return false;
+        }
+    }
+    
+    std::cout << "[Simulator] Simulating (dispatch order: " << ReleaseQueue::order_to_string(dispatch_order_)
+              << ", max in-flight dispatches: " << max_inflight_dispatches_
+              << ", durations: " << duration_model_to_string(duration_model_) << ")" << std::endl;
+    std::vector<TaskHandle> path = critical_path_.path();
+    if (path.size() > 1) {
+        std::cout << "[Simulator] Estimated critical path: " << critical_path_.length_us() / 1000.0
+                  << " ms through " << path.size() << " tasks (" << tasks_.id(path.front())
+                  << " → " << tasks_.id(path.back()) << ")" << std::endl;
+    }
+    
+    // PHASE 1: TIMED tasks are released at their scheduled time
+    for (size_t i = 0; i < schedule_.tasks.size(); i++) {
+        if (schedule_.tasks[i].execution_mode == TASK_MODE_TIMED) {
+            schedule_event(schedule_.tasks[i].scheduled_time_us, EVENT_RELEASE, i);
+        }
+    }
+    
+    // PHASE 2: SEQUENTIAL tasks one at a time
+    advance_sequential();
+    dispatch_released();
+    
+    // Callback ends come before events due at the same instant, so a wrapper
+    // freed at t accepts a start arriving at t
+    while (true) {
+        int64_t callback_end = next_callback_end();
+        int64_t event_time = events_.empty() ? NEVER : events_.top().time_us;
+        if (callback_end == NEVER && event_time == NEVER) {
+            break;
+        }
+        
+        if (callback_end <= event_time) {
+            advance_clock(callback_end);
+            finish_callbacks();
+        } else {
+            advance_clock(event_time);
+            while (!events_.empty() && events_.top().time_us == now_us_) {
+                Event event = events_.top();
+                events_.pop();
+                handle_event(event);
+            }
+        }
+        dispatch_released();
+    }
+    
+    if (trace_.is_open()) {
+        std::cout << "[Simulator] Trace file closed (" << trace_.record_count()
+                  << " records)" << std::endl;
+        trace_.close();
+    }
+    
+    build_report();
+    
+    double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_start).count();
+    std::cout << "[Simulator] Simulated " << report_.makespan_us / 1000.0 << " ms of schedule in "
+              << wall_ms << " ms (" << report_.executions << " executions)" << std::endl;
+    
+    if (!report_.stalled_tasks.empty()) {
+        std::cerr << "[Simulator] Warning: " << report_.stalled_tasks.size()
+                  << " SEQUENTIAL tasks wait for dependencies that never complete, starting with "
+                  << report_.stalled_tasks.front() << " (a live run would not finish)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ScheduleSimulator::schedule_event(int64_t time_us, EventType type, size_t task_index) {
+    events_.push({time_us, next_sequence_++, type, task_index});
+}
+
+void ScheduleSimulator::handle_event(const Event& event) {
+    size_t i = event.task_index;
+    TaskHandle handle = schedule_handles_[i];
+    
+    switch (event.type) {
+        case EVENT_RELEASE:
+            release_task(i, schedule_.tasks[i].scheduled_time_us);
+            break;
+        
+        case EVENT_START_ARRIVED: {
+            // The wrapper runs one task at a time and rejects starts while busy
+            EndpointId endpoint = tasks_.endpoint[handle];
+            if (wrapper_task_[endpoint] != NO_TASK) {
+                dispatches_[i].rejected = true;
+                dispatches_[i].message = "Task is not in IDLE state";
+                break;
+            }
+            wrapper_task_[endpoint] = i;
+            TaskTimeline& timeline = tasks_.timeline[handle];
+            timeline.wrapper_start_us = now_us_;
+            timeline.callback_start_us = now_us_;
+            tasks_.actual_start_time_us[handle] = now_us_;
+            begin_callback(i);
+            break;
+        }
+        
+        case EVENT_START_ACKED: {
+            if (dispatches_[i].rejected) {
+                // Fail over to the next replica, or wait for the next round
+                in_flight_[tasks_.endpoint[handle]]--;
+                if (task_endpoints_[i].size() > 1) {
+                    std::cout << "[Simulator] Replica " << addresses_[tasks_.endpoint[handle]] << " did not start "
+                              << schedule_.tasks[i].task_id << " (" << dispatches_[i].message
+                              << "), failing over" << std::endl;
+                }
+                try_start(i);
+                break;
+            }
+            tasks_.timeline[handle].dispatch_done_us = now_us_;
+            if (tasks_.state[handle] == TASK_STATE_STARTING) {
+                tasks_.state[handle] = TASK_STATE_RUNNING;
+            }
+            idle_workers_++;
+            break;
+        }
+        
+        case EVENT_RETRY:
+            try_start(i);
+            break;
+        
+        case EVENT_END_NOTIFIED:
+            end_task(i);
+            break;
+    }
+}
+
+void ScheduleSimulator::release_task(size_t task_index, int64_t release_time_us) {
+    const ScheduledTask& task = schedule_.tasks[task_index];
+    
+    ReleasedTask released;
+    released.task_index = task_index;
+    released.release_time_us = release_time_us;
+    released.absolute_deadline_us = release_time_us + task.deadline_us;
+    released.priority = task.priority;
+    released.bottom_level_us = critical_path_priority_ ? critical_path_.bottom_level(schedule_handles_[task_index]) : 0;
+    released.sequence = 0;
+    release_queue_.push(released);
+    
+    TaskTimeline& timeline = tasks_.timeline[schedule_handles_[task_index]];
+    timeline.release_us = now_us_;
+    if (task.execution_mode == TASK_MODE_TIMED || task.wait_for_task_id.empty()) {
+        timeline.wait_start_us = timeline.release_us;
+    }
+}
+
+void ScheduleSimulator::advance_sequential() {
+    while (next_sequential_ < schedule_.tasks.size()) {
+        const ScheduledTask& task = schedule_.tasks[next_sequential_];
+        TaskHandle handle = schedule_handles_[next_sequential_];
+        if (task.execution_mode != TASK_MODE_SEQUENTIAL) {
+            next_sequential_++;
+            continue;
+        }
+        
+        // Launched: the next entry waits for this one to end
+        if (sequential_launched_) {
+            if (tasks_.is_active(handle)) {
+                return;
+            }
+            sequential_launched_ = false;
+            sequential_waiting_ = false;
+            next_sequential_++;
+            continue;
+        }
+        
+        // Wait for the dependencies
+        if (!task.wait_for_task_id.empty()) {
+            if (!sequential_waiting_) {
+                sequential_waiting_ = true;
+                tasks_.timeline[handle].wait_start_us = now_us_;
+            }
+            if (!tasks_.dependencies_satisfied(handle)) {
+                return;
+            }
+        }
+        
+        tasks_.mark_started(handle, now_us_);
+        release_task(next_sequential_, now_us_);
+        sequential_launched_ = true;
+        return;
+    }
+}
+
+void ScheduleSimulator::dispatch_released() {
+    while (idle_workers_ > 0 && !release_queue_.empty()) {
+        size_t i = release_queue_.pop().task_index;
+        TaskHandle handle = schedule_handles_[i];
+        idle_workers_--;
+        
+        tasks_.mark_started(handle, now_us_);
+        TaskTimeline& timeline = tasks_.timeline[handle];
+        timeline.dispatch_us = now_us_;
+        timeline.dispatch_done_us = 0;
+        timeline.wrapper_start_us = 0;
+        timeline.callback_start_us = 0;
+        timeline.callback_end_us = 0;
+        timeline.notify_received_us = 0;
+        timeline.cpu_core = -1;
+        
+        Dispatch& dispatch = dispatches_[i];
+        dispatch.tried_mask = 0;
+        dispatch.retries_left = schedule_.tasks[i].max_retries;
+        dispatch.rejected = false;
+        dispatch.message.clear();
+        try_start(i);
+    }
+}
+
+void ScheduleSimulator::try_start(size_t task_index) {
+    Dispatch& dispatch = dispatches_[task_index];
+    const std::vector<EndpointId>& replicas = task_endpoints_[task_index];
+    
+    // Least-loaded replica not tried in this round (every start costs the same here)
+    size_t best = replicas.size();
+    for (size_t r = 0; r < replicas.size(); r++) {
+        if (dispatch.tried_mask & (uint64_t(1) << r)) {
+            continue;
+        }
+        if (best == replicas.size() || in_flight_[replicas[r]] < in_flight_[replicas[best]]) {
+            best = r;
+        }
+    }
+    
+    // Every replica refused: a new round consumes one retry
+    if (best == replicas.size()) {
+        if (dispatch.retries_left-- <= 0) {
+            fail_start(task_index, dispatch.message);
+            return;
+        }
+        dispatch.tried_mask = 0;
+        schedule_event(now_us_ + RETRY_BACKOFF_US, EVENT_RETRY, task_index);
+        return;
+    }
+    
+    dispatch.tried_mask |= uint64_t(1) << best;
+    dispatch.rejected = false;
+    EndpointId endpoint = replicas[best];
+    tasks_.endpoint[schedule_handles_[task_index]] = endpoint;
+    in_flight_[endpoint]++;
+    
+    // The wrapper sees the start half-way through the round trip
+    schedule_event(now_us_ + start_latency_us_ / 2, EVENT_START_ARRIVED, task_index);
+    schedule_event(now_us_ + start_latency_us_, EVENT_START_ACKED, task_index);
+}
+
+void ScheduleSimulator::fail_start(size_t task_index, const std::string& message) {
+    TaskHandle handle = schedule_handles_[task_index];
+    std::cerr << "[Simulator] Failed to start task " << schedule_.tasks[task_index].task_id
+              << ": " << message << std::endl;
+    
+    tasks_.actual_start_time_us[handle] = now_us_;
+    tasks_.timeline[handle].dispatch_done_us = now_us_;
+    tasks_.mark_completed(handle, TASK_STATE_FAILED, TASK_RESULT_FAILURE, now_us_);
+    tasks_.error_message[handle] = message;
+    record_execution(handle);
+    
+    idle_workers_++;
+    advance_sequential();
+}
+
+void ScheduleSimulator::end_task(size_t task_index) {
+    TaskHandle handle = schedule_handles_[task_index];
+    in_flight_[tasks_.endpoint[handle]]--;
+    
+    TaskTimeline& timeline = tasks_.timeline[handle];
+    timeline.notify_received_us = now_us_;
+    
+    // Bottom levels of the tasks still to run follow the drawn duration
+    if (critical_path_priority_) {
+        critical_path_.update_duration(handle, timeline.callback_end_us - timeline.callback_start_us);
+    }
+    
+    // Mark task as completed (also releases dependents)
+    tasks_.mark_completed(handle, TASK_STATE_COMPLETED, TASK_RESULT_SUCCESS, timeline.callback_end_us);
+    tasks_.error_message[handle].clear();
+    record_execution(handle);
+    
+    advance_sequential();
+}
+
+void ScheduleSimulator::begin_callback(size_t task_index) {
+    const ScheduledTask& task = schedule_.tasks[task_index];
+    size_t core_index = core_for(task_index);
+    Core& core = cores_[core_index];
+    
+    Execution execution;
+    execution.task_index = task_index;
+    execution.remaining_us = static_cast<double>(draw_duration(task_index));
+    execution.rate = 0;
+    execution.bandwidth = task.cpu_bandwidth;
+    execution.arrival = next_arrival_++;
+    
+    RTSchedulingPolicy policy = RTUtils::string_to_policy(task.rt_policy);
+    execution.level = policy == RT_POLICY_DEADLINE ? DEADLINE_LEVEL :
+                      policy == RT_POLICY_FIFO || policy == RT_POLICY_RR ? task.rt_priority : 0;
+    execution.fifo = policy == RT_POLICY_DEADLINE || policy == RT_POLICY_FIFO;
+    
+    core.executions.push_back(execution);
+    tasks_.timeline[schedule_handles_[task_index]].cpu_core = core.cpu;
+    share_core(core);
+}
+
+size_t ScheduleSimulator::core_for(size_t task_index) {
+    const ScheduledTask& task = schedule_.tasks[task_index];
+    
+    // Candidate CPUs: the list, the single core, or none (unbound)
+    std::vector<int32_t> cpus;
+    cpu_set_t set;
+    if (!task.cpu_list.empty() && RTUtils::parse_cpu_list(task.cpu_list, set)) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    } else if (task.cpu_affinity >= 0) {
+        cpus.push_back(task.cpu_affinity);
+    }
+    if (cpus.empty()) {
+        return 0;
+    }
+    
+    // The least-loaded CPU of the set (the kernel would balance the thread there)
+    size_t best = NO_TASK;
+    for (int32_t cpu : cpus) {
+        auto it = std::find_if(cores_.begin(), cores_.end(), [cpu](const Core& core) { return core.cpu == cpu; });
+        size_t index = static_cast<size_t>(it - cores_.begin());
+        if (it == cores_.end()) {
+            cores_.push_back({cpu, {}});
+        }
+        if (best == NO_TASK || cores_[index].executions.size() < cores_[best].executions.size()) {
+            best = index;
+        }
+    }
+    return best;
+}
+
+void ScheduleSimulator::share_core(Core& core) {
+    if (core.executions.empty()) {
+        return;
+    }
+    
+    // Unbound callbacks each have a CPU of their own
+    if (core.cpu < 0) {
+        for (Execution& execution : core.executions) {
+            execution.rate = execution.bandwidth > 0 ? std::min(execution.bandwidth, 1.0) : 1.0;
+        }
+        return;
+    }
+    
+    // Only the highest level runs: its oldest FIFO callback alone, otherwise
+    // all its callbacks share the CPU evenly
+    int32_t top = std::max_element(core.executions.begin(), core.executions.end(),
+        [](const Execution& a, const Execution& b) { return a.level < b.level; })->level;
+    const Execution* fifo = nullptr;
+    size_t sharing = 0;
+    for (const Execution& execution : core.executions) {
+        if (execution.level != top) {
+            continue;
+        }
+        sharing++;
+        if (execution.fifo && (!fifo || execution.arrival < fifo->arrival)) {
+            fifo = &execution;
+        }
+    }
+    
+    for (Execution& execution : core.executions) {
+        double share = 0;
+        if (fifo) {
+            share = &execution == fifo ? 1.0 : 0.0;
+        } else if (execution.level == top) {
+            share = 1.0 / sharing;
+        }
+        execution.rate = execution.bandwidth > 0 ? std::min(execution.bandwidth, share) : share;
+    }
+}
+
+void ScheduleSimulator::advance_clock(int64_t time_us) {
+    double elapsed = static_cast<double>(time_us - now_us_);
+    for (Core& core : cores_) {
+        for (Execution& execution : core.executions) {
+            execution.remaining_us -= execution.rate * elapsed;
+        }
+    }
+    now_us_ = time_us;
+}
+
+int64_t ScheduleSimulator::next_callback_end() const {
+    int64_t next = NEVER;
+    for (const Core& core : cores_) {
+        for (const Execution& execution : core.executions) {
+            if (execution.remaining_us <= WORK_EPSILON_US) {
+                return now_us_;
+            }
+            if (execution.rate > 0) {
+                int64_t end = now_us_ + static_cast<int64_t>(std::ceil(execution.remaining_us / execution.rate - WORK_EPSILON_US));
+                next = std::min(next, end);
+            }
+        }
+    }
+    return next;
+}
+
+void ScheduleSimulator::finish_callbacks() {
+    for (Core& core : cores_) {
+        bool changed = false;
+        for (size_t k = 0; k < core.executions.size();) {
+            if (core.executions[k].remaining_us > WORK_EPSILON_US) {
+                k++;
+                continue;
+            }
+            
+            // The wrapper is idle again before it notifies the orchestrator
+            size_t i = core.executions[k].task_index;
+            TaskHandle handle = schedule_handles_[i];
+            tasks_.timeline[handle].callback_end_us = now_us_;
+            wrapper_task_[tasks_.endpoint[handle]] = NO_TASK;
+            schedule_event(now_us_ + end_latency_us_, EVENT_END_NOTIFIED, i);
+            
+            core.executions.erase(core.executions.begin() + k);
+            changed = true;
+        }
+        if (changed) {
+            share_core(core);
+        }
+    }
+}
+
+int64_t ScheduleSimulator::draw_duration(size_t task_index) {
+    TaskHandle handle = schedule_handles_[task_index];
+    const TaskDurationStats* stats = learned_[handle];
+    if (duration_model_ == DURATION_MODEL_LEARNED && stats && !stats->recent_us.empty()) {
+        std::uniform_int_distribution<size_t> pick(0, stats->recent_us.size() - 1);
+        return stats->recent_us[pick(rng_)];
+    }
+    
+    double estimate = static_cast<double>(std::max<int64_t>(estimated_us_[handle], 0));
+    double duration = estimate;
+    switch (duration_model_) {
+        case DURATION_MODEL_FIXED:
+        case DURATION_MODEL_LEARNED:
+            break;
+        case DURATION_MODEL_UNIFORM: {
+            std::uniform_real_distribution<double> uniform(1.0 - duration_spread_, 1.0 + duration_spread_);
+            duration = estimate * uniform(rng_);
+            break;
+        }
+        case DURATION_MODEL_NORMAL: {
+            std::normal_distribution<double> normal(estimate, estimate * duration_spread_);
+            duration = normal(rng_);
+            break;
+        }
+    }
+    return std::max<int64_t>(static_cast<int64_t>(std::llround(duration)), 0);
+}
+
+void ScheduleSimulator::record_execution(TaskHandle handle) {
+    ExecutionRecord rec = tasks_.record(handle);
+    history_.push(rec);
+    trace_.append(rec);
+    
+    // The report covers every execution, not only those the history retains
+    report_.makespan_us = std::max(report_.makespan_us, rec.end_time_us);
+    if (rec.state != TASK_STATE_COMPLETED) {
+        report_.failed++;
+        return;
+    }
+    report_.completed++;
+    lateness_.push_back(rec.actual_start_time_us - rec.timeline.release_us);
+    
+    // Same absolute deadline as the EDF dispatch order
+    int64_t deadline_us = deadline_us_[handle];
+    if (deadline_us > 0 && rec.end_time_us > rec.timeline.release_us + deadline_us) {
+        report_.deadline_misses++;
+        report_.missed_tasks.push_back(tasks_.id(handle));
+    }
+}
+
+void ScheduleSimulator::build_report() {
+    report_.executions = history_.total();
+    if (!lateness_.empty()) {
+        std::sort(lateness_.begin(), lateness_.end());
+        int64_t sum = 0;
+        for (int64_t late : lateness_) {
+            sum += late;
+        }
+        report_.lateness_mean_us = sum / static_cast<int64_t>(lateness_.size());
+        report_.lateness_p50_us = lateness_[(lateness_.size() - 1) / 2];
+        report_.lateness_p99_us = lateness_[(lateness_.size() - 1) * 99 / 100];
+        report_.lateness_max_us = lateness_.back();
+    }
+    
+    // SEQUENTIAL entries the phase never got past
+    for (size_t i = next_sequential_; i < schedule_.tasks.size(); i++) {
+        if (schedule_.tasks[i].execution_mode == TASK_MODE_SEQUENTIAL) {
+            report_.stalled_tasks.push_back(schedule_.tasks[i].task_id);
+        }
+    }
+}
+
+std::vector<TaskExecution> ScheduleSimulator::get_execution_history() const {
+    std::vector<ExecutionRecord> records;
+    history_.snapshot(records);
+    
+    std::vector<TaskExecution> history;
+    history.reserve(records.size());
+    for (const ExecutionRecord& rec : records) {
+        TaskExecution exec;
+        exec.task_id = tasks_.id(rec.handle);
+        exec.scheduled_time_us = rec.scheduled_time_us;
+        exec.actual_start_time_us = rec.actual_start_time_us;
+        exec.end_time_us = rec.end_time_us;
+        exec.state = rec.state;
+        exec.result = rec.result;
+        exec.task_address = rec.endpoint < addresses_.size() ? addresses_[rec.endpoint] : "";
+        if (rec.result != TASK_RESULT_SUCCESS) {
+            exec.error_message = tasks_.error_message[rec.handle];
+        }
+        exec.timeline = rec.timeline;
+        history.push_back(std::move(exec));
+    }
+    return history;
+}
+
+std::vector<TimelineDependency> ScheduleSimulator::schedule_dependencies() const {
+    std::vector<TimelineDependency> dependencies;
+    for (const ScheduledTask& task : schedule_.tasks) {
+        for (const std::string& dependency : task.dependencies()) {
+            dependencies.push_back({task.task_id, dependency});
+        }
+    }
+    return dependencies;
+}
+
+bool ScheduleSimulator::export_timeline(const std::string& path) const {
+    if (!TimelineExporter::write_chrome_trace(path, get_execution_history(), schedule_dependencies())) {
+        return false;
+    }
+    std::cout << "[Simulator] Timeline written to " << path << std::endl;
+    return true;
+}
+
+std::vector<CriticalPathStep> ScheduleSimulator::get_critical_path() const {
+    return CriticalPath::from_history(get_execution_history(), schedule_dependencies());
+}
+
+DurationModel ScheduleSimulator::string_to_duration_model(const std::string& name) {
+    if (name == "uniform") return DURATION_MODEL_UNIFORM;
+    if (name == "normal") return DURATION_MODEL_NORMAL;
+    if (name == "learned") return DURATION_MODEL_LEARNED;
+    return DURATION_MODEL_FIXED;
+}
+
+std::string ScheduleSimulator::duration_model_to_string(DurationModel model) {
+    switch (model) {
+        case DURATION_MODEL_UNIFORM: return "uniform";
+        case DURATION_MODEL_NORMAL: return "normal";
+        case DURATION_MODEL_LEARNED: return "learned";
+        default: return "fixed";
+    }
+}
+
+} // namespace orchestrator
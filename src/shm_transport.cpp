@@ -0,0 +1,493 @@
+#include "shm_transport.h"
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace orchestrator {
+
+namespace {
+
+constexpr uint32_t SHM_MAGIC = 0x4f524348;  // "ORCH"
+constexpr uint32_t SHM_VERSION = 2;
+
+// Reader threads wake up this often to notice disconnect()
+constexpr int64_t READER_POLL_US = 100000;
+
+int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Spinning only pays off when the peer runs on another CPU: on a single CPU
+// it just delays the peer, so go straight to the futex
+int64_t spin_budget_us() {
+    static const int64_t budget = std::thread::hardware_concurrency() > 1 ? ShmChannel::DEFAULT_SPIN_US : 0;
+    return budget;
+}
+
+// Shared futexes (no FUTEX_PRIVATE_FLAG): the rings are used across processes
+void futex_wait(std::atomic<uint32_t>* word, uint32_t expected, int64_t timeout_us) {
+    struct timespec timeout;
+    timeout.tv_sec = timeout_us / 1000000;
+    timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futex_wake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+// Private futex for the reply hand-off inside the orchestrator process
+void futex_wait_private(std::atomic<uint32_t>* word, uint32_t expected, int64_t timeout_us) {
+    struct timespec timeout;
+    timeout.tv_sec = timeout_us / 1000000;
+    timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE, expected, &timeout, nullptr, 0);
+}
+
+void futex_wake_private(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace
+
+// ============================================================================
+// ShmChannel Implementation
+// ============================================================================
+
+ShmChannel::ShmChannel()
+    : segment_(nullptr)
+    , tx_(nullptr)
+    , rx_(nullptr)
+    , owner_(false) {}
+
+ShmChannel::~ShmChannel() {
+    close();
+}
+
+std::string ShmChannel::segment_path(const std::string& name) {
+    return "/orchestrator_" + name;
+}
+
+bool ShmChannel::create(const std::string& name) {
+    close();
+    std::string path = segment_path(name);
+    
+    // A segment left behind by a crashed wrapper is replaced
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        std::cerr << "[Shm] Failed to create /dev/shm" << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, sizeof(ShmSegment)) != 0) {
+        std::cerr << "[Shm] Failed to size /dev/shm" << path << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    
+    owner_ = true;
+    name_ = name;
+    if (!map(fd, true)) {
+        shm_unlink(path.c_str());
+        owner_ = false;
+        return false;
+    }
+    
+    // The wrapper receives on to_wrapper and sends on to_orchestrator
+    rx_ = &segment_->to_wrapper;
+    tx_ = &segment_->to_orchestrator;
+    return true;
+}
+
+bool ShmChannel::open(const std::string& name) {
+    close();
+    std::string path = segment_path(name);
+    
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        std::cerr << "[Shm] Failed to open /dev/shm" << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmSegment)) {
+        std::cerr << "[Shm] /dev/shm" << path << " is not a channel segment" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    
+    owner_ = false;
+    name_ = name;
+    if (!map(fd, false)) {
+        return false;
+    }
+    if (segment_->magic != SHM_MAGIC || segment_->version != SHM_VERSION) {
+        std::cerr << "[Shm] /dev/shm" << path << " has an unknown layout" << std::endl;
+        close();
+        return false;
+    }
+    
+    rx_ = &segment_->to_orchestrator;
+    tx_ = &segment_->to_wrapper;
+    return true;
+}
+
+bool ShmChannel::map(int fd, bool initialize) {
+    void* addr = mmap(nullptr, sizeof(ShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[Shm] Failed to map " << segment_path(name_) << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    segment_ = static_cast<ShmSegment*>(addr);
+    
+    if (initialize) {
+        // Zeroing touches every page, so the first messages do not page-fault
+        memset(static_cast<void*>(segment_), 0, sizeof(ShmSegment));
+        segment_->version = SHM_VERSION;
+        std::atomic_thread_fence(std::memory_order_release);
+        segment_->magic = SHM_MAGIC;
+    }
+    return true;
+}
+
+void ShmChannel::close() {
+    if (!segment_) {
+        return;
+    }
+    munmap(segment_, sizeof(ShmSegment));
+    if (owner_) {
+        shm_unlink(segment_path(name_).c_str());
+    }
+    segment_ = nullptr;
+    tx_ = nullptr;
+    rx_ = nullptr;
+    owner_ = false;
+}
+
+bool ShmChannel::send(ShmMessageType type, const google::protobuf::MessageLite& message, uint32_t sequence) {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    if (!tx_) {
+        return false;
+    }
+    
+    size_t length = message.ByteSizeLong();
+    if (length > sizeof(ShmRing::Slot::data)) {
+        std::cerr << "[Shm] Message of " << length << " bytes does not fit in a slot" << std::endl;
+        return false;
+    }
+    
+    // Full ring: the consumer is stalled; give it up to a second
+    uint32_t head = tx_->head.load(std::memory_order_relaxed);
+    int64_t give_up_us = 0;
+    while (head - tx_->tail.load(std::memory_order_acquire) >= SHM_RING_SLOTS) {
+        int64_t now = now_us();
+        if (give_up_us == 0) {
+            give_up_us = now + 1000000;
+        } else if (now > give_up_us) {
+            std::cerr << "[Shm] Channel " << name_ << " is full" << std::endl;
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    
+    ShmRing::Slot& slot = tx_->slots[head % SHM_RING_SLOTS];
+    slot.type = type;
+    slot.length = static_cast<uint32_t>(length);
+    slot.sequence = sequence;
+    message.SerializeWithCachedSizesToArray(slot.data);
+    
+    // Publish, then wake the consumer if it went to sleep (seq_cst pairs with
+    // the consumer's sleeping store / head load)
+    tx_->head.store(head + 1, std::memory_order_seq_cst);
+    if (tx_->sleeping.load(std::memory_order_seq_cst)) {
+        futex_wake(&tx_->head);
+    }
+    return true;
+}
+
+bool ShmChannel::receive(ShmMessageType& type, uint32_t& sequence, const void*& data, uint32_t& length,
+                         int64_t timeout_us) {
+    if (!rx_) {
+        return false;
+    }
+    
+    uint32_t tail = rx_->tail.load(std::memory_order_relaxed);
+    int64_t start_us = now_us();
+    int64_t spin_until = start_us + std::min(spin_budget_us(), timeout_us);
+    int64_t deadline = start_us + timeout_us;
+    
+    uint32_t head;
+    while ((head = rx_->head.load(std::memory_order_acquire)) == tail) {
+        int64_t now = now_us();
+        if (now >= deadline) {
+            return false;
+        }
+        if (now < spin_until) {
+            continue;
+        }
+        
+        rx_->sleeping.store(1, std::memory_order_seq_cst);
+        if (rx_->head.load(std::memory_order_seq_cst) == tail) {
+            futex_wait(&rx_->head, tail, deadline - now);
+        }
+        rx_->sleeping.store(0, std::memory_order_relaxed);
+    }
+    
+    const ShmRing::Slot& slot = rx_->slots[tail % SHM_RING_SLOTS];
+    type = static_cast<ShmMessageType>(slot.type);
+    sequence = slot.sequence;
+    data = slot.data;
+    length = slot.length;
+    return true;
+}
+
+void ShmChannel::consume() {
+    if (rx_) {
+        rx_->tail.store(rx_->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+}
+
+void ShmChannel::discard_pending() {
+    if (rx_) {
+        rx_->tail.store(rx_->head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+}
+
+// ============================================================================
+// ShmOutputBuffer Implementation
+// ============================================================================
+
+ShmOutputBuffer::ShmOutputBuffer()
+    : data_(nullptr)
+    , size_(0) {}
+
+ShmOutputBuffer::~ShmOutputBuffer() {
+    close();
+}
+
+ShmOutputBuffer::ShmOutputBuffer(ShmOutputBuffer&& other) noexcept
+    : data_(other.data_)
+    , size_(other.size_)
+    , name_(std::move(other.name_)) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+ShmOutputBuffer& ShmOutputBuffer::operator=(ShmOutputBuffer&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = other.data_;
+        size_ = other.size_;
+        name_ = std::move(other.name_);
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+bool ShmOutputBuffer::create(const std::string& name, size_t size) {
+    close();
+    std::string path = ShmChannel::segment_path(name);
+    
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        std::cerr << "[Shm] Failed to create /dev/shm" << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "[Shm] Failed to size /dev/shm" << path << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    
+    name_ = name;
+    if (!map(fd, size, PROT_READ | PROT_WRITE)) {
+        shm_unlink(path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ShmOutputBuffer::open(const std::string& name, size_t size) {
+    close();
+    std::string path = ShmChannel::segment_path(name);
+    
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "[Shm] Failed to open /dev/shm" << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    // The segment must hold what the producer announced
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < size) {
+        std::cerr << "[Shm] Output /dev/shm" << path << " is smaller than " << size << " bytes" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    
+    name_ = name;
+    return map(fd, size, PROT_READ);
+}
+
+bool ShmOutputBuffer::map(int fd, size_t size, int protection) {
+    // mmap rejects empty mappings (empty outputs always travel inline)
+    void* addr = size > 0 ? mmap(nullptr, size, protection, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[Shm] Failed to map " << ShmChannel::segment_path(name_) << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    data_ = addr;
+    size_ = size;
+    return true;
+}
+
+void ShmOutputBuffer::close() {
+    if (!data_) {
+        return;
+    }
+    munmap(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void ShmOutputBuffer::unlink(const std::string& name) {
+    shm_unlink(ShmChannel::segment_path(name).c_str());
+}
+
+// ============================================================================
+// ShmClient Implementation
+// ============================================================================
+
+ShmClient::ShmClient(EndHandler on_end)
+    : on_end_(on_end)
+    , running_(false)
+    , call_seq_(0)
+    , awaited_seq_(0)
+    , reply_seq_(0)
+    , reply_type_(SHM_MSG_START_RESPONSE) {}
+
+ShmClient::~ShmClient() {
+    disconnect();
+}
+
+bool ShmClient::connect(const std::string& name) {
+    disconnect();
+    if (!channel_.open(name)) {
+        return false;
+    }
+    
+    // Messages of a previous orchestrator run are not ours
+    channel_.discard_pending();
+    
+    running_ = true;
+    reader_ = std::thread(&ShmClient::reader_loop, this);
+    return true;
+}
+
+void ShmClient::disconnect() {
+    if (running_.exchange(false) && reader_.joinable()) {
+        reader_.join();
+    }
+    channel_.close();
+}
+
+grpc::Status ShmClient::start_task(const StartTaskRequest& request, StartTaskResponse* response,
+                                   int64_t timeout_us) {
+    return call(SHM_MSG_START, request, SHM_MSG_START_RESPONSE, response, timeout_us);
+}
+
+grpc::Status ShmClient::call(ShmMessageType type, const google::protobuf::MessageLite& request,
+                             ShmMessageType reply_type, google::protobuf::MessageLite* reply,
+                             int64_t timeout_us) {
+    std::lock_guard<std::mutex> lock(call_mutex_);
+    if (!running_) {
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE, "Shared memory channel closed");
+    }
+    
+    // 0 is never a call
+    uint32_t seq = ++call_seq_;
+    if (seq == 0) {
+        seq = ++call_seq_;
+    }
+    awaited_seq_.store(seq, std::memory_order_release);
+    if (!channel_.send(type, request, seq)) {
+        awaited_seq_.store(0, std::memory_order_release);
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE, "Shared memory send failed");
+    }
+    
+    // Spin first: the wrapper usually answers within microseconds
+    int64_t start_us = now_us();
+    int64_t spin_until = start_us + spin_budget_us();
+    int64_t deadline = start_us + timeout_us;
+    uint32_t replied;
+    while ((replied = reply_seq_.load(std::memory_order_acquire)) != seq) {
+        int64_t now = now_us();
+        if (now >= deadline) {
+            awaited_seq_.store(0, std::memory_order_release);
+            return grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED, "Shared memory call timed out");
+        }
+        if (now >= spin_until) {
+            futex_wait_private(&reply_seq_, replied, deadline - now);
+        }
+    }
+    awaited_seq_.store(0, std::memory_order_release);
+    
+    if (reply_type_ != reply_type || !reply->ParseFromString(reply_payload_)) {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Unexpected shared memory reply");
+    }
+    return grpc::Status::OK;
+}
+
+void ShmClient::reader_loop() {
+    TaskEndNotification notification;
+    
+    while (running_) {
+        ShmMessageType type;
+        uint32_t sequence;
+        const void* data;
+        uint32_t length;
+        if (!channel_.receive(type, sequence, data, length, READER_POLL_US)) {
+            continue;
+        }
+        
+        if (type == SHM_MSG_TASK_END) {
+            bool parsed = notification.ParseFromArray(data, static_cast<int>(length));
+            channel_.consume();
+            if (parsed) {
+                on_end_(notification);
+            }
+        } else if (type == SHM_MSG_START_RESPONSE || type == SHM_MSG_STOP_RESPONSE) {
+            // The reply of a call that already timed out answers nobody
+            if (sequence == 0 || sequence != awaited_seq_.load(std::memory_order_acquire)) {
+                channel_.consume();
+                std::cerr << "[Shm] Dropped late reply " << sequence << " on " << channel_.name() << std::endl;
+                continue;
+            }
+            reply_type_ = type;
+            reply_payload_.assign(static_cast<const char*>(data), length);
+            channel_.consume();
+            reply_seq_.store(sequence, std::memory_order_release);
+            futex_wake_private(&reply_seq_);
+        } else {
+            channel_.consume();
+            std::cerr << "[Shm] Unexpected message type " << type << " on " << channel_.name() << std::endl;
+        }
+    }
+}
+
+} // namespace orchestrator
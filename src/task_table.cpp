@@ -0,0 +1,117 @@
+#include "task_table.h"
+
+namespace orchestrator {
+
+TaskHandle TaskTable::intern(const std::string& task_id) {
+    auto it = index_.find(task_id);
+    if (it != index_.end()) {
+        return it->second;
+    }
+
+    TaskHandle handle = static_cast<TaskHandle>(ids_.size());
+    ids_.push_back(task_id);
+    index_.emplace(task_id, handle);
+
+    state.push_back(TASK_STATE_IDLE);
+    result.push_back(TASK_RESULT_UNKNOWN);
+    scheduled_time_us.push_back(0);
+    actual_start_time_us.push_back(0);
+    end_time_us.push_back(0);
+    completed.push_back(0);
+    pending_deps.push_back(0);
+    endpoint.push_back(0);
+    timeline.push_back(TaskTimeline{0, 0, 0, 0, 0, 0, 0, 0, -1});
+    error_message.emplace_back();
+    dependency_count_.push_back(0);
+    dependents_.emplace_back();
+    dependencies_.emplace_back();
+
+    return handle;
+}
+
+TaskHandle TaskTable::find(const std::string& task_id) const {
+    auto it = index_.find(task_id);
+    return it != index_.end() ? it->second : INVALID_TASK_HANDLE;
+}
+
+TaskHandle TaskTable::resolve(TaskHandle hint, const std::string& task_id) const {
+    if (valid(hint) && ids_[hint] == task_id) {
+        return hint;
+    }
+    return find(task_id);
+}
+
+void TaskTable::add_dependency(TaskHandle task, TaskHandle depends_on) {
+    dependents_[depends_on].push_back(task);
+    dependencies_[task].push_back(depends_on);
+    dependency_count_[task]++;
+    pending_deps[task]++;
+}
+
+void TaskTable::clear() {
+    state.clear();
+    result.clear();
+    scheduled_time_us.clear();
+    actual_start_time_us.clear();
+    end_time_us.clear();
+    completed.clear();
+    pending_deps.clear();
+    endpoint.clear();
+    timeline.clear();
+    error_message.clear();
+    ids_.clear();
+    index_.clear();
+    dependency_count_.clear();
+    dependents_.clear();
+    dependencies_.clear();
+}
+
+void TaskTable::reset_runtime() {
+    for (TaskHandle h = 0; h < ids_.size(); h++) {
+        state[h] = TASK_STATE_IDLE;
+        result[h] = TASK_RESULT_UNKNOWN;
+        actual_start_time_us[h] = 0;
+        end_time_us[h] = 0;
+        completed[h] = 0;
+        pending_deps[h] = dependency_count_[h];
+        timeline[h] = TaskTimeline{0, 0, 0, 0, 0, 0, 0, 0, -1};
+        error_message[h].clear();
+    }
+}
+
+void TaskTable::mark_started(TaskHandle handle, int64_t start_time_us) {
+    state[handle] = TASK_STATE_STARTING;
+    result[handle] = TASK_RESULT_UNKNOWN;
+    actual_start_time_us[handle] = start_time_us;
+    end_time_us[handle] = 0;
+}
+
+void TaskTable::mark_completed(TaskHandle handle, TaskState final_state, TaskResult final_result,
+                               int64_t end_time) {
+    state[handle] = final_state;
+    result[handle] = final_result;
+    end_time_us[handle] = end_time;
+
+    // Release dependents only on the first completion of this task id
+    if (!completed[handle]) {
+        completed[handle] = 1;
+        for (TaskHandle dependent : dependents_[handle]) {
+            pending_deps[dependent]--;
+        }
+    }
+}
+
+ExecutionRecord TaskTable::record(TaskHandle handle) const {
+    ExecutionRecord rec;
+    rec.handle = handle;
+    rec.scheduled_time_us = scheduled_time_us[handle];
+    rec.actual_start_time_us = actual_start_time_us[handle];
+    rec.end_time_us = end_time_us[handle];
+    rec.state = state[handle];
+    rec.result = result[handle];
+    rec.endpoint = endpoint[handle];
+    rec.timeline = timeline[handle];
+    return rec;
+}
+
+} // namespace orchestrator
@@ -1,17 +1,45 @@
 #include "task_wrapper.h"
+#include "address_utils.h"
+#include "alloc_counter.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <algorithm>
 #include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
 
 namespace orchestrator {
 
+// ============================================================================
+// TaskParameterView Implementation
+// ============================================================================
+
+std::string_view TaskParameterView::get(std::string_view key, std::string_view default_value) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), key,
+        [](const Entry& entry, std::string_view k) { return entry.first < k; });
+    if (it != entries_.end() && it->first == key) {
+        return it->second;
+    }
+    return default_value;
+}
+
+bool TaskParameterView::contains(std::string_view key) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), key,
+        [](const Entry& entry, std::string_view k) { return entry.first < k; });
+    return it != entries_.end() && it->first == key;
+}
+
 // ============================================================================
 // TaskServiceImpl Implementation
 // ============================================================================
 
 TaskServiceImpl::TaskServiceImpl(TaskWrapper* wrapper)
-    : wrapper_(wrapper) {}
+    : wrapper_(wrapper)
+    , heartbeat_streams_(0) {}
 
 grpc::Status TaskServiceImpl::StartTask(
     grpc::ServerContext* context,
@@ -22,23 +50,83 @@ grpc::Status TaskServiceImpl::StartTask(
               << "[Task " << wrapper_->get_task_id() 
               << "] Received start command" << std::endl;
     
-    if (wrapper_->get_state() != TASK_STATE_IDLE) {
+    // Execute task
+    const char* rejection = wrapper_->accept_tasks(&request, 1);
+    if (rejection) {
         response->set_success(false);
-        response->set_message("Task is not in IDLE state");
+        response->set_message(rejection);
         return grpc::Status::OK;
     }
     
-    // Execute task
-    wrapper_->execute_task(*request);
-    
     response->set_success(true);
     response->set_message("Task started");
-    response->set_actual_start_time_us(wrapper_->get_start_time_us());
+    response->set_actual_start_time_us(wrapper_->get_accept_time_us());
+    response->set_task_id(wrapper_->get_task_id());
+    
+    return grpc::Status::OK;
+}
+
+grpc::Status TaskServiceImpl::StartTasks(
+    grpc::ServerContext* context,
+    const StartTasksRequest* request,
+    StartTasksResponse* response) {
+    
+    std::cout << "[" << std::setw(13) << wrapper_->get_relative_time_ms() << " ms] "
+              << "[Task " << wrapper_->get_task_id() 
+              << "] Received batch of " << request->starts_size() << " start commands" << std::endl;
+    
+    // The batch is accepted or rejected as a whole
+    const char* rejection = request->starts_size() > 0
+        ? wrapper_->accept_tasks(request->starts().data(), request->starts_size())
+        : nullptr;
+    
+    for (const StartTaskRequest& start : request->starts()) {
+        StartTaskResponse* start_response = response->add_responses();
+        start_response->set_success(rejection == nullptr);
+        start_response->set_message(rejection ? rejection : "Task started");
+        start_response->set_actual_start_time_us(rejection ? 0 : wrapper_->get_accept_time_us());
+        start_response->set_task_id(start.task_id().empty() ? wrapper_->get_task_id() : start.task_id());
+    }
+    
+    return grpc::Status::OK;
+}
+
+grpc::Status TaskServiceImpl::ArmTask(
+    grpc::ServerContext* context,
+    const ArmTaskRequest* request,
+    ArmTaskResponse* response) {
+    
+    std::cout << "[" << std::setw(13) << wrapper_->get_relative_time_ms() << " ms] "
+              << "[Task " << wrapper_->get_task_id() 
+              << "] Received arm command (release at " << request->release_time_us() / 1000
+              << " ms)" << std::endl;
+    
+    std::string message;
+    bool armed = wrapper_->arm_task(request->start(), request->release_time_us(), message);
+    
+    response->set_success(armed);
+    response->set_message(message);
     response->set_task_id(wrapper_->get_task_id());
     
     return grpc::Status::OK;
 }
 
+grpc::Status TaskServiceImpl::DisarmTask(
+    grpc::ServerContext* context,
+    const DisarmTaskRequest* request,
+    DisarmTaskResponse* response) {
+    
+    std::cout << "[" << std::setw(13) << wrapper_->get_relative_time_ms() << " ms] "
+              << "[Task " << wrapper_->get_task_id() 
+              << "] Received disarm command" << std::endl;
+    
+    std::string message;
+    response->set_success(wrapper_->disarm_task(request->task_id(), message));
+    response->set_message(message);
+    
+    return grpc::Status::OK;
+}
+
 grpc::Status TaskServiceImpl::StopTask(
     grpc::ServerContext* context,
     const StopTaskRequest* request,
@@ -71,10 +159,49 @@ grpc::Status TaskServiceImpl::GetTaskStatus(
     response->set_elapsed_time_us(wrapper_->get_elapsed_time_us());
     response->set_cpu_usage_percent(0.0);  // TODO: implement CPU monitoring
     response->set_memory_usage_bytes(0);   // TODO: implement memory monitoring
+    response->set_shm_name(wrapper_->get_shm_name());
+    response->set_uds_address(wrapper_->get_uds_address());
     
     return grpc::Status::OK;
 }
 
+grpc::Status TaskServiceImpl::Heartbeat(
+    grpc::ServerContext* context,
+    const HeartbeatRequest* request,
+    grpc::ServerWriter<HeartbeatBeat>* writer) {
+    
+    // The server threads reserved for streams are all taken
+    if (heartbeat_streams_.fetch_add(1) >= MAX_HEARTBEAT_STREAMS) {
+        heartbeat_streams_--;
+        return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "Too many heartbeat streams");
+    }
+    
+    int64_t interval_us = std::min(std::max(request->interval_us(), MIN_HEARTBEAT_INTERVAL_US),
+                                   MAX_HEARTBEAT_INTERVAL_US);
+    std::cout << "[" << std::setw(13) << wrapper_->get_relative_time_ms() << " ms] "
+              << "[Task " << wrapper_->get_task_id() 
+              << "] Heartbeat stream opened (every " << interval_us / 1000.0 << " ms)" << std::endl;
+    
+    // Ends when the orchestrator cancels the stream or the wrapper stops
+    HeartbeatBeat beat;
+    beat.set_task_id(wrapper_->get_task_id());
+    uint64_t sequence = 0;
+    while (wrapper_->is_running() && !context->IsCancelled()) {
+        beat.set_sequence(sequence++);
+        beat.set_state(wrapper_->get_state());
+        beat.set_rt_execution(wrapper_->is_running_rt());
+        beat.set_timestamp_us(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        if (!writer->Write(beat)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+    }
+    
+    heartbeat_streams_--;
+    return grpc::Status::OK;
+}
+
 // ============================================================================
 // TaskWrapper Implementation
 // ============================================================================
@@ -88,15 +215,54 @@ TaskWrapper::TaskWrapper(
     , listen_address_(listen_address)
     , orchestrator_address_(orchestrator_address)
     , execution_callback_(execution_callback)
+    , output_count_(0)
+    , inline_output_bytes_(0)
+    , output_sequence_(0)
+    , input_buffer_count_(0)
+    , shm_outputs_(AddressUtils::is_local(orchestrator_address))
+    , zero_alloc_mode_(false)
+    , start_pending_(false)
+    , worker_busy_(false)
+    , applied_rt_priority_(-1)
+    , execution_count_(0)
+    , queued_starts_(MAX_QUEUED_STARTS)
+    , queued_head_(0)
+    , queued_count_(0)
+    , notify_window_us_(0)
+    , notify_flush_at_us_(0)
+    , cgroup_requested_(false)
+    , numa_local_pages_(0)
+    , numa_remote_pages_(0)
+    , perf_enabled_(false)
+    , perf_measured_(false)
+    , minor_page_faults_(0)
+    , major_page_faults_(0)
+    , arm_generation_(0)
+    , hot_path_allocations_(0)
     , state_(TASK_STATE_IDLE)
+    , rt_execution_(false)
     , running_(false)
     , stop_requested_(false)
     , start_time_us_(0)
     , end_time_us_(0)
+    , accept_time_us_(0)
+    , cpu_core_(-1)
     , creation_time_us_(get_current_time_us()) {
     
     service_ = std::make_unique<TaskServiceImpl>(this);
     
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        perf_keys_[i] = PerfCounters::metric_name(static_cast<PerfCounter>(i));
+    }
+    
+    // Pooled end notification (reused by every execution)
+    notification_ = google::protobuf::Arena::CreateMessage<TaskEndNotification>(&notify_arena_);
+    notify_response_ = google::protobuf::Arena::CreateMessage<TaskEndResponse>(&notify_arena_);
+    pending_ends_ = google::protobuf::Arena::CreateMessage<TaskEndBatch>(&notify_arena_);
+    sending_ends_ = google::protobuf::Arena::CreateMessage<TaskEndBatch>(&notify_arena_);
+    notify_context_ = std::make_unique<grpc::ClientContext>();
+    armed_starts_.reserve(MAX_ARMED_STARTS);
+    
     // Create stub for orchestrator
     auto channel = grpc::CreateChannel(
         orchestrator_address_, 
@@ -107,10 +273,76 @@ TaskWrapper::TaskWrapper(
               << "[Task " << task_id_ << "] Task wrapper created" << std::endl;
 }
 
+TaskWrapper::TaskWrapper(
+    const std::string& task_id,
+    const std::string& listen_address,
+    const std::string& orchestrator_address,
+    TaskExecutionViewCallback execution_callback)
+    : TaskWrapper(task_id, listen_address, orchestrator_address, TaskExecutionCallback()) {
+    view_callback_ = execution_callback;
+}
+
 TaskWrapper::~TaskWrapper() {
+    // A stop received over the shared-memory channel may still be running
+    if (stop_thread_.joinable()) {
+        stop_thread_.join();
+    }
     stop();
 }
 
+void TaskWrapper::set_zero_allocation_mode(bool enabled) {
+    if (running_) {
+        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Zero-allocation mode must be set before start()" << std::endl;
+        return;
+    }
+    zero_alloc_mode_ = enabled;
+    
+    std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+              << "[Task " << task_id_ << "] Zero-allocation mode: " << (enabled ? "on" : "off") << std::endl;
+}
+
+void TaskWrapper::set_notify_coalescing_window(int64_t window_us) {
+    if (running_) {
+        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Notification coalescing must be set before start()" << std::endl;
+        return;
+    }
+    notify_window_us_ = std::max<int64_t>(window_us, 0);
+    
+    std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+              << "[Task " << task_id_ << "] End notification coalescing window: "
+              << notify_window_us_ << " us" << std::endl;
+}
+
+void TaskWrapper::set_shm_endpoint(const std::string& name) {
+    if (running_) {
+        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Shared-memory endpoint must be set before start()" << std::endl;
+        return;
+    }
+    shm_name_ = name;
+}
+
+void TaskWrapper::set_uds_path(const std::string& path) {
+    if (running_) {
+        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Unix socket path must be set before start()" << std::endl;
+        return;
+    }
+    uds_address_ = path.empty() ? "" : AddressUtils::UNIX_SCHEME + path;
+}
+
+void TaskWrapper::set_cgroup_isolation(bool enabled, const std::string& default_cpus) {
+    if (running_) {
+        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] cgroup isolation must be set before start()" << std::endl;
+        return;
+    }
+    cgroup_requested_ = enabled;
+    cgroup_cpus_ = default_cpus;
+}
+
 void TaskWrapper::set_rt_config(const RTConfig& config) {
     std::lock_guard<std::mutex> lock(mutex_);
     rt_config_ = config;
@@ -119,7 +351,15 @@ void TaskWrapper::set_rt_config(const RTConfig& config) {
               << "[Task " << task_id_ << "] Real-time configuration set:" << std::endl;
     std::cout << "  Policy: " << RTUtils::policy_to_string(config.policy) << std::endl;
     std::cout << "  Priority: " << config.priority << std::endl;
-    std::cout << "  CPU Affinity: " << (config.cpu_affinity >= 0 ? std::to_string(config.cpu_affinity) : "none") << std::endl;
+    std::cout << "  CPU Affinity: " << (config.cpus().empty() ? "none" : config.cpus()) << std::endl;
+    if (config.numa_policy != NUMA_POLICY_NONE) {
+        std::cout << "  NUMA Policy: " << RTUtils::numa_policy_to_string(config.numa_policy) << std::endl;
+    }
+    if (config.heap_reserve_bytes > 0 || config.pool_bytes > 0) {
+        std::cout << "  Heap reserve: " << config.heap_reserve_bytes / (1024 * 1024) << " MB, pool: "
+                  << config.pool_bytes / 1024 << " KB (huge pages: "
+                  << RTUtils::huge_pages_to_string(config.huge_pages) << ")" << std::endl;
+    }
 }
 
 void TaskWrapper::start() {
@@ -133,17 +373,73 @@ void TaskWrapper::start() {
               << "[Task " << task_id_ << "] Starting task wrapper on " 
               << listen_address_ << std::endl;
     
-    // Start gRPC server
+    // RT memory profile (no-op when main() already applied it)
+    RTUtils::apply_memory_profile(rt_config_);
+    if (rt_config_.pool_bytes > 0 && !memory_pool_) {
+        memory_pool_ = std::make_unique<RTMemoryPool>(rt_config_.pool_bytes, rt_config_.huge_pages);
+    }
+    
+    // Every thread of the process moves into the wrapper cgroup
+    if (cgroup_requested_) {
+        cgroup_.init("wrapper-" + task_id_, cgroup_cpus_);
+    }
+    
+    // Start gRPC server (socket files left by a previous run are removed)
     grpc::ServerBuilder builder;
+    AddressUtils::prepare_listen(listen_address_);
     builder.AddListeningPort(listen_address_, grpc::InsecureServerCredentials());
+    if (!uds_address_.empty()) {
+        if (AddressUtils::prepare_listen(uds_address_)) {
+            builder.AddListeningPort(uds_address_, grpc::InsecureServerCredentials());
+        } else {
+            uds_address_.clear();
+        }
+    }
     builder.RegisterService(service_.get());
     
-    server_ = builder.BuildAndStart();
-    std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
-              << "[Task " << task_id_ << "] gRPC server listening on " 
-              << listen_address_ << std::endl;
+    // StartTask/Heartbeat handlers run on gRPC's server threads
+    server_ = RTUtils::build_grpc_server(builder, rt_config_, TaskServiceImpl::MAX_HEARTBEAT_STREAMS);
+    if (!server_) {
+        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Failed to listen on " << listen_address_ << std::endl;
+    } else {
+        std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] gRPC server listening on " 
+                  << listen_address_ << std::endl;
+        if (!uds_address_.empty()) {
+            std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Also listening on " << uds_address_ << std::endl;
+        }
+    }
     
     state_ = TASK_STATE_IDLE;
+    
+    // Persistent worker thread for zero-allocation mode
+    if (zero_alloc_mode_) {
+        worker_thread_ = std::thread(&TaskWrapper::worker_loop, this);
+    }
+    
+    // Arm thread: configured now, so armed starts are released without setup
+    arm_thread_ = std::thread(&TaskWrapper::arm_loop, this);
+    
+    // Flusher thread for coalesced end notifications
+    if (notify_window_us_ > 0) {
+        notify_thread_ = std::thread(&TaskWrapper::notify_loop, this);
+    }
+    
+    // Shared-memory channel next to the gRPC server
+    if (!shm_name_.empty()) {
+        if (shm_channel_.create(shm_name_)) {
+            shm_thread_ = std::thread(&TaskWrapper::shm_loop, this);
+            std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Shared-memory channel on /dev/shm"
+                      << ShmChannel::segment_path(shm_name_) << std::endl;
+        } else {
+            std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Shared-memory channel unavailable, gRPC only" << std::endl;
+            shm_name_.clear();
+        }
+    }
 }
 
 void TaskWrapper::stop() {
@@ -160,94 +456,767 @@ void TaskWrapper::stop() {
     if (execution_thread_.joinable()) {
         execution_thread_.join();
     }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        worker_cv_.notify_all();
+    }
+    if (worker_thread_.joinable()) {
+        worker_thread_.join();
+    }
+    if (arm_thread_.joinable()) {
+        arm_thread_.join();
+    }
+    
+    // Flush the coalesced notifications of the executions that just ended
+    {
+        std::lock_guard<std::mutex> lock(notify_mutex_);
+        notify_cv_.notify_all();
+    }
+    if (notify_thread_.joinable()) {
+        notify_thread_.join();
+    }
+    
+    // The channel reader exits within its poll interval
+    if (shm_thread_.joinable()) {
+        shm_thread_.join();
+    }
+    shm_channel_.close();
     
     // Stop gRPC server
     if (server_) {
         server_->Shutdown();
+        AddressUtils::remove_socket(listen_address_);
+        AddressUtils::remove_socket(uds_address_);
     }
+    cgroup_.release();
     
     state_ = TASK_STATE_STOPPED;
     std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
               << "[Task " << task_id_ << "] Task wrapper stopped" << std::endl;
 }
 
-void TaskWrapper::execute_task(const StartTaskRequest& request) {
-    // Start execution in separate thread
+const char* TaskWrapper::execute_task(const StartTaskRequest& request, bool via_shm) {
+    const StartTaskRequest* requests[1] = {&request};
+    return execute_tasks(requests, 1, via_shm);
+}
+
+const char* TaskWrapper::execute_tasks(const StartTaskRequest* const* requests, size_t count, bool via_shm) {
+    ScopedAllocCounter allocations;
+    accept_time_us_ = get_current_time_us();
+    
     if (execution_thread_.joinable()) {
         execution_thread_.join();
     }
     
-    execution_thread_ = std::thread(&TaskWrapper::task_execution_thread, this, request);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        
+        // Armed starts keep their release time: starts that cannot finish
+        // before the earliest one wait behind it (the arm thread runs them)
+        if (!armed_starts_.empty() && !fits_before_release(requests, count)) {
+            if (queued_count_ + count > MAX_QUEUED_STARTS) {
+                return "Too many queued starts";
+            }
+            queue_starts(requests, count);
+            std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] " << count << " start(s) queued behind the armed start" << std::endl;
+            return nullptr;
+        }
+        
+        // The previous execution may still be sending its end notification
+        worker_cv_.wait(lock, [this]() { return !worker_busy_ || !running_; });
+        
+        if (count - 1 > MAX_QUEUED_STARTS) {
+            return "Batch too large";
+        }
+        
+        // Without an input the callback would run on partial data
+        if (!stage_request(*requests[0])) {
+            close_inputs();
+            return "Input is not available";
+        }
+        slot_.via_shm = via_shm;
+        queue_starts(requests + 1, count - 1);
+        start_pending_ = zero_alloc_mode_;
+        worker_busy_ = true;
+        
+        // Busy from now on, even before the execution starts
+        state_ = TASK_STATE_STARTING;
+    }
+    
+    if (execution_count_ > 0) {
+        hot_path_allocations_ += allocations.count();
+    }
+    
+    if (zero_alloc_mode_) {
+        // Wake the persistent worker
+        worker_cv_.notify_all();
+    } else {
+        // Start execution in separate thread. It inherits the scheduling
+        // policy of this gRPC handler (RT with --grpc-policy): the slot's RT
+        // config replaces it before the callback runs
+        execution_thread_ = std::thread(&TaskWrapper::task_execution_thread, this);
+    }
+    return nullptr;
+}
+
+const char* TaskWrapper::start_rejection() const {
+    if (state_ != TASK_STATE_IDLE) {
+        return "Task is not in IDLE state";
+    }
+    
+    // With starts armed, a start may be queued behind them (execute_tasks)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queued_count_ > 0 && armed_starts_.empty()) {
+        return "Task has queued starts";
+    }
+    return nullptr;
+}
+
+const char* TaskWrapper::accept_tasks(const StartTaskRequest* const* requests, size_t count, bool via_shm) {
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    const char* rejection = start_rejection();
+    if (!rejection) {
+        rejection = execute_tasks(requests, count, via_shm);
+    }
+    return rejection;
+}
+
+size_t TaskWrapper::get_queued_starts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_count_;
+}
+
+void TaskWrapper::queue_starts(const StartTaskRequest* const* requests, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        queued_starts_[(queued_head_ + queued_count_) % MAX_QUEUED_STARTS] = *requests[i];
+        queued_count_++;
+    }
+}
+
+bool TaskWrapper::fits_before_release(const StartTaskRequest* const* requests, size_t count) const {
+    if (worker_busy_ || queued_count_ > 0) {
+        return false;
+    }
+    // Without an estimate the start could delay the release
+    int64_t duration_us = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (requests[i]->estimated_duration_us() <= 0) {
+            return false;
+        }
+        duration_us += requests[i]->estimated_duration_us();
+    }
+    return get_system_time_us() + duration_us + ARM_PRECISE_WAIT_US <= armed_starts_.front().release_time_us;
+}
+
+bool TaskWrapper::stage_queued_start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queued_count_ == 0 || !running_) {
+        // Starts still queued at stop are dropped
+        queued_count_ = 0;
+        return false;
+    }
+    accept_time_us_ = get_current_time_us();
+    stage_request(queued_starts_[queued_head_]);
+    queued_head_ = (queued_head_ + 1) % MAX_QUEUED_STARTS;
+    queued_count_--;
+    return true;
+}
+
+void TaskWrapper::run_executions() {
+    run_execution();
+    while (stage_queued_start()) {
+        if (zero_alloc_mode_) {
+            refresh_slot_rt_config();
+        } else {
+            apply_slot_rt_config();
+        }
+        run_execution();
+    }
+}
+
+bool TaskWrapper::arm_task(const StartTaskRequest& request, int64_t release_time_us, std::string& message) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            message = "Task wrapper is stopping";
+            return false;
+        }
+        if (armed_starts_.size() >= MAX_ARMED_STARTS) {
+            message = "Too many armed starts";
+            return false;
+        }
+        auto position = std::upper_bound(armed_starts_.begin(), armed_starts_.end(), release_time_us,
+                                         [](int64_t release_us, const ArmedStart& armed) {
+                                             return release_us < armed.release_time_us;
+                                         });
+        // A new earliest start: the arm thread re-reads the front
+        if (position == armed_starts_.begin()) {
+            arm_generation_++;
+        }
+        armed_starts_.insert(position, ArmedStart{request, release_time_us});
+    }
+    worker_cv_.notify_all();
+    
+    message = "Task armed";
+    return true;
+}
+
+bool TaskWrapper::disarm_task(const std::string& task_id, std::string& message) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (armed_starts_.empty()) {
+            message = "No armed task";
+            return false;
+        }
+        if (task_id.empty()) {
+            armed_starts_.clear();
+            arm_generation_++;
+        } else {
+            auto armed = std::find_if(armed_starts_.begin(), armed_starts_.end(), [&task_id](const ArmedStart& start) {
+                return start.request.task_id() == task_id;
+            });
+            if (armed == armed_starts_.end()) {
+                message = "Task " + task_id + " is not armed";
+                return false;
+            }
+            if (armed == armed_starts_.begin()) {
+                arm_generation_++;
+            }
+            armed_starts_.erase(armed);
+        }
+    }
+    worker_cv_.notify_all();
+    
+    std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+              << "[Task " << task_id_ << "] Armed start cancelled" << std::endl;
+    message = "Task disarmed";
+    return true;
+}
+
+bool TaskWrapper::is_armed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !armed_starts_.empty();
+}
+
+void TaskWrapper::shm_loop() {
+    // Same RT configuration as the executions: starts are served from here
+    if (rt_config_.policy != RT_POLICY_NONE) {
+        RTUtils::apply_rt_config(rt_config_);
+    }
+    
+    StartTaskRequest request;
+    StartTaskResponse response;
+    StopTaskRequest stop_request;
+    StopTaskResponse stop_response;
+    
+    while (running_) {
+        ShmMessageType type;
+        uint32_t sequence;
+        const void* data;
+        uint32_t length;
+        if (!shm_channel_.receive(type, sequence, data, length, SHM_POLL_US)) {
+            continue;
+        }
+        
+        if (type == SHM_MSG_START) {
+            bool parsed = request.ParseFromArray(data, static_cast<int>(length));
+            shm_channel_.consume();
+            
+            const StartTaskRequest* requests[1] = {&request};
+            const char* rejection = parsed ? accept_tasks(requests, 1, true) : "Malformed start request";
+            response.set_success(rejection == nullptr);
+            response.set_message(rejection ? rejection : "Task started");
+            response.set_actual_start_time_us(rejection ? 0 : accept_time_us_.load());
+            response.set_task_id(task_id_);
+            shm_channel_.send(SHM_MSG_START_RESPONSE, response, sequence);
+        } else if (type == SHM_MSG_STOP) {
+            stop_request.ParseFromArray(data, static_cast<int>(length));
+            shm_channel_.consume();
+            
+            std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Received stop command (shared memory)" << std::endl;
+            
+            stop_response.set_success(true);
+            stop_response.set_message("Stop requested");
+            stop_response.set_stop_time_us(get_system_time_us());
+            shm_channel_.send(SHM_MSG_STOP_RESPONSE, stop_response, sequence);
+            
+            // stop() joins this thread, so it runs on its own
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!stop_thread_.joinable()) {
+                stop_thread_ = std::thread(&TaskWrapper::stop, this);
+            }
+            break;
+        } else {
+            shm_channel_.consume();
+            std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Unexpected shared-memory message " << type << std::endl;
+        }
+    }
+}
+
+void TaskWrapper::arm_loop() {
+    // Apply wrapper-level RT config once, before any start is armed
+    if (rt_config_.policy != RT_POLICY_NONE) {
+        RTUtils::apply_rt_config(rt_config_);
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        worker_cv_.wait(lock, [this]() {
+            return !armed_starts_.empty() || (queued_count_ > 0 && !worker_busy_) || !running_;
+        });
+        if (!running_) {
+            break;
+        }
+        
+        // Starts queued behind armed starts that were all disarmed
+        if (armed_starts_.empty()) {
+            worker_busy_ = true;
+            lock.unlock();
+            run_queued_starts();
+            lock.lock();
+            worker_busy_ = false;
+            worker_cv_.notify_all();
+            continue;
+        }
+        
+        // The earliest armed start; a disarm of it, or an earlier arm, bumps
+        // the generation and this loop starts over with the new front
+        const StartTaskRequest& armed_request = armed_starts_.front().request;
+        uint64_t generation = arm_generation_;
+        int64_t release_us = armed_starts_.front().release_time_us;
+        auto disarmed = [this, generation]() { return arm_generation_ != generation || !running_; };
+        
+        // Request-level RT config is applied while armed, not at the release
+        std::string rt_policy = armed_request.rt_policy();
+        int32_t rt_priority = armed_request.rt_priority();
+        std::string cpus = request_cpus(armed_request);
+        lock.unlock();
+        apply_request_rt_config(rt_policy, rt_priority, cpus);
+        lock.lock();
+        
+        // Coarse wait until shortly before the release (disarm/stop wake it up)
+        auto coarse_until = std::chrono::system_clock::time_point(
+            std::chrono::microseconds(release_us - ARM_PRECISE_WAIT_US));
+        if (worker_cv_.wait_until(lock, coarse_until, disarmed)) {
+            continue;
+        }
+        
+        // Precise absolute sleep for the remainder
+        lock.unlock();
+        struct timespec release_ts;
+        release_ts.tv_sec = release_us / 1000000;
+        release_ts.tv_nsec = (release_us % 1000000) * 1000;
+        while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &release_ts, nullptr) == EINTR) {
+        }
+        lock.lock();
+        
+        // A previous execution may still be running or notifying its end
+        worker_cv_.wait(lock, [this, &disarmed]() { return !worker_busy_ || disarmed(); });
+        if (disarmed()) {
+            continue;
+        }
+        
+        worker_busy_ = true;
+        accept_time_us_ = get_current_time_us();
+        stage_request(armed_starts_.front().request);
+        armed_starts_.erase(armed_starts_.begin());
+        arm_generation_++;
+        slot_.armed = true;
+        slot_.release_lateness_us = get_system_time_us() - release_us;
+        lock.unlock();
+        
+        std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Armed start released (lateness "
+                  << slot_.release_lateness_us << " us)" << std::endl;
+        
+        run_execution();
+        run_queued_starts();
+        
+        lock.lock();
+        worker_busy_ = false;
+        worker_cv_.notify_all();
+    }
+}
+
+void TaskWrapper::run_queued_starts() {
+    // Always re-applied: the arm thread keeps no record of what it applied
+    while (stage_queued_start()) {
+        apply_slot_rt_config();
+        run_execution();
+    }
+}
+
+bool TaskWrapper::stage_request(const StartTaskRequest& request) {
+    // Report the id the orchestrator scheduled (one wrapper may serve several ids)
+    slot_.task_id.assign(request.task_id().empty() ? task_id_ : request.task_id());
+    slot_.task_handle = request.task_handle();
+    slot_.via_shm = false;
+    slot_.armed = false;
+    slot_.release_lateness_us = 0;
+    slot_.rt_policy.assign(request.rt_policy());
+    slot_.rt_priority = request.rt_priority();
+    if (!request.cpu_list().empty()) {
+        slot_.cpus.assign(request.cpu_list());
+    } else if (request.cpu_affinity() >= 0) {
+        char cpu[16];
+        snprintf(cpu, sizeof(cpu), "%d", request.cpu_affinity());
+        slot_.cpus.assign(cpu);
+    } else {
+        slot_.cpus.clear();
+    }
+    slot_.estimated_duration_us = request.estimated_duration_us();
+    slot_.cpu_bandwidth = request.cpu_bandwidth();
+    slot_.memory_limit_bytes = request.memory_limit_bytes();
+    
+    // Parameters are assigned into existing strings; storage only grows
+    size_t count = 0;
+    auto store = [this, &count](const std::string& key, const std::string& value) {
+        if (count == slot_.param_storage.size()) {
+            slot_.param_storage.emplace_back();
+        }
+        slot_.param_storage[count].first.assign(key);
+        slot_.param_storage[count].second.assign(value);
+        count++;
+    };
+    for (const auto& param : request.parameters()) {
+        if (param.first != "task_id") {
+            store(param.first, param.second);
+        }
+    }
+    // Add task_id to parameters so the callback can identify which task it is
+    store("task_id", task_id_);
+    
+    // Outputs of the dependencies, as "<producer>.<name>": inline values are
+    // stored, shared-memory ones are mapped and viewed in place
+    close_inputs();
+    slot_.missing_input.clear();
+    std::string key;
+    for (const TaskOutput& input : request.inputs()) {
+        if (input.shm_segment().empty()) {
+            key.assign(input.producer()).append(".").append(input.name());
+            store(key, input.data());
+        }
+    }
+    for (const TaskOutput& input : request.inputs()) {
+        if (input.shm_segment().empty()) {
+            continue;
+        }
+        key.assign(input.producer()).append(".").append(input.name());
+        if (input_buffer_count_ == input_buffers_.size()) {
+            input_buffers_.emplace_back();
+        }
+        if (!input_buffers_[input_buffer_count_].open(input.shm_segment(), input.size())) {
+            std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Input " << key << " is not available" << std::endl;
+            slot_.missing_input.assign(key);
+            continue;
+        }
+        store(key, "");
+        input_buffer_count_++;
+    }
+    slot_.param_count = count;
+    
+    // Sorted view over the stored parameters; mapped inputs are the last
+    // entries with an empty stored value
+    param_view_.entries_.clear();
+    size_t mapped = count - input_buffer_count_;
+    for (size_t i = 0; i < count; i++) {
+        const auto& param = slot_.param_storage[i];
+        if (i >= mapped) {
+            const ShmOutputBuffer& buffer = input_buffers_[i - mapped];
+            param_view_.entries_.emplace_back(param.first, std::string_view(buffer.data(), buffer.size()));
+        } else {
+            param_view_.entries_.emplace_back(param.first, param.second);
+        }
+    }
+    std::sort(param_view_.entries_.begin(), param_view_.entries_.end(),
+        [](const TaskParameterView::Entry& a, const TaskParameterView::Entry& b) {
+            return a.first < b.first;
+        });
+    return slot_.missing_input.empty();
+}
+
+void TaskWrapper::close_inputs() {
+    for (size_t i = 0; i < input_buffer_count_; i++) {
+        input_buffers_[i].close();
+    }
+    input_buffer_count_ = 0;
 }
 
-void TaskWrapper::task_execution_thread(StartTaskRequest request) {
+void TaskWrapper::task_execution_thread() {
     std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
               << "[Task " << task_id_ << "] Starting task execution" << std::endl;
     
+    // Always applied, even for a request without RT config: "none" puts the
+    // inherited handler policy back to the wrapper's (or SCHED_OTHER)
+    apply_slot_rt_config();
+    run_executions();
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        worker_busy_ = false;
+    }
+    worker_cv_.notify_all();
+}
+
+void TaskWrapper::worker_loop() {
+    std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+              << "[Task " << task_id_ << "] Execution worker started" << std::endl;
+    
+    // Apply wrapper-level RT config once; per-request configs are applied on change
+    if (rt_config_.policy != RT_POLICY_NONE) {
+        RTUtils::apply_rt_config(rt_config_);
+    }
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            worker_cv_.wait(lock, [this]() { return start_pending_ || !running_; });
+            if (!running_) {
+                break;
+            }
+            start_pending_ = false;
+        }
+        
+        std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Starting task execution" << std::endl;
+        
+        refresh_slot_rt_config();
+        run_executions();
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            worker_busy_ = false;
+        }
+        worker_cv_.notify_all();
+    }
+}
+
+void TaskWrapper::refresh_slot_rt_config() {
+    // Re-apply the RT configuration only when the request changes it
+    if (slot_.rt_policy != applied_rt_policy_ ||
+        slot_.rt_priority != applied_rt_priority_ ||
+        slot_.cpus != applied_cpus_) {
+        apply_slot_rt_config();
+        applied_rt_policy_ = slot_.rt_policy;
+        applied_rt_priority_ = slot_.rt_priority;
+        applied_cpus_ = slot_.cpus;
+    }
+}
+
+void TaskWrapper::apply_slot_rt_config() {
+    apply_request_rt_config(slot_.rt_policy, slot_.rt_priority, slot_.cpus);
+}
+
+std::string TaskWrapper::request_cpus(const StartTaskRequest& request) {
+    if (!request.cpu_list().empty()) {
+        return request.cpu_list();
+    }
+    return request.cpu_affinity() >= 0 ? std::to_string(request.cpu_affinity()) : "";
+}
+
+void TaskWrapper::apply_request_rt_config(const std::string& policy, int32_t priority, const std::string& cpus) {
     // Apply real-time configuration from request (if specified)
-    if (request.rt_policy() != "none" && !request.rt_policy().empty()) {
+    bool rt_requested = policy != "none" && !policy.empty();
+    if (rt_requested || !cpus.empty()) {
+        // CPUs alone are applied too (e.g. a multi-threaded task spread
+        // over several cores); memory follows them with the NUMA policy
         RTConfig rt_config;
-        rt_config.policy = RTUtils::string_to_policy(request.rt_policy());
-        rt_config.priority = request.rt_priority();
-        rt_config.cpu_affinity = request.cpu_affinity();
+        rt_config.policy = rt_requested ? RTUtils::string_to_policy(policy) : RT_POLICY_NONE;
+        rt_config.priority = priority;
+        rt_config.cpu_list = cpus;
+        rt_config.numa_policy = rt_config_.numa_policy;
+        
+        // A policy alone does not keep the previous request's placement,
+        // CPUs alone do not keep its policy
+        if (cpus.empty()) {
+            reset_placement();
+        }
+        if (!rt_requested) {
+            reset_scheduling();
+        }
         
         std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
-                  << "[Task " << task_id_ << "] Applying RT config: policy=" 
-                  << request.rt_policy() << ", priority=" << request.rt_priority()
-                  << ", cpu_affinity=" << request.cpu_affinity() << std::endl;
+                  << "[Task " << task_id_ << "] Applying RT config: policy="
+                  << (rt_requested ? policy : "none") << ", priority=" << priority
+                  << ", cpus=" << (cpus.empty() ? "any" : cpus) << std::endl;
         
         if (!RTUtils::apply_rt_config(rt_config)) {
             std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
                       << "[Task " << task_id_ << "] Warning: Failed to apply RT configuration" << std::endl;
         }
-    } else if (rt_config_.policy != RT_POLICY_NONE) {
-        // Fallback to wrapper-level RT config if no request-level config
-        RTUtils::apply_rt_config(rt_config_);
+    } else {
+        // Fallback to wrapper-level RT config if no request-level config.
+        // Threads that outlive an execution (persistent worker, arm thread,
+        // queued starts) first drop the previous request's CPUs, memory
+        // policy and scheduling policy
+        reset_placement();
+        if (rt_config_.policy != RT_POLICY_NONE) {
+            RTUtils::apply_rt_config(rt_config_);
+        } else {
+            reset_scheduling();
+        }
     }
+}
+
+void TaskWrapper::reset_scheduling() {
+    if (rt_config_.policy != RT_POLICY_NONE) {
+        RTUtils::set_thread_realtime(rt_config_.policy, rt_config_.priority);
+    } else {
+        RTUtils::set_thread_normal(pthread_self());
+    }
+}
+
+void TaskWrapper::reset_placement() {
+    // Wrapper-level CPUs (or any CPU) and memory policy
+    std::string cpus = rt_config_.cpus();
+    if (cpus.empty()) {
+        RTUtils::clear_cpu_affinity(pthread_self());
+    } else {
+        RTUtils::set_cpu_affinity(pthread_self(), cpus);
+    }
+    if (rt_config_.numa_policy != NUMA_POLICY_NONE) {
+        cpu_set_t cpu_set;
+        uint64_t nodes = RTUtils::parse_cpu_list(cpus, cpu_set) ? RTUtils::numa_nodes_of_cpus(cpu_set) : 0;
+        RTUtils::set_numa_policy(nodes != 0 ? rt_config_.numa_policy : NUMA_POLICY_NONE, nodes);
+    }
+}
+
+void TaskWrapper::run_execution() {
+    // Page placement, only for an execution pinned under a NUMA policy.
+    // numa_maps is read before the timed window and the allocation-free
+    // setup (and again after the callback ended)
+    uint64_t numa_nodes = 0;
+    int64_t local_pages_before = 0;
+    int64_t remote_pages_before = 0;
+    cpu_set_t numa_cpus;
+    if (rt_config_.numa_policy != NUMA_POLICY_NONE && RTUtils::parse_cpu_list(slot_.cpus, numa_cpus)) {
+        numa_nodes = RTUtils::numa_nodes_of_cpus(numa_cpus);
+        RTUtils::numa_page_counts(numa_nodes, local_pages_before, remote_pages_before);
+    }
+    
+    ScopedAllocCounter allocations;
     
     state_ = TASK_STATE_STARTING;
     start_time_us_ = get_current_time_us();
+    task_handle_ = slot_.task_handle;
     
-    // Convert parameters to map
-    std::map<std::string, std::string> params;
-    for (const auto& param : request.parameters()) {
-        params[param.first] = param.second;
+    // The legacy callback receives a map, refreshed in place
+    if (!view_callback_) {
+        sync_param_map();
     }
     
-    // Add task_id to parameters so the callback can identify which task it is
-    params["task_id"] = task_id_;
+    // Isolate the callback in the execution cgroup
+    bool isolated = false;
+    if (cgroup_.enabled()) {
+        cgroup_limits_.cpus.assign(slot_.cpus);
+        cgroup_limits_.cpu_bandwidth = slot_.cpu_bandwidth;
+        cgroup_limits_.estimated_duration_us = slot_.estimated_duration_us;
+        cgroup_limits_.memory_limit_bytes = slot_.memory_limit_bytes;
+        isolated = cgroup_.enter(cgroup_limits_, cgroup_before_);
+    }
     
+    // Heartbeats may stall while an RT callback holds the CPU (see Heartbeat)
+    int sched_policy = sched_getscheduler(0);
+    rt_execution_ = sched_policy >= 0 && sched_policy != SCHED_OTHER &&
+                    sched_policy != SCHED_BATCH && sched_policy != SCHED_IDLE;
     state_ = TASK_STATE_RUNNING;
+    uint64_t setup_allocations = allocations.count();
     
     // Execute the actual task
     TaskResult result = TASK_RESULT_UNKNOWN;
     std::string error_message;
     
-    try {
-        result = execution_callback_(params);
-        
-        if (result == TASK_RESULT_UNKNOWN) {
-            result = TASK_RESULT_SUCCESS;
-        }
-        
-        std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
-                  << "[Task " << task_id_ << "] Task execution completed successfully" 
-                  << std::endl;
-    } catch (const std::exception& e) {
-        result = TASK_RESULT_FAILURE;
-        error_message = std::string("Exception: ") + e.what();
-        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
-                  << "[Task " << task_id_ << "] Task execution failed: " 
-                  << error_message << std::endl;
-    } catch (...) {
+    output_count_ = 0;
+    inline_output_bytes_ = 0;
+    
+    int64_t minor_faults_before;
+    int64_t major_faults_before;
+    RTUtils::thread_page_faults(minor_faults_before, major_faults_before);
+    RTMemoryPool::set_current(memory_pool_.get());
+    perf_measured_ = perf_enabled_ && perf_.begin();
+    
+    // A queued or armed start was accepted before its inputs were mapped
+    if (!slot_.missing_input.empty()) {
         result = TASK_RESULT_FAILURE;
-        error_message = "Unknown exception";
-        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
-                  << "[Task " << task_id_ << "] Task execution failed with unknown exception" 
-                  << std::endl;
+        error_message = "Input " + slot_.missing_input + " is not available";
+    } else {
+        try {
+            result = view_callback_ ? view_callback_(param_view_) : execution_callback_(params_);
+            
+            if (result == TASK_RESULT_UNKNOWN) {
+                result = TASK_RESULT_SUCCESS;
+            }
+            
+            std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Task execution completed successfully"
+                      << std::endl;
+        } catch (const std::exception& e) {
+            result = TASK_RESULT_FAILURE;
+            error_message = std::string("Exception: ") + e.what();
+            std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Task execution failed: "
+                      << error_message << std::endl;
+        } catch (...) {
+            result = TASK_RESULT_FAILURE;
+            error_message = "Unknown exception";
+            std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Task execution failed with unknown exception"
+                      << std::endl;
+        }
     }
     
     end_time_us_ = get_current_time_us();
+    rt_execution_ = false;
+    cpu_core_ = sched_getcpu();
+    if (perf_measured_) {
+        perf_.end(perf_sample_);
+    }
+    
+    // Outputs are complete and inputs consumed: unmap both (the orchestrator
+    // unlinks the segments once their last consumer has ended)
+    for (size_t i = 0; i < output_count_; i++) {
+        outputs_[i].buffer.close();
+    }
+    close_inputs();
+    
+    RTMemoryPool::set_current(nullptr);
+    RTUtils::thread_page_faults(minor_page_faults_, major_page_faults_);
+    minor_page_faults_ -= minor_faults_before;
+    major_page_faults_ -= major_faults_before;
+    if (minor_page_faults_ > 0 || major_page_faults_ > 0) {
+        std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Callback took " << minor_page_faults_ << " minor / "
+                  << major_page_faults_ << " major page faults" << std::endl;
+    }
+    if (memory_pool_) {
+        if (memory_pool_->overflows() > 0) {
+            std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Warning: memory pool exhausted ("
+                      << memory_pool_->overflows() << " heap fallbacks, " << memory_pool_->capacity() / 1024
+                      << " KB pool)" << std::endl;
+        }
+        memory_pool_->reset();
+    }
+    
+    cgroup_usage_ = CgroupIsolation::CpuStat();
+    if (isolated) {
+        cgroup_.leave(cgroup_before_, cgroup_usage_);
+    }
+    
+    // Pages the whole process (every thread) gained on and off the execution's nodes
+    numa_local_pages_ = 0;
+    numa_remote_pages_ = 0;
+    if (numa_nodes != 0) {
+        int64_t local_pages = 0;
+        int64_t remote_pages = 0;
+        RTUtils::numa_page_counts(numa_nodes, local_pages, remote_pages);
+        numa_local_pages_ = std::max<int64_t>(local_pages - local_pages_before, 0);
+        numa_remote_pages_ = std::max<int64_t>(remote_pages - remote_pages_before, 0);
+    }
     
     // Check if stop was requested
     if (stop_requested_) {
@@ -257,44 +1226,289 @@ void TaskWrapper::task_execution_thread(StartTaskRequest request) {
     
     state_ = TASK_STATE_COMPLETED;
     
+    // Accept the next start as soon as the orchestrator can react to this end
+    state_ = TASK_STATE_IDLE;
+    
     // Notify orchestrator
     notify_orchestrator_end(result, error_message);
     
-    // Return to idle state
-    state_ = TASK_STATE_IDLE;
+    // The first execution warms up all reusable buffers
+    if (execution_count_++ > 0) {
+        hot_path_allocations_ += setup_allocations;
+        if (zero_alloc_mode_ && AllocCounter::enabled() && hot_path_allocations_ > 0) {
+            std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Warning: " << hot_path_allocations_
+                      << " heap allocations on the hot path after warmup" << std::endl;
+        }
+    }
+}
+
+bool TaskWrapper::publish_output(const std::string& name, std::string_view value) {
+    PublishedOutput* output = next_output(name);
+    if (!output) {
+        return false;
+    }
+    if (!shm_outputs_ || inline_output_bytes_ + value.size() <= INLINE_OUTPUT_BYTES) {
+        output->data.assign(value.data(), value.size());
+        inline_output_bytes_ += value.size();
+        return true;
+    }
+    char* data = map_output(*output, value.size());
+    if (!data) {
+        return false;
+    }
+    memcpy(data, value.data(), value.size());
+    return true;
+}
+
+char* TaskWrapper::allocate_output(const std::string& name, size_t size) {
+    PublishedOutput* output = next_output(name);
+    if (!output) {
+        return nullptr;
+    }
+    // Orchestrator on another host: the value travels in the notification
+    if (size == 0 || !shm_outputs_) {
+        output->data.resize(size);
+        return &output->data[0];
+    }
+    return map_output(*output, size);
+}
+
+TaskWrapper::PublishedOutput* TaskWrapper::next_output(const std::string& name) {
+    if (state_ != TASK_STATE_RUNNING) {
+        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Output " << name << " published outside an execution" << std::endl;
+        return nullptr;
+    }
+    
+    // Publishing a name again replaces its value (and its buffer)
+    size_t index = 0;
+    while (index < output_count_ && outputs_[index].name != name) {
+        index++;
+    }
+    PublishedOutput& output = index < outputs_.size() ? outputs_[index] : outputs_.emplace_back();
+    if (index < output_count_) {
+        inline_output_bytes_ -= output.data.size();
+        output.buffer.close();
+        if (!output.segment.empty()) {
+            ShmOutputBuffer::unlink(output.segment);
+        }
+    } else {
+        output_count_++;
+    }
+    output.name.assign(name);
+    output.data.clear();
+    output.segment.clear();
+    output.size = 0;
+    return &output;
+}
+
+char* TaskWrapper::map_output(PublishedOutput& output, size_t size) {
+    // Unique per wrapper process and execution
+    std::string segment = "out_" + slot_.task_id + "_" + std::to_string(getpid()) + "_" +
+                          std::to_string(output_sequence_++);
+    if (!output.buffer.create(segment, size)) {
+        std::swap(output, outputs_[output_count_ - 1]);
+        output_count_--;
+        return nullptr;
+    }
+    output.segment = segment;
+    output.size = size;
+    return output.buffer.data();
+}
+
+void TaskWrapper::sync_param_map() {
+    const auto& entries = param_view_.entries_;
+    
+    // Steady state: same keys as last time, assign values into existing nodes
+    bool same_keys = params_.size() == entries.size();
+    if (same_keys) {
+        auto it = params_.begin();
+        for (const auto& entry : entries) {
+            if (it->first != entry.first) {
+                same_keys = false;
+                break;
+            }
+            ++it;
+        }
+    }
+    
+    if (same_keys) {
+        auto it = params_.begin();
+        for (const auto& entry : entries) {
+            it->second.assign(entry.second.data(), entry.second.size());
+            ++it;
+        }
+    } else {
+        params_.clear();
+        for (const auto& entry : entries) {
+            params_.emplace(std::string(entry.first), std::string(entry.second));
+        }
+    }
 }
 
 void TaskWrapper::notify_orchestrator_end(TaskResult result, const std::string& error_msg) {
+    ScopedAllocCounter allocations;
+    
+    // Started over shared memory: the end goes back the same way. One that
+    // does not fit in a ring slot (large inline outputs) or a stalled
+    // channel falls back to gRPC, or the orchestrator would wait forever
+    if (slot_.via_shm) {
+        fill_notification(*notification_, result, error_msg);
+        if (shm_channel_.send(SHM_MSG_TASK_END, *notification_)) {
+            if (execution_count_ > 0) {
+                hot_path_allocations_ += allocations.count();
+            }
+            return;
+        }
+        std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                  << "[Task " << task_id_ << "] Failed to notify orchestrator over shared memory, "
+                  << "using gRPC" << std::endl;
+    }
+    
+    // Coalescing: queue the notification, the flusher sends the batch
+    if (notify_window_us_ > 0) {
+        {
+            std::lock_guard<std::mutex> lock(notify_mutex_);
+            if (pending_ends_->notifications_size() == 0) {
+                notify_flush_at_us_ = get_current_time_us() + notify_window_us_;
+            }
+            fill_notification(*pending_ends_->add_notifications(), result, error_msg);
+        }
+        notify_cv_.notify_one();
+        
+        if (execution_count_ > 0) {
+            hot_path_allocations_ += allocations.count();
+        }
+        return;
+    }
+    
     std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
-              << "[Task " << task_id_ << "] Notifying orchestrator of task end" 
+              << "[Task " << task_id_ << "] Notifying orchestrator of task end"
               << std::endl;
     
-    TaskEndNotification notification;
-    notification.set_task_id(task_id_);
-    notification.set_result(result);
-    notification.set_start_time_us(start_time_us_);
-    notification.set_end_time_us(end_time_us_);
-    notification.set_execution_duration_us(end_time_us_ - start_time_us_);
-    notification.set_error_message(error_msg);
+    // Pooled notification: fields are overwritten, string capacity is reused
+    TaskEndNotification& notification = *notification_;
+    fill_notification(notification, result, error_msg);
     
-    TaskEndResponse response;
-    grpc::ClientContext context;
+    // Client contexts cannot be reused; the next one is created after the call
+    grpc::ClientContext& context = *notify_context_;
     
     // Set timeout for gRPC call
     auto deadline = std::chrono::system_clock::now() + std::chrono::seconds(5);
     context.set_deadline(deadline);
     
-    grpc::Status status = orchestrator_stub_->NotifyTaskEnd(&context, notification, &response);
+    if (execution_count_ > 0) {
+        hot_path_allocations_ += allocations.count();
+    }
+    
+    grpc::Status status = orchestrator_stub_->NotifyTaskEnd(&context, notification, notify_response_);
     
-    if (status.ok() && response.acknowledged()) {
+    if (status.ok() && notify_response_->acknowledged()) {
         std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
-                  << "[Task " << task_id_ << "] Orchestrator acknowledged task end" 
+                  << "[Task " << task_id_ << "] Orchestrator acknowledged task end"
                   << std::endl;
     } else {
         std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
-                  << "[Task " << task_id_ << "] Failed to notify orchestrator: " 
+                  << "[Task " << task_id_ << "] Failed to notify orchestrator: "
                   << status.error_message() << std::endl;
     }
+    
+    // Pre-create the context for the next notification (off the hot path)
+    notify_context_ = std::make_unique<grpc::ClientContext>();
+}
+
+void TaskWrapper::fill_notification(TaskEndNotification& notification, TaskResult result,
+                                    const std::string& error_msg) {
+    notification.set_task_id(slot_.task_id);
+    notification.set_result(result);
+    notification.set_start_time_us(start_time_us_);
+    notification.set_end_time_us(end_time_us_);
+    notification.set_execution_duration_us(end_time_us_ - start_time_us_);
+    notification.set_error_message(error_msg);
+    notification.set_task_handle(task_handle_);
+    notification.set_cpu_core(cpu_core_);
+    notification.set_accept_time_us(accept_time_us_);
+    notification.set_armed(slot_.armed);
+    notification.set_release_lateness_us(slot_.release_lateness_us);
+    notification.set_cpu_usage_us(cgroup_usage_.usage_us);
+    notification.set_cpu_throttled_periods(cgroup_usage_.nr_throttled);
+    notification.set_cpu_throttled_us(cgroup_usage_.throttled_us);
+    notification.set_numa_local_pages(numa_local_pages_);
+    notification.set_numa_remote_pages(numa_remote_pages_);
+    notification.set_minor_page_faults(minor_page_faults_);
+    notification.set_major_page_faults(major_page_faults_);
+    
+    // Outputs of the callback (message storage is reused by Add)
+    auto& outputs = *notification.mutable_outputs();
+    outputs.Clear();
+    for (size_t i = 0; i < output_count_; i++) {
+        const PublishedOutput& published = outputs_[i];
+        TaskOutput* output = outputs.Add();
+        output->set_name(published.name);
+        if (published.segment.empty()) {
+            output->set_data(published.data);
+        } else {
+            output->set_shm_segment(published.segment);
+            output->set_size(published.size);
+        }
+    }
+    
+    // Keys are reused from the previous execution; values assigned in place.
+    // An unmeasured execution must not carry the counters of an earlier one
+    auto& metrics = *notification.mutable_metrics();
+    if (!perf_measured_) {
+        metrics.clear();
+    } else {
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            if (!perf_sample_.valid[i]) {
+                metrics.erase(perf_keys_[i]);
+                continue;
+            }
+            int length = snprintf(perf_value_, sizeof(perf_value_), "%lld",
+                                  static_cast<long long>(perf_sample_.values[i]));
+            metrics[perf_keys_[i]].assign(perf_value_, length);
+        }
+    }
+}
+
+void TaskWrapper::notify_loop() {
+    std::unique_lock<std::mutex> lock(notify_mutex_);
+    while (true) {
+        notify_cv_.wait(lock, [this]() { return pending_ends_->notifications_size() > 0 || !running_; });
+        if (pending_ends_->notifications_size() == 0) {
+            break;
+        }
+        
+        // Completions within the window join the batch (stop() flushes at once)
+        auto flush_at = std::chrono::steady_clock::time_point(std::chrono::microseconds(notify_flush_at_us_));
+        notify_cv_.wait_until(lock, flush_at, [this]() { return !running_.load(); });
+        
+        std::swap(pending_ends_, sending_ends_);
+        lock.unlock();
+        
+        int count = sending_ends_->notifications_size();
+        grpc::ClientContext& context = *notify_context_;
+        auto deadline = std::chrono::system_clock::now() + std::chrono::seconds(5);
+        context.set_deadline(deadline);
+        
+        grpc::Status status = orchestrator_stub_->NotifyTaskEnds(&context, *sending_ends_, notify_response_);
+        
+        if (status.ok() && notify_response_->acknowledged()) {
+            std::cout << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Orchestrator acknowledged " << count
+                      << " task end(s)" << std::endl;
+        } else {
+            std::cerr << "[" << std::setw(13) << get_relative_time_ms() << " ms] "
+                      << "[Task " << task_id_ << "] Failed to notify orchestrator of " << count
+                      << " task end(s): " << status.error_message() << std::endl;
+        }
+        
+        // Cleared messages stay allocated for the next batch
+        sending_ends_->Clear();
+        notify_context_ = std::make_unique<grpc::ClientContext>();
+        lock.lock();
+    }
 }
 
 int64_t TaskWrapper::get_elapsed_time_us() const {
@@ -314,6 +1528,11 @@ int64_t TaskWrapper::get_current_time_us() const {
         std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
+int64_t TaskWrapper::get_system_time_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 int64_t TaskWrapper::get_relative_time_ms() const {
     // Return absolute timestamp in milliseconds for synchronization
     return std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -0,0 +1,215 @@
+#include "timeline_export.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+namespace orchestrator {
+
+namespace {
+
+constexpr int ORCHESTRATOR_TID = 0;
+constexpr int UNKNOWN_CORE_TID = 999;
+constexpr int CORE_TID_BASE = 1000;
+
+std::string json_escape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+int core_tid(int32_t cpu_core) {
+    return cpu_core >= 0 ? CORE_TID_BASE + cpu_core : UNKNOWN_CORE_TID;
+}
+
+// Writes comma-separated trace events
+class EventWriter {
+public:
+    explicit EventWriter(std::ostream& out) : out_(out), first_(true) {}
+    
+    void metadata(const char* name, int pid, int tid, const std::string& value) {
+        begin();
+        out_ << "{\"ph\":\"M\",\"name\":\"" << name << "\",\"pid\":" << pid
+             << ",\"tid\":" << tid << ",\"args\":{\"name\":\"" << json_escape(value) << "\"}}";
+    }
+    
+    void span(const std::string& name, const char* cat, int pid, int tid,
+              int64_t start_us, int64_t end_us, const std::string& args) {
+        begin();
+        out_ << "{\"ph\":\"X\",\"name\":\"" << json_escape(name) << "\",\"cat\":\"" << cat
+             << "\",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":" << start_us
+             << ",\"dur\":" << std::max<int64_t>(end_us - start_us, 0)
+             << ",\"args\":{" << args << "}}";
+    }
+    
+    void instant(const std::string& name, const char* cat, int pid, int tid,
+                 int64_t ts_us, const std::string& args) {
+        begin();
+        out_ << "{\"ph\":\"i\",\"s\":\"t\",\"name\":\"" << json_escape(name) << "\",\"cat\":\"" << cat
+             << "\",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":" << ts_us
+             << ",\"args\":{" << args << "}}";
+    }
+    
+    void flow(const char* phase, uint64_t id, int pid, int tid, int64_t ts_us) {
+        begin();
+        out_ << "{\"ph\":\"" << phase << "\",\"name\":\"dependency\",\"cat\":\"dependency\",\"id\":" << id
+             << ",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":" << ts_us;
+        if (phase[0] == 'f') {
+            out_ << ",\"bp\":\"e\"";
+        }
+        out_ << "}";
+    }
+
+private:
+    void begin() {
+        out_ << (first_ ? "\n" : ",\n");
+        first_ = false;
+    }
+    
+    std::ostream& out_;
+    bool first_;
+};
+
+} // namespace
+
+bool TimelineExporter::write_chrome_trace(const std::string& path,
+                                          const std::vector<TaskExecution>& executions,
+                                          const std::vector<TimelineDependency>& dependencies) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[Timeline] Failed to open " << path << std::endl;
+        return false;
+    }
+    write_chrome_trace(out, executions, dependencies);
+    return out.good();
+}
+
+void TimelineExporter::write_chrome_trace(std::ostream& out,
+                                          const std::vector<TaskExecution>& executions,
+                                          const std::vector<TimelineDependency>& dependencies) {
+    // One process per wrapper address, in order of first appearance
+    std::map<std::string, int> pids;
+    std::map<std::pair<int, int>, bool> core_tracks;
+    for (const TaskExecution& exec : executions) {
+        int pid = pids.emplace(exec.task_address, static_cast<int>(pids.size()) + 1).first->second;
+        core_tracks[{pid, core_tid(exec.timeline.cpu_core)}] = true;
+    }
+    
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    EventWriter events(out);
+    
+    for (const auto& entry : pids) {
+        std::string name = entry.first.empty() ? "wrapper" : "wrapper " + entry.first;
+        events.metadata("process_name", entry.second, ORCHESTRATOR_TID, name);
+        events.metadata("thread_name", entry.second, ORCHESTRATOR_TID, "orchestrator");
+    }
+    for (const auto& entry : core_tracks) {
+        int tid = entry.first.second;
+        std::string name = tid == UNKNOWN_CORE_TID ? "CPU ?" : "CPU " + std::to_string(tid - CORE_TID_BASE);
+        events.metadata("thread_name", entry.first.first, tid, name);
+    }
+    
+    for (const TaskExecution& exec : executions) {
+        const TaskTimeline& tl = exec.timeline;
+        int pid = pids[exec.task_address];
+        int cpu = core_tid(tl.cpu_core);
+        std::string task_args = "\"task_id\":\"" + json_escape(exec.task_id) + "\"";
+        
+        events.instant("scheduled release " + exec.task_id, "scheduler", pid, ORCHESTRATOR_TID,
+                       exec.scheduled_time_us,
+                       task_args + ",\"release_delay_us\":" + std::to_string(tl.release_us - exec.scheduled_time_us));
+        
+        if (tl.release_us > tl.wait_start_us) {
+            events.span("dependency wait " + exec.task_id, "scheduler", pid, ORCHESTRATOR_TID,
+                        tl.wait_start_us, tl.release_us, task_args);
+        }
+        
+        // The start response may arrive after the end notification; fall back
+        // to the wrapper accept time for the end of the RPC
+        int64_t dispatch_end = tl.dispatch_done_us > 0 ? tl.dispatch_done_us : tl.wrapper_start_us;
+        if (tl.dispatch_us > 0 && dispatch_end > 0) {
+            events.span("dispatch RPC " + exec.task_id, "rpc", pid, ORCHESTRATOR_TID,
+                        tl.dispatch_us, dispatch_end, task_args);
+        }
+        
+        if (tl.wrapper_start_us > 0 && tl.callback_start_us > 0) {
+            events.span("wrapper start " + exec.task_id, "wrapper", pid, cpu,
+                        tl.wrapper_start_us, tl.callback_start_us, task_args);
+        }
+        
+        if (tl.callback_start_us > 0) {
+            std::string args = task_args + ",\"result\":\"" + TaskResult_Name(exec.result) + "\"";
+            if (!exec.error_message.empty()) {
+                args += ",\"error\":\"" + json_escape(exec.error_message) + "\"";
+            }
+            events.span(exec.task_id, "task", pid, cpu, tl.callback_start_us, tl.callback_end_us, args);
+        }
+        
+        if (tl.notify_received_us > 0 && tl.callback_end_us > 0) {
+            events.span("end notification " + exec.task_id, "rpc", pid, ORCHESTRATOR_TID,
+                        tl.callback_end_us, tl.notify_received_us, task_args);
+        }
+    }
+    
+    // Flow arrows: latest execution of the dependency that ended before the
+    // dependent was released
+    std::map<std::string, std::vector<const TaskExecution*>> by_task;
+    for (const TaskExecution& exec : executions) {
+        by_task[exec.task_id].push_back(&exec);
+    }
+    
+    uint64_t flow_id = 1;
+    for (const TimelineDependency& dep : dependencies) {
+        auto dependents = by_task.find(dep.task_id);
+        auto sources = by_task.find(dep.depends_on);
+        if (dependents == by_task.end() || sources == by_task.end()) {
+            continue;
+        }
+        for (const TaskExecution* dependent : dependents->second) {
+            const TaskExecution& exec = *dependent;
+            if (exec.timeline.dispatch_us <= 0) {
+                continue;
+            }
+            const TaskExecution* source = nullptr;
+            for (const TaskExecution* candidate_ptr : sources->second) {
+                const TaskExecution& candidate = *candidate_ptr;
+                if (candidate.timeline.callback_start_us > 0 &&
+                    candidate.timeline.callback_end_us <= exec.timeline.release_us &&
+                    (!source || candidate.timeline.callback_end_us > source->timeline.callback_end_us)) {
+                    source = &candidate;
+                }
+            }
+            if (!source) {
+                continue;
+            }
+            
+            const TaskTimeline& src = source->timeline;
+            int64_t source_ts = std::max(src.callback_start_us, src.callback_end_us - 1);
+            events.flow("s", flow_id, pids[source->task_address], core_tid(src.cpu_core), source_ts);
+            events.flow("f", flow_id, pids[exec.task_address], ORCHESTRATOR_TID, exec.timeline.dispatch_us);
+            flow_id++;
+        }
+    }
+    
+    out << "\n]}\n";
+}
+
+} // namespace orchestrator
@@ -0,0 +1,180 @@
+#include "trace_file.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace orchestrator {
+
+// ============================================================================
+// TraceWriter Implementation
+// ============================================================================
+
+TraceWriter::TraceWriter()
+    : fd_(-1)
+    , map_(nullptr)
+    , mapped_size_(0)
+    , write_offset_(0)
+    , record_count_(0) {}
+
+TraceWriter::~TraceWriter() {
+    close();
+}
+
+bool TraceWriter::open(const std::string& path, const TaskTable& tasks, int64_t start_time_us) {
+    close();
+    
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "[Trace] Failed to open trace file " << path << ": "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    // Task id table: NUL-terminated ids, padded so records stay 8-byte aligned
+    std::string id_table;
+    for (TaskHandle h = 0; h < tasks.size(); h++) {
+        id_table.append(tasks.id(h));
+        id_table.push_back('\0');
+    }
+    id_table.resize((id_table.size() + 7) & ~static_cast<size_t>(7), '\0');
+    
+    TraceFileHeader header{};
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    header.start_time_us = start_time_us;
+    header.task_count = static_cast<uint32_t>(tasks.size());
+    header.id_table_size = static_cast<uint32_t>(id_table.size());
+    header.data_offset = sizeof(TraceFileHeader) + id_table.size();
+    header.record_count = 0;
+    
+    if (!grow(header.data_offset + TRACE_GROW_BYTES)) {
+        close();
+        return false;
+    }
+    
+    std::memcpy(map_, &header, sizeof(header));
+    std::memcpy(map_ + sizeof(header), id_table.data(), id_table.size());
+    write_offset_ = header.data_offset;
+    record_count_ = 0;
+    
+    std::cout << "[Trace] Writing execution trace to " << path << std::endl;
+    return true;
+}
+
+void TraceWriter::append(const ExecutionRecord& record) {
+    if (!map_) {
+        return;
+    }
+    if (write_offset_ + sizeof(TraceRecord) > mapped_size_ &&
+        !grow(mapped_size_ + TRACE_GROW_BYTES)) {
+        return;
+    }
+    
+    TraceRecord out{};
+    out.sequence = record_count_;
+    out.handle = record.handle;
+    out.state = static_cast<uint8_t>(record.state);
+    out.result = static_cast<uint8_t>(record.result);
+    out.scheduled_time_us = record.scheduled_time_us;
+    out.actual_start_time_us = record.actual_start_time_us;
+    out.end_time_us = record.end_time_us;
+    
+    std::memcpy(map_ + write_offset_, &out, sizeof(out));
+    write_offset_ += sizeof(out);
+    record_count_++;
+    
+    // Publish the record in the header (readable even if the process dies)
+    reinterpret_cast<TraceFileHeader*>(map_)->record_count = record_count_;
+}
+
+void TraceWriter::close() {
+    if (map_) {
+        munmap(map_, mapped_size_);
+        map_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        if (ftruncate(fd_, static_cast<off_t>(write_offset_)) != 0) {
+            std::cerr << "[Trace] Warning: failed to trim trace file: "
+                      << strerror(errno) << std::endl;
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+    mapped_size_ = 0;
+    write_offset_ = 0;
+}
+
+bool TraceWriter::grow(size_t min_size) {
+    if (ftruncate(fd_, static_cast<off_t>(min_size)) != 0) {
+        std::cerr << "[Trace] Failed to extend trace file: " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    void* map = map_
+        ? mremap(map_, mapped_size_, min_size, MREMAP_MAYMOVE)
+        : mmap(nullptr, min_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "[Trace] Failed to map trace file: " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    map_ = static_cast<uint8_t*>(map);
+    mapped_size_ = min_size;
+    return true;
+}
+
+// ============================================================================
+// TraceReader Implementation
+// ============================================================================
+
+bool TraceReader::open(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "[Trace] Failed to open trace file " << path << std::endl;
+        return false;
+    }
+    
+    if (!in.read(reinterpret_cast<char*>(&header_), sizeof(header_)) ||
+        std::memcmp(header_.magic, TRACE_MAGIC, sizeof(header_.magic)) != 0) {
+        std::cerr << "[Trace] Not a trace file: " << path << std::endl;
+        return false;
+    }
+    if (header_.version != TRACE_VERSION || header_.record_size != sizeof(TraceRecord)) {
+        std::cerr << "[Trace] Unsupported trace version " << header_.version
+                  << " (record size " << header_.record_size << ")" << std::endl;
+        return false;
+    }
+    
+    std::string id_table(header_.id_table_size, '\0');
+    if (!in.read(&id_table[0], static_cast<std::streamsize>(id_table.size()))) {
+        std::cerr << "[Trace] Truncated task id table" << std::endl;
+        return false;
+    }
+    task_ids_.clear();
+    size_t pos = 0;
+    for (uint32_t i = 0; i < header_.task_count && pos < id_table.size(); i++) {
+        size_t end = id_table.find('\0', pos);
+        task_ids_.push_back(id_table.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    
+    in.seekg(static_cast<std::streamoff>(header_.data_offset));
+    records_.resize(header_.record_count);
+    in.read(reinterpret_cast<char*>(records_.data()),
+            static_cast<std::streamsize>(records_.size() * sizeof(TraceRecord)));
+    records_.resize(static_cast<size_t>(in.gcount()) / sizeof(TraceRecord));
+    
+    return true;
+}
+
+const std::string& TraceReader::task_id(uint32_t handle) const {
+    static const std::string unknown = "?";
+    return handle < task_ids_.size() ? task_ids_[handle] : unknown;
+}
+
+} // namespace orchestrator
@@ -0,0 +1,280 @@
+// Unit tests of the pure-logic pieces and the zero-allocation hot path.
+// Built with its own copy of the allocation counter (see CMakeLists.txt),
+// so the hot path is checked whether or not the library counts allocations.
+
+#include "alloc_counter.h"
+#include "critical_path.h"
+#include "duration_store.h"
+#include "release_queue.h"
+#include "result_cache.h"
+#include "rt_utils.h"
+#include "task_table.h"
+#include "task_wrapper.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace orchestrator;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(condition)                                                                      \
+    do {                                                                                      \
+        if (!(condition)) {                                                                   \
+            std::cerr << "[Test] " << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition    \
+                      << ") failed" << std::endl;                                             \
+            g_failures++;                                                                     \
+        }                                                                                     \
+    } while (0)
+
+ReleasedTask released(size_t task_index, int32_t priority, int64_t deadline_us, int64_t bottom_level_us) {
+    ReleasedTask task = {};
+    task.task_index = task_index;
+    task.priority = priority;
+    task.absolute_deadline_us = deadline_us;
+    task.bottom_level_us = bottom_level_us;
+    return task;
+}
+
+std::vector<size_t> drain(ReleaseQueue& queue) {
+    std::vector<size_t> order;
+    while (!queue.empty()) {
+        order.push_back(queue.pop().task_index);
+    }
+    return order;
+}
+
+void test_release_queue() {
+    ReleaseQueue queue(DISPATCH_ORDER_FIFO);
+    queue.push(released(0, 1, 300, 0));
+    queue.push(released(1, 9, 100, 0));
+    queue.push(released(2, 5, 200, 0));
+    CHECK((drain(queue) == std::vector<size_t>{0, 1, 2}));
+
+    // Highest priority first; ties to the larger bottom level, then release order
+    queue.set_order(DISPATCH_ORDER_PRIORITY);
+    queue.push(released(0, 1, 0, 0));
+    queue.push(released(1, 5, 0, 10));
+    queue.push(released(2, 5, 0, 50));
+    queue.push(released(3, 5, 0, 50));
+    queue.push(released(4, 9, 0, 0));
+    CHECK((drain(queue) == std::vector<size_t>{4, 2, 3, 1, 0}));
+
+    // Earliest deadline first, same tie-breaks
+    queue.set_order(DISPATCH_ORDER_EDF);
+    queue.push(released(0, 0, 300, 0));
+    queue.push(released(1, 0, 100, 0));
+    queue.push(released(2, 0, 200, 5));
+    queue.push(released(3, 0, 200, 7));
+    CHECK((drain(queue) == std::vector<size_t>{1, 3, 2, 0}));
+
+    CHECK(ReleaseQueue::string_to_order("edf") == DISPATCH_ORDER_EDF);
+    CHECK(ReleaseQueue::order_to_string(DISPATCH_ORDER_FIFO) == "fifo");
+}
+
+void test_critical_path() {
+    // a -> b -> c, and a -> d (d depends on a)
+    TaskTable tasks;
+    TaskHandle a = tasks.intern("a");
+    TaskHandle b = tasks.intern("b");
+    TaskHandle c = tasks.intern("c");
+    TaskHandle d = tasks.intern("d");
+    tasks.add_dependency(b, a);
+    tasks.add_dependency(c, b);
+    tasks.add_dependency(d, a);
+
+    CriticalPath path;
+    path.build(tasks, {10, 20, 30, 40});
+    CHECK(path.bottom_level(c) == 30);
+    CHECK(path.bottom_level(b) == 50);
+    CHECK(path.bottom_level(d) == 40);
+    CHECK(path.bottom_level(a) == 60);
+    CHECK(path.length_us() == 60);
+    CHECK((path.path() == std::vector<TaskHandle>{a, b, c}));
+
+    // A measured duration propagates to the dependencies only
+    path.update_duration(d, 100);
+    CHECK(path.bottom_level(d) == 100);
+    CHECK(path.bottom_level(a) == 110);
+    CHECK(path.bottom_level(b) == 50);
+    CHECK((path.path() == std::vector<TaskHandle>{a, d}));
+
+    path.update_duration(c, 5);
+    CHECK(path.bottom_level(b) == 25);
+    CHECK(path.bottom_level(a) == 110);
+}
+
+bool cpus_are(const std::string& list, const std::vector<int>& expected) {
+    cpu_set_t cpus;
+    if (!RTUtils::parse_cpu_list(list, cpus) || CPU_COUNT(&cpus) != static_cast<int>(expected.size())) {
+        return false;
+    }
+    for (int cpu : expected) {
+        if (!CPU_ISSET(cpu, &cpus)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_parse_cpu_list() {
+    CHECK(cpus_are("3", {3}));
+    CHECK(cpus_are("2-5,8", {2, 3, 4, 5, 8}));
+    CHECK(cpus_are("0,0-1", {0, 1}));
+
+    cpu_set_t cpus;
+    for (const char* invalid : {"", "5-2", "-1", "a", "1,,2", "2-", "1-x", "99999"}) {
+        if (RTUtils::parse_cpu_list(invalid, cpus)) {
+            std::cerr << "[Test] parse_cpu_list accepted '" << invalid << "'" << std::endl;
+            g_failures++;
+        }
+    }
+}
+
+void test_duration_stats() {
+    TaskDurationStats stats;
+    CHECK(stats.percentile(50) == 0);
+
+    stats.add(800);
+    CHECK(stats.ewma_us == 800);
+    stats.add(1600);
+    CHECK(stats.ewma_us == 800 + (1600 - 800) / 8);
+    CHECK(stats.min_us == 800);
+    CHECK(stats.wcet_us == 1600);
+    stats.add(-5);   // Clamped to 0
+    CHECK(stats.min_us == 0);
+
+    // The ring keeps the last RECENT_SAMPLES samples, oldest first
+    TaskDurationStats ring;
+    size_t total = TaskDurationStats::RECENT_SAMPLES + 10;
+    for (size_t i = 1; i <= total; i++) {
+        ring.add(static_cast<int64_t>(i));
+    }
+    std::vector<int64_t> samples = ring.samples();
+    CHECK(ring.executions == total);
+    CHECK(ring.recent_us.size() == TaskDurationStats::RECENT_SAMPLES);
+    CHECK(samples.size() == TaskDurationStats::RECENT_SAMPLES);
+    CHECK(samples.front() == 11);
+    CHECK(samples.back() == static_cast<int64_t>(total));
+    CHECK(ring.wcet_us == static_cast<int64_t>(total));
+    CHECK(ring.min_us == 1);
+    CHECK(ring.percentile(0) == 11);
+    CHECK(ring.percentile(100) == static_cast<int64_t>(total));
+
+    // No allocation once the ring is full
+    ScopedAllocCounter allocations;
+    ring.add(5);
+    CHECK(allocations.count() == 0);
+}
+
+void test_result_cache() {
+    std::map<std::string, std::string> parameters = {{"n", "1"}, {"mode", "fast"}};
+    std::vector<std::pair<std::string, uint64_t>> inputs = {{"a", 1}, {"b", 2}};
+    uint64_t key = ResultCache::key("task", parameters, inputs);
+    CHECK(key == ResultCache::key("task", parameters, inputs));
+    CHECK(key != ResultCache::key("other", parameters, inputs));
+    CHECK(key != ResultCache::key("task", {{"n", "2"}, {"mode", "fast"}}, inputs));
+    CHECK(key != ResultCache::key("task", parameters, {{"a", 1}, {"b", 3}}));
+    CHECK(key != ResultCache::key("task", parameters, {{"b", 2}, {"a", 1}}));
+    // Field boundaries are part of the key
+    CHECK(ResultCache::key("ab", {}, {}) != ResultCache::key("a", {{"b", ""}}, {}));
+
+    // The digest does not depend on the order of the outputs
+    google::protobuf::RepeatedPtrField<TaskOutput> outputs;
+    TaskOutput* x = outputs.Add();
+    x->set_name("x");
+    x->set_data("1");
+    TaskOutput* y = outputs.Add();
+    y->set_name("y");
+    y->set_data("2");
+    google::protobuf::RepeatedPtrField<TaskOutput> reversed;
+    *reversed.Add() = *y;
+    *reversed.Add() = *x;
+    CHECK(ResultCache::digest(outputs) == ResultCache::digest(reversed));
+
+    reversed.Mutable(0)->set_data("3");
+    CHECK(ResultCache::digest(outputs) != ResultCache::digest(reversed));
+}
+
+bool wait_for(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void test_hot_path_allocations() {
+    CHECK(AllocCounter::enabled());
+    {
+        ScopedAllocCounter allocations;
+        std::string* value = new std::string(64, 'x');
+        CHECK(allocations.count() > 0);
+        delete value;
+    }
+
+    // No orchestrator listens: the end notification fails after the
+    // counted part of the hot path
+    std::string socket = "unix:/tmp/orchestrator_tests_" + std::to_string(getpid()) + ".sock";
+    std::string nowhere = "unix:/tmp/orchestrator_tests_" + std::to_string(getpid()) + "_none.sock";
+    std::atomic<int> executions{0};
+    TaskWrapper wrapper("alloc_test", socket, nowhere, [&executions](const TaskParameterView& params) {
+        executions += params.get("iterations") == "1000" ? 1 : 100;
+        return TASK_RESULT_SUCCESS;
+    });
+    wrapper.set_zero_allocation_mode(true);
+    wrapper.start();
+
+    StartTaskRequest request;
+    request.set_task_id("alloc_test");
+    request.set_cpu_affinity(-1);
+    (*request.mutable_parameters())["iterations"] = "1000";
+    (*request.mutable_parameters())["mode"] = "a value longer than the small string buffer";
+    const StartTaskRequest* requests[1] = {&request};
+
+    // The first execution warms the reusable buffers up
+    const int runs = 4;
+    for (int i = 0; i < runs; i++) {
+        request.set_dispatch_time_us(i);
+        CHECK(wait_for([&]() { return wrapper.accept_tasks(requests, 1) == nullptr; }));
+        CHECK(wait_for([&]() { return executions.load() >= i + 1; }));
+    }
+    CHECK(wait_for([&]() { return wrapper.get_state() == TASK_STATE_IDLE; }));
+    wrapper.stop();
+
+    CHECK(executions.load() == runs);
+    if (wrapper.get_hot_path_allocations() != 0) {
+        std::cerr << "[Test] " << wrapper.get_hot_path_allocations()
+                  << " heap allocations on the hot path after warmup" << std::endl;
+        g_failures++;
+    }
+}
+
+} // namespace
+
+int main() {
+    test_release_queue();
+    test_critical_path();
+    test_parse_cpu_list();
+    test_duration_stats();
+    test_result_cache();
+    test_hot_path_allocations();
+
+    if (g_failures > 0) {
+        std::cerr << "[Test] " << g_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "[Test] All checks passed" << std::endl;
+    return 0;
+}